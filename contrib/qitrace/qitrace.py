@@ -0,0 +1,146 @@
+#!/usr/bin/env python
+# Copyright (c) 2017 Microsoft Corporation
+#
+# Summarize a quantifier instantiation trace written by Z3 with
+#
+#    z3 smt.qi.trace_file=trace.jsonl problem.smt2
+#
+# The summary lists the quantifiers with the most instances, how many
+# of their instances were used in conflicts, and the quantifiers that
+# are likely part of a matching loop. The used column is a lower bound,
+# instances that are only used by lemma minimization, or to simplify
+# clauses at the base level, are not counted.
+#
+# A matching loop shows up as instances of the same quantifiers at
+# increasing generations: each instance produces terms that match
+# the pattern again. A quantifier is reported if it has instances in
+# at least --depth consecutive generations, ending at its deepest
+# generation. Quantifiers that form the loop together are reported
+# with the loop if they have instances in the same deep generations.
+#
+# Author: agent (agent@local) 2026-10-16
+
+from __future__ import print_function
+import argparse
+import json
+import sys
+
+class Quantifier:
+    def __init__(self, qid):
+        self.qid = qid
+        self.instances = 0
+        self.used = 0
+        self.max_cost = 0.0
+        self.generations = {}   # generation -> number of instances
+        self.patterns = {}      # pattern -> number of instances
+
+    def chain(self):
+        """Number of consecutive generations with instances, ending at the deepest one."""
+        if not self.generations:
+            return 0
+        g = max(self.generations)
+        n = 0
+        while g in self.generations:
+            n += 1
+            g -= 1
+        return n
+
+def read_trace(file_name):
+    """Return the quantifiers of the trace by qid, and the number of instances.
+    Each context writes a section that starts with a context record, ids are
+    local to the section."""
+    quantifiers = {}
+    num_instances = 0
+    with open(file_name) as f:
+        for line_no, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                r = json.loads(line)
+            except ValueError:
+                # the trace of an interrupted run can end with a partial line.
+                print("%s:%d: skipping malformed record" % (file_name, line_no), file=sys.stderr)
+                continue
+            kind = r["type"]
+            if kind == "context":
+                id2q = {}
+                patterns = {}
+                instance2q = {}
+            elif kind == "quantifier":
+                qid = r["qid"]
+                if qid not in quantifiers:
+                    quantifiers[qid] = Quantifier(qid)
+                id2q[r["id"]] = quantifiers[qid]
+            elif kind == "pattern":
+                patterns[r["id"]] = r["pattern"]
+            elif kind == "instance":
+                q = id2q[r["quantifier"]]
+                q.instances += 1
+                if r["cost"] is not None:
+                    q.max_cost = max(q.max_cost, r["cost"])
+                g = r["generation"]
+                q.generations[g] = q.generations.get(g, 0) + 1
+                p = r["pattern"]
+                p = "<no pattern>" if p is None else patterns[p]
+                q.patterns[p] = q.patterns.get(p, 0) + 1
+                instance2q[r["id"]] = q
+                num_instances += 1
+            elif kind == "used":
+                instance2q[r["id"]].used += 1
+    return quantifiers, num_instances
+
+def main_pattern(q):
+    p, n = max(q.patterns.items(), key=lambda x: x[1])
+    return p, n
+
+def display_top(quantifiers, num_instances, top):
+    qs = sorted(quantifiers.values(), key=lambda q: -q.instances)[:top]
+    print("%d instances of %d quantifiers" % (num_instances, len(quantifiers)))
+    print("%-40s %10s %8s %8s %8s" % ("quantifier", "instances", "used", "max-gen", "max-cost"))
+    for q in qs:
+        if q.instances == 0:
+            continue
+        print("%-40s %10d %8d %8d %8g" % (q.qid, q.instances, q.used, max(q.generations), q.max_cost))
+        p, n = main_pattern(q)
+        print("    %d instances from %s" % (n, p))
+
+def display_loops(quantifiers, depth):
+    suspects = [q for q in quantifiers.values() if q.chain() >= depth]
+    if not suspects:
+        print("no matching loops of depth %d" % depth)
+        return
+    # group quantifiers that have instances in the same deep generations.
+    suspects.sort(key=lambda q: -max(q.generations))
+    loops = []
+    for q in suspects:
+        deep = set(g for g in q.generations if g > max(q.generations) - depth)
+        for loop in loops:
+            if loop[1] & deep:
+                loop[0].append(q)
+                loop[1].update(deep)
+                break
+        else:
+            loops.append(([q], deep))
+    for qs, gens in loops:
+        num = sum(q.instances for q in qs)
+        used = sum(q.used for q in qs)
+        print("possible matching loop up to generation %d, %d instances, %d used:" % (max(gens), num, used))
+        for q in qs:
+            p, n = main_pattern(q)
+            print("    %-40s %10d instances in %d consecutive generations, pattern %s" % (q.qid, q.instances, q.chain(), p))
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarize a quantifier instantiation trace (smt.qi.trace_file).")
+    parser.add_argument("trace", help="trace file")
+    parser.add_argument("--top", type=int, default=20, help="number of quantifiers to list (default 20)")
+    parser.add_argument("--depth", type=int, default=10, help="minimal number of consecutive generations of a matching loop (default 10)")
+    args = parser.parse_args()
+    quantifiers, num_instances = read_trace(args.trace)
+    display_top(quantifiers, num_instances, args.top)
+    print("")
+    display_loops(quantifiers, args.depth)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
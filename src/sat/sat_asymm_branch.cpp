@@ -73,9 +73,29 @@ namespace sat {
         std::stable_sort(s.m_clauses.begin(), s.m_clauses.end(), clause_size_lt());
         m_counter -= s.m_clauses.size();
         SASSERT(s.m_qhead == s.m_trail.size());
-        clause_vector::iterator it  = s.m_clauses.begin();
+        try {
+            process(s.m_clauses, limit, false);
+            if (m_asymm_branch_learned)
+                process(s.m_learned, limit, true);
+        }
+        catch (solver_exception & ex) {
+            m_counter = -m_counter;
+            throw ex;
+        }
+        m_counter = -m_counter;
+        s.m_phase = saved_phase;
+        CASSERT("asymm_branch", s.check_invariant());
+    }
+
+    /**
+       \brief apply asymmetric branching to the clauses in cs.
+       Learned clauses are only processed if they are in the core
+       or tier2 tiers (glue <= gc.tier2_lbd).
+    */
+    void asymm_branch::process(clause_vector & cs, int limit, bool learned) {
+        clause_vector::iterator it  = cs.begin();
         clause_vector::iterator it2 = it;
-        clause_vector::iterator end = s.m_clauses.end();
+        clause_vector::iterator end = cs.end();
         try {
             for (; it != end; ++it) {
                 if (s.inconsistent()) {
@@ -85,33 +105,33 @@ namespace sat {
                     break;
                 }
                 SASSERT(s.m_qhead == s.m_trail.size());
-                if (m_counter < limit || s.inconsistent()) {
+                clause & c = *(*it);
+                if (m_counter < limit || (learned && (c.frozen() || c.glue() > s.m_config.m_gc_tier2_lbd))) {
                     *it2 = *it;
                     ++it2;
                     continue;
                 }
                 s.checkpoint();
-                clause & c = *(*it);
                 m_counter -= c.size();
-                if (!process(c))
+                unsigned sz = c.size();
+                if (!process(c)) {
+                    if (learned) m_elim_learned_literals += sz;
                     continue; // clause was removed
+                }
+                if (learned) m_elim_learned_literals += sz - c.size();
                 *it2 = *it;
                 ++it2;
             }
-            s.m_clauses.set_end(it2);
+            cs.set_end(it2);
         }
         catch (solver_exception & ex) {
-            // put m_clauses in a consistent state...
+            // put cs in a consistent state...
             for (; it != end; ++it, ++it2) {
                 *it2 = *it;
             }
-            s.m_clauses.set_end(it2);
-            m_counter = -m_counter;
+            cs.set_end(it2);
             throw ex;
         }
-        m_counter = -m_counter;
-        s.m_phase = saved_phase;
-        CASSERT("asymm_branch", s.check_invariant());
     }
 
     bool asymm_branch::process(clause & c) {
@@ -135,11 +155,24 @@ namespace sat {
         }
         // try asymmetric branching
         // clause must not be used for propagation
+        // (vivification) the literals of c are moved to c[0..new_sz) while their negations are asserted.
+        // - a literal that is already false is implied false by the previous ones, and is dropped.
+        // - a literal that is already true is implied by the negation of the previous ones,
+        //   and the remaining literals are dropped.
+        // - a conflict means that the literals asserted so far form a clause.
         solver::scoped_detach scoped_d(s, c);
         s.push();
-        for (i = 0; i < sz - 1; i++) {
+        unsigned new_sz = 0;
+        for (i = 0; i < sz; i++) {
             literal l = c[i];
             SASSERT(!s.inconsistent());
+            lbool val = s.value(l);
+            if (val == l_false)
+                continue;
+            std::swap(c[new_sz], c[i]);
+            new_sz++;
+            if (val == l_true || i == sz - 1)
+                break;
             TRACE("asymm_branch_detail", tout << "assigning: " << ~l << "\n";);
             s.assign(~l, justification());
             s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
@@ -151,12 +184,11 @@ namespace sat {
         SASSERT(s.scope_lvl() == 0);
         SASSERT(trail_sz == s.m_trail.size());
         SASSERT(s.m_qhead == s.m_trail.size());
-        if (i == sz - 1) {
+        if (new_sz == sz) {
             // clause size can't be reduced.
             return true;
         }
         // clause can be reduced 
-        unsigned new_sz = i+1;
         SASSERT(new_sz >= 1);
         SASSERT(new_sz < sz);
         TRACE("asymm_branch", tout << c << "\nnew_size: " << new_sz << "\n";
@@ -167,7 +199,8 @@ namespace sat {
             literal l = c[i];
             switch (s.value(l)) {
             case l_undef:
-                c[j] = l;
+                // swap, so that the literals of c are preserved for del_clause.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             case l_false:
@@ -192,11 +225,16 @@ namespace sat {
             return false; // check_missed_propagation() may fail, since m_clauses is not in a consistent state.
         case 2:
             SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
-            s.mk_bin_clause(c[0], c[1], false);
+            if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
+            s.mk_bin_clause(c[0], c[1], c.is_learned());
             scoped_d.del_clause();
             SASSERT(s.m_qhead == s.m_trail.size());
             return false;
         default:
+            if (s.m_config.m_drat) {
+                s.m_drat.add(new_sz, c.begin());
+                s.m_drat.del(c);
+            }
             c.shrink(new_sz);
             SASSERT(s.m_qhead == s.m_trail.size());
             return true;
@@ -208,6 +246,7 @@ namespace sat {
         m_asymm_branch        = p.asymm_branch();
         m_asymm_branch_rounds = p.asymm_branch_rounds();
         m_asymm_branch_limit  = p.asymm_branch_limit();
+        m_asymm_branch_learned = p.asymm_branch_learned();
         if (m_asymm_branch_limit > INT_MAX)
             m_asymm_branch_limit = INT_MAX;
     }
@@ -218,10 +257,12 @@ namespace sat {
     
     void asymm_branch::collect_statistics(statistics & st) const {
         st.update("elim literals", m_elim_literals);
+        st.update("elim learned literals", m_elim_learned_literals);
     }
 
     void asymm_branch::reset_statistics() {
         m_elim_literals = 0;
+        m_elim_learned_literals = 0;
     }
 
 };
@@ -36,10 +36,13 @@ namespace sat {
         bool                   m_asymm_branch;
         unsigned               m_asymm_branch_rounds;
         unsigned               m_asymm_branch_limit;
+        bool                   m_asymm_branch_learned;
 
         // stats
         unsigned m_elim_literals;
+        unsigned m_elim_learned_literals;
 
+        void process(clause_vector & cs, int limit, bool learned);
         bool process(clause & c);
     public:
         asymm_branch(solver & s, params_ref const & p);
@@ -27,11 +27,13 @@ namespace sat {
         m_id(id),
         m_size(sz),
         m_capacity(sz),
+        m_offset(0),
         m_removed(false),
         m_learned(learned),
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_moved(false),
         m_inact_rounds(0) {
         memcpy(m_lits, lits, sizeof(literal) * sz);
         mark_strengthened();
@@ -122,82 +124,55 @@ namespace sat {
     }
 
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
-#if defined(_AMD64_)
-        m_num_segments = 0;
-#endif
+        m_num_words(0),
+        m_wasted(0) {
     }
 
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-#if defined(_AMD64_)
-#if defined (Z3DEBUG)
-        clause const* result;
-        if (((cls_off & c_alignment_mask) == c_last_segment)) {
-            unsigned id = cls_off >> c_cls_alignment;
-            bool check = m_last_seg_id2cls.find(id, result);
-            SASSERT(check);
-            return const_cast<clause*>(result);
+    clause_allocator::~clause_allocator() {
+        del_pages(m_pages);
+        del_pages(m_old_pages);
+    }
+
+    void clause_allocator::del_pages(svector<page> & pages) {
+        for (unsigned i = 0; i < pages.size(); ++i) {
+            memory::deallocate(pages[i].m_data);
         }
-#endif
-        return reinterpret_cast<clause *>(m_segments[cls_off & c_alignment_mask] + (static_cast<size_t>(cls_off) & ~c_alignment_mask));
-#else
-        return reinterpret_cast<clause *>(cls_off);
-#endif
+        pages.reset();
     }
 
-#if defined(_AMD64_)
-    unsigned clause_allocator::get_segment(clause const* cls) {
-        size_t ptr = reinterpret_cast<size_t>(cls);
-
-        SASSERT((ptr & c_alignment_mask) == 0);
-        ptr &= 0xFFFFFFFF00000000ull; // Keep only high part
-        unsigned i = 0;
-        for (i = 0; i < m_num_segments; ++i)
-            if (m_segments[i] == ptr)
-                return i;
-        i = m_num_segments;
-        SASSERT(i <= c_last_segment);
-#if defined(Z3DEBUG)
-        if (i == c_last_segment) {
-            if (!m_last_seg_id2cls.contains(cls->id()))
-                m_last_seg_id2cls.insert(cls->id(), cls);
+    void clause_allocator::add_page(unsigned capacity) {
+        SASSERT(capacity <= c_max_page_words);
+        if (m_pages.size() == c_max_pages) {
+            throw default_exception("clause arena out of range");
         }
-        else {
-            ++m_num_segments;
-            m_segments[i] = ptr;
+        page p;
+        p.m_data     = static_cast<uint64 *>(memory::allocate(sizeof(uint64) * capacity));
+        p.m_capacity = capacity;
+        p.m_size     = 0;
+        m_pages.push_back(p);
+    }
+
+    clause_offset clause_allocator::allocate(unsigned n) {
+        if (n > c_max_page_words) {
+            throw default_exception("clause is too large");
         }
-#else
-        if (i == c_last_segment) {
-            throw default_exception("segment out of range");
+        if (m_pages.empty()) {
+            add_page(std::max(n, c_init_page_words));
         }
-        m_segments[i] = ptr;
-        ++m_num_segments;
-#endif
-
-        return i;
-    }
-#endif
-
-    clause_offset clause_allocator::get_offset(clause const * cls) const {
-#if defined(_AMD64_)
-        unsigned segment = const_cast<clause_allocator*>(this)->get_segment(cls);
-#if defined(Z3DEBUG)
-        SASSERT(segment <= c_last_segment);
-        if (segment == c_last_segment) {
-            SASSERT(m_last_seg_id2cls.contains(cls->id()));
-            return (cls->id() << c_cls_alignment) | c_last_segment;
+        else if (m_pages.back().m_size + n > m_pages.back().m_capacity) {
+            add_page(std::max(n, std::min(2 * m_pages.back().m_capacity, c_max_page_words)));
         }
-#endif
-        return static_cast<unsigned>(reinterpret_cast<size_t>(cls)) + segment;
-#else
-        return reinterpret_cast<size_t>(cls);
-#endif
+        page & p = m_pages.back();
+        clause_offset result = ((m_pages.size() - 1) << c_word_bits) | p.m_size;
+        p.m_size    += n;
+        m_num_words += n;
+        return result;
     }
 
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
-        size_t size = clause::get_obj_size(num_lits);
-        void * mem = m_allocator.allocate(size);
-        clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
+        clause_offset cls_off = allocate(clause_words(num_lits));
+        clause * cls = new (get_clause(cls_off)) clause(m_id_gen.mk(), num_lits, lits, learned);
+        cls->m_offset = cls_off;
         TRACE("sat", tout << "alloc: " << cls->id() << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
         return cls;
@@ -205,15 +180,49 @@ namespace sat {
 
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat", tout << "delete: " << cls->id() << " " << *cls << "\n";);
+        SASSERT(!cls->m_moved);
         m_id_gen.recycle(cls->id());
-#if defined(_AMD64_)
-#if defined(Z3DEBUG)
-        m_last_seg_id2cls.remove(cls->id());
-#endif
-#endif
-        size_t size = clause::get_obj_size(cls->m_capacity);
+        // the memory of cls is reclaimed by the next compaction.
+        m_wasted += clause_words(cls->m_capacity);
         cls->~clause();
-        m_allocator.deallocate(size, cls);
+    }
+
+    void clause_allocator::begin_compaction() {
+        SASSERT(m_old_pages.empty());
+        m_pages.swap(m_old_pages);
+        size_t live = m_num_words - m_wasted;
+        m_num_words = 0;
+        m_wasted    = 0;
+        // live clauses fit in a single page unless they exceed the page size.
+        add_page(static_cast<unsigned>(std::max(static_cast<size_t>(c_init_page_words), std::min(live, static_cast<size_t>(c_max_page_words)))));
+    }
+
+    clause * clause_allocator::move_clause(clause * cls) {
+        if (cls->m_moved) {
+            return get_clause(cls->m_offset);
+        }
+        // literals removed by shrinking are not copied.
+        clause_offset cls_off = allocate(clause_words(cls->m_size));
+        clause * r = get_clause(cls_off);
+        memcpy(static_cast<void *>(r), cls, clause::get_obj_size(cls->m_size));
+        r->m_capacity = r->m_size;
+        r->m_offset   = cls_off;
+        cls->m_moved  = true;
+        cls->m_offset = cls_off;
+        return r;
+    }
+
+    bool clause_allocator::relocate(clause_offset & cls_off) const {
+        clause const * cls = get_old_clause(cls_off);
+        if (!cls->m_moved) {
+            return false;
+        }
+        cls_off = cls->m_offset;
+        return true;
+    }
+
+    void clause_allocator::end_compaction() {
+        del_pages(m_old_pages);
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
@@ -20,7 +20,6 @@ Revision History:
 #define SAT_CLAUSE_H_
 
 #include "sat/sat_types.h"
-#include "util/small_object_allocator.h"
 #include "util/id_gen.h"
 #include "util/map.h"
 
@@ -39,6 +38,7 @@ namespace sat {
         unsigned           m_id;
         unsigned           m_size;
         unsigned           m_capacity;
+        clause_offset      m_offset;  // offset in the clause arena, or forwarding offset when m_moved
         var_approx_set     m_approx;
         unsigned           m_strengthened:1;
         unsigned           m_removed:1;
@@ -46,6 +46,7 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_moved:1;   // clause was copied to m_offset during compaction
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
@@ -73,6 +74,8 @@ namespace sat {
         bool check_approx() const; // for debugging
         literal * begin() { return m_lits; }
         literal * end() { return m_lits + m_size; }
+        literal const * begin() const { return m_lits; }
+        literal const * end() const { return m_lits + m_size; }
         bool contains(literal l) const;
         bool contains(bool_var v) const;
         bool satisfied_by(model const & m) const;
@@ -124,28 +127,85 @@ namespace sat {
     };
 
     /**
-       \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       \brief Arena clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+
+       Clauses are allocated consecutively in pages of 8 byte words. Pages
+       never move, so clause pointers are stable between compactions.
+       A clause offset contains the page index in its high bits and the
+       word index in the page in its low bits.
+
+       Deleted clauses are not reused; their memory is reclaimed by
+       compaction: begin_compaction() retires the current pages,
+       move_clause() copies live clauses into a fresh arena, leaving a
+       forwarding offset in the retired copy, so that watches and
+       justifications can be relocated, and end_compaction() releases
+       the retired pages.
     */
     class clause_allocator {
-        small_object_allocator m_allocator;
+        struct page {
+            uint64 * m_data;
+            unsigned m_capacity;  // in words
+            unsigned m_size;      // in words
+        };
+        static const unsigned  c_word_bits       = 22;
+        static const unsigned  c_word_mask       = (1u << c_word_bits) - 1;
+        static const unsigned  c_max_pages       = 1u << (32 - c_word_bits);
+        static const unsigned  c_max_page_words  = 1u << c_word_bits;
+        static const unsigned  c_init_page_words = 1u << 12;
         id_gen                 m_id_gen;
-#if defined(_AMD64_)
-        unsigned get_segment(clause const* cls);
-        static const unsigned  c_cls_alignment = 3;
-        static const unsigned  c_last_segment  = (1ull << c_cls_alignment) - 1ull;
-        static const size_t    c_alignment_mask = (1ull << c_cls_alignment) - 1ull;
-        unsigned               m_num_segments;
-        size_t                 m_segments[c_last_segment];
-#if defined(Z3DEBUG)
-        u_map<clause const*>   m_last_seg_id2cls;
-#endif
-#endif
+        svector<page>          m_pages;
+        svector<page>          m_old_pages;   // pages retired during compaction.
+        size_t                 m_num_words;   // words allocated in m_pages.
+        size_t                 m_wasted;      // words of deleted clauses in m_pages.
+
+        static unsigned num_words(size_t num_bytes) { return static_cast<unsigned>((num_bytes + sizeof(uint64) - 1) / sizeof(uint64)); }
+        // words occupied in the arena by a clause with room for capacity literals.
+        static unsigned clause_words(unsigned capacity) { return num_words(clause::get_obj_size(capacity)); }
+        static void del_pages(svector<page> & pages);
+        void add_page(unsigned min_words);
+        clause_offset allocate(unsigned num_words);
     public:
         clause_allocator();
-        clause *      get_clause(clause_offset cls_off) const;
-        clause_offset get_offset(clause const * ptr) const;
+        ~clause_allocator();
+        clause *      get_clause(clause_offset cls_off) const {
+            page const & p = m_pages[cls_off >> c_word_bits];
+            SASSERT((cls_off & c_word_mask) < p.m_size);
+            return reinterpret_cast<clause *>(p.m_data + (cls_off & c_word_mask));
+        }
+        // hint the processor to load the header of the clause.
+        void          prefetch(clause_offset cls_off) const {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(get_clause(cls_off));
+#endif
+        }
+        clause_offset get_offset(clause const * ptr) const { SASSERT(!ptr->m_moved); return ptr->m_offset; }
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         void          del_clause(clause * cls);
+
+        size_t        num_words() const { return m_num_words; }
+        size_t        wasted_words() const { return m_wasted; }
+
+        void          begin_compaction();
+        clause *      get_old_clause(clause_offset cls_off) const {
+            page const & p = m_old_pages[cls_off >> c_word_bits];
+            SASSERT((cls_off & c_word_mask) < p.m_size);
+            return reinterpret_cast<clause *>(p.m_data + (cls_off & c_word_mask));
+        }
+        /**
+           \brief copy a live clause of the retired arena into the new arena.
+           Return the new copy. Moving a clause twice returns the same copy.
+        */
+        clause *      move_clause(clause * cls);
+        /**
+           \brief forward an offset into the retired arena.
+           Return false if the clause at cls_off was deleted (or not moved).
+        */
+        bool          relocate(clause_offset & cls_off) const;
+        /**
+           \brief return the new copy of a clause of the retired arena, or 0 if it was not moved.
+        */
+        clause *      relocate(clause const * cls) const { return cls->m_moved ? get_clause(cls->m_offset) : 0; }
+        void          end_compaction();
     };
 
     /**
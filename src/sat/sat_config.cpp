@@ -30,11 +30,20 @@ namespace sat {
         m_random("random"),
         m_geometric("geometric"),
         m_luby("luby"),
+        m_vsids("vsids"),
+        m_vmtf("vmtf"),
+        m_chb("chb"),
+        m_stable("stable"),
+        m_focused("focused"),
+        m_switch("switch"),
+        m_cdcl("cdcl"),
+        m_cube("cube"),
         m_dyn_psm("dyn_psm"),
         m_psm("psm"),
         m_glue("glue"),
         m_glue_psm("glue_psm"),
-        m_psm_glue("psm_glue") {
+        m_psm_glue("psm_glue"),
+        m_tiered("tiered") {
         m_num_parallel = 1;
         updt_params(p); 
     }
@@ -71,6 +80,28 @@ namespace sat {
         m_restart_max     = p.restart_max();
 
         m_random_freq     = p.random_freq();
+
+        s = p.branching_heuristic();
+        if (s == m_vsids)
+            m_branching_heuristic = BH_VSIDS;
+        else if (s == m_vmtf)
+            m_branching_heuristic = BH_VMTF;
+        else if (s == m_chb)
+            m_branching_heuristic = BH_CHB;
+        else
+            throw sat_param_exception("invalid branching heuristic");
+
+        s = p.branching_mode();
+        if (s == m_stable)
+            m_branching_mode = BM_STABLE;
+        else if (s == m_focused)
+            m_branching_mode = BM_FOCUSED;
+        else if (s == m_switch)
+            m_branching_mode = BM_SWITCH;
+        else
+            throw sat_param_exception("invalid branching mode");
+        m_branching_mode_conflicts = std::max(1u, p.branching_mode_conflicts());
+        m_chb_alpha = p.branching_chb_alpha();
         m_random_seed     = p.random_seed();
         if (m_random_seed == 0) 
             m_random_seed = _p.get_uint("random_seed", 0);
@@ -79,11 +110,42 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_parallel    = p.parallel_threads();
+        m_par_share_size  = p.par_share_size();
+        m_par_share_lbd   = p.par_share_lbd();
+        m_par_buffer_size = p.par_buffer_size();
+
+        s = p.mode();
+        if (s == m_cdcl)
+            m_mode = SM_CDCL;
+        else if (s == m_cube)
+            m_mode = SM_CUBE;
+        else
+            throw sat_param_exception("invalid search mode");
+        m_lookahead_cube_depth = p.lookahead_cube_depth();
+        m_lookahead_candidates = std::max(1u, p.lookahead_candidates());
+        m_lookahead_double     = p.lookahead_double();
+
+        m_local_search         = p.local_search();
+        m_local_search_restarts = std::max(1u, p.local_search_restarts());
+        m_local_search_flips   = p.local_search_flips();
+        m_local_search_threads = p.local_search_threads();
+        m_local_search_cb      = p.local_search_cb();
+        if (m_local_search_cb <= 1.0)
+            throw sat_param_exception("local_search.cb must be larger than 1");
+
+        m_drat_file       = p.drat_file();
+        m_drat            = m_drat_file != symbol("");
+        m_drat_binary     = p.drat_binary();
         
         // These parameters are not exposed
         m_simplify_mult1  = _p.get_uint("simplify_mult1", 300);
         m_simplify_mult2  = _p.get_double("simplify_mult2", 1.5);
         m_simplify_max    = _p.get_uint("simplify_max", 500000);
+
+        // parallel and cube workers are copies of the solver that do not
+        // carry the model converter entries of eliminated variables.
+        m_inprocess        = p.inprocess() && m_num_parallel <= 1 && m_mode != SM_CUBE;
+        m_inprocess_effort = p.inprocess_effort();
         // --------------------------------
 
         s = p.gc();
@@ -97,7 +159,9 @@ namespace sat {
                 m_gc_k = 255;
         }
         else {
-            if (s == m_glue_psm)
+            if (s == m_tiered)
+                m_gc_strategy = GC_TIERED;
+            else if (s == m_glue_psm)
                 m_gc_strategy = GC_GLUE_PSM;
             else if (s == m_glue)
                 m_gc_strategy = GC_GLUE;
@@ -110,6 +174,8 @@ namespace sat {
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
         }
+        m_gc_core_lbd     = p.gc_core_lbd();
+        m_gc_tier2_lbd    = std::max(m_gc_core_lbd, p.gc_tier2_lbd());
         m_minimize_lemmas = p.minimize_lemmas();
         m_core_minimize   = p.core_minimize();
         m_core_minimize_partial   = p.core_minimize_partial();
@@ -36,12 +36,30 @@ namespace sat {
         RS_LUBY
     };
 
+    enum branching_heuristic {
+        BH_VSIDS,
+        BH_VMTF,
+        BH_CHB
+    };
+
+    enum branching_mode {
+        BM_STABLE,
+        BM_FOCUSED,
+        BM_SWITCH
+    };
+
+    enum search_mode {
+        SM_CDCL,
+        SM_CUBE
+    };
+
     enum gc_strategy {
         GC_DYN_PSM,
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIERED
     };
 
     struct config {
@@ -54,10 +72,35 @@ namespace sat {
         double             m_restart_factor; // for geometric case
         unsigned           m_restart_max;
         double             m_random_freq;
+        branching_heuristic m_branching_heuristic;
+        branching_mode     m_branching_mode;
+        unsigned           m_branching_mode_conflicts;
+        double             m_chb_alpha;
         unsigned           m_random_seed;
         unsigned           m_burst_search;
         unsigned           m_max_conflicts;
         unsigned           m_num_parallel;
+        unsigned           m_par_share_size;
+        unsigned           m_par_share_lbd;
+        unsigned           m_par_buffer_size;
+
+        search_mode        m_mode;
+        unsigned           m_lookahead_cube_depth;
+        unsigned           m_lookahead_candidates;
+        bool               m_lookahead_double;
+
+        bool               m_local_search;
+        unsigned           m_local_search_restarts;
+        unsigned           m_local_search_flips;
+        unsigned           m_local_search_threads;
+        double             m_local_search_cb;
+
+        bool               m_inprocess;
+        unsigned           m_inprocess_effort;
+
+        bool               m_drat;
+        symbol             m_drat_file;
+        bool               m_drat_binary;
 
         unsigned           m_simplify_mult1;
         double             m_simplify_mult2;
@@ -68,6 +111,8 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_core_lbd;
+        unsigned           m_gc_tier2_lbd;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
@@ -81,12 +126,22 @@ namespace sat {
         symbol             m_random;
         symbol             m_geometric;
         symbol             m_luby;
+        symbol             m_vsids;
+        symbol             m_vmtf;
+        symbol             m_chb;
+        symbol             m_stable;
+        symbol             m_focused;
+        symbol             m_switch;
+
+        symbol             m_cdcl;
+        symbol             m_cube;
         
         symbol             m_dyn_psm;
         symbol             m_psm;        
         symbol             m_glue;        
         symbol             m_glue_psm;        
         symbol             m_psm_glue;        
+        symbol             m_tiered;
         
         config(params_ref const & p);
         void updt_params(params_ref const & p);
@@ -0,0 +1,138 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Produce DRAT proofs.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include "sat/sat_drat.h"
+#include "sat/sat_clause.h"
+#include "util/z3_exception.h"
+
+namespace sat {
+
+    drat::drat():
+        m_out(0),
+        m_binary(false) {
+    }
+
+    drat::~drat() {
+        close();
+    }
+
+    void drat::open(char const * file, bool binary) {
+        close();
+        m_out = alloc(std::ofstream, file, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (m_out->bad() || m_out->fail()) {
+            dealloc(m_out);
+            m_out = 0;
+            throw default_exception(std::string("could not open DRAT proof file ") + file);
+        }
+        m_binary = binary;
+        m_buffer.reserve(c_buffer_size + 64);
+    }
+
+    void drat::close() {
+        if (m_out) {
+            flush();
+            dealloc(m_out);
+            m_out = 0;
+        }
+    }
+
+    void drat::flush() {
+        if (m_out && !m_buffer.empty()) {
+            m_out->write(m_buffer.c_ptr(), m_buffer.size());
+            m_out->flush();
+        }
+        m_buffer.reset();
+    }
+
+    void drat::put_binary(unsigned n) {
+        while (n > 127) {
+            put(static_cast<char>(128 | (n & 127)));
+            n >>= 7;
+        }
+        put(static_cast<char>(n));
+    }
+
+    void drat::put_text(literal l) {
+        char digits[16];
+        unsigned n = l.var() + 1;
+        unsigned i = 0;
+        do {
+            digits[i++] = '0' + (n % 10);
+            n /= 10;
+        }
+        while (n > 0);
+        if (l.sign()) put('-');
+        while (i > 0) put(digits[--i]);
+        put(' ');
+    }
+
+    void drat::dump(char st, unsigned n, literal const * lits) {
+        if (!m_out)
+            return;
+        if (m_binary) {
+            put(st);
+            for (unsigned i = 0; i < n; ++i) {
+                put_binary(2 * (lits[i].var() + 1) + static_cast<unsigned>(lits[i].sign()));
+            }
+            put(0);
+        }
+        else {
+            if (st == 'd') {
+                put('d');
+                put(' ');
+            }
+            for (unsigned i = 0; i < n; ++i) {
+                put_text(lits[i]);
+            }
+            put('0');
+            put('\n');
+        }
+        if (m_buffer.size() >= c_buffer_size) {
+            flush();
+        }
+    }
+
+    void drat::add() {
+        dump('a', 0, 0);
+        // the proof is complete.
+        flush();
+    }
+
+    void drat::add(literal l) {
+        dump('a', 1, &l);
+    }
+
+    void drat::add(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        dump('a', 2, ls);
+    }
+
+    void drat::add(clause const & c) {
+        dump('a', c.size(), c.begin());
+    }
+
+    void drat::del(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        dump('d', 2, ls);
+    }
+
+    void drat::del(clause const & c) {
+        dump('d', c.size(), c.begin());
+    }
+
+};
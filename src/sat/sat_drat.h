@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.h
+
+Abstract:
+
+    Produce DRAT proofs.
+
+    Clauses are added and deleted in the order in which the solver
+    derives and removes them. Both the ASCII format and the binary
+    format of drat-trim are supported:
+
+    - ASCII:  "l1 ... lk 0" for additions and "d l1 ... lk 0" for deletions,
+      where variable v is printed as v+1.
+    - binary: 'a' or 'd' followed by the literals, where literal l is mapped
+      to 2*(l.var()+1) + l.sign() and encoded as a variable length
+      7-bit integer, terminated by 0.
+
+    Output is collected in a buffer that is written to the proof file
+    in large blocks.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#ifndef SAT_DRAT_H_
+#define SAT_DRAT_H_
+
+#include<fstream>
+#include "sat/sat_types.h"
+
+namespace sat {
+
+    class clause;
+
+    class drat {
+        static const unsigned c_buffer_size = 1 << 20;
+        std::ofstream * m_out;
+        bool            m_binary;
+        svector<char>   m_buffer;
+
+        void put(char c) { m_buffer.push_back(c); }
+        void put_binary(unsigned n);
+        void put_text(literal l);
+        void dump(char st, unsigned n, literal const * lits);
+    public:
+        drat();
+        ~drat();
+
+        /**
+           \brief start writing a proof to the given file. Any previous proof is closed.
+        */
+        void open(char const * file, bool binary);
+        void close();
+        bool is_open() const { return m_out != 0; }
+        void flush();
+
+        void add();  // empty clause
+        void add(literal l);
+        void add(literal l1, literal l2);
+        void add(unsigned n, literal const * lits) { dump('a', n, lits); }
+        void add(clause const & c);
+        void del(literal l1, literal l2);
+        void del(unsigned n, literal const * lits) { dump('d', n, lits); }
+        void del(clause const & c);
+    };
+
+};
+
+#endif
@@ -58,9 +58,13 @@ namespace sat {
                         // consume tautology
                         continue;
                     }
+                    // log the rewritten binary clause once.
+                    // The old binary clauses remain in the proof, they justify the equivalences.
+                    if (m_solver.m_config.m_drat && (l1 != r1 || l2 != r2) && l1.index() < l2.index())
+                        m_solver.m_drat.add(r1, r2);
                     if (l1 != r1) {
                         // add half r1 => r2, the other half ~r2 => ~r1 is added when traversing l2 
-                        m_solver.m_watches[(~r1).index()].push_back(watched(r2, it2->is_learned()));
+                        push_binary_watch(m_solver.m_watches[(~r1).index()], watched(r2, it2->is_learned()));
                         continue;
                     }
                     it2->set_literal(r2); // keep it
@@ -73,6 +77,8 @@ namespace sat {
     }
 
     void elim_eqs::cleanup_clauses(literal_vector const & roots, clause_vector & cs) {
+        bool drat = m_solver.m_config.m_drat;
+        literal_vector old_lits;
         clause_vector::iterator it  = cs.begin();
         clause_vector::iterator it2 = it;
         clause_vector::iterator end = cs.end();
@@ -95,6 +101,10 @@ namespace sat {
             }
             if (!c.frozen())
                 m_solver.detach_clause(c);
+            if (drat) {
+                old_lits.reset();
+                old_lits.append(sz, c.begin());
+            }
             // apply substitution
             for (i = 0; i < sz; i++) {
                 SASSERT(!m_solver.was_eliminated(c[i].var()));
@@ -122,7 +132,8 @@ namespace sat {
             }
             if (i < sz) {
                 // clause is a tautology or was simplified
-                m_solver.del_clause(c);
+                if (drat) m_solver.m_drat.del(old_lits.size(), old_lits.c_ptr());
+                m_solver.del_clause(c, false);
                 continue; 
             }
             if (j == 0) {
@@ -135,6 +146,11 @@ namespace sat {
                 cs.set_end(it2);
                 return;
             }
+            if (drat) {
+                // c[0..j) is the clause after the substitution.
+                m_solver.m_drat.add(j, c.begin());
+                m_solver.m_drat.del(old_lits.size(), old_lits.c_ptr());
+            }
             TRACE("elim_eqs", tout << "after removing duplicates: " << c << " j: " << j << "\n";);
             if (j < sz)
                 c.shrink(j);
@@ -150,11 +166,11 @@ namespace sat {
             switch (j) {
             case 1:
                 m_solver.assign(c[0], justification());
-                m_solver.del_clause(c);
+                m_solver.del_clause(c, false);
                 break;
             case 2:
                 m_solver.mk_bin_clause(c[0], c[1], c.is_learned());
-                m_solver.del_clause(c);
+                m_solver.del_clause(c, false);
                 break;
             default:
                 SASSERT(*it == &c);
@@ -179,6 +195,10 @@ namespace sat {
             SASSERT(v != r.var());
             if (m_solver.is_external(v)) {
                 // cannot really eliminate v, since we have to notify extension of future assignments
+                if (m_solver.m_config.m_drat) {
+                    m_solver.m_drat.add(~l, r);
+                    m_solver.m_drat.add(l, ~r);
+                }
                 m_solver.mk_bin_clause(~l, r, false);
                 m_solver.mk_bin_clause(l, ~r, false);
             }
@@ -0,0 +1,287 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.cpp
+
+Abstract:
+
+    Stochastic local search (ProbSAT) over the clauses of a sat::solver.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include <cmath>
+#include "sat/sat_local_search.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    local_search::local_search(reslimit& l, unsigned seed, double cb):
+        m_limit(l),
+        m_rand(seed),
+        m_inconsistent(false),
+        m_num_vars(0),
+        m_best_unsat(UINT_MAX),
+        m_cb(cb) {
+        for (unsigned k = 0; k < 64; ++k) {
+            m_prob_break.push_back(std::pow(m_cb, -static_cast<double>(k)));
+        }
+    }
+
+    void local_search::add_clause(unsigned sz, literal const* lits, svector<char> const& fixed_val) {
+        unsigned old_sz = m_clause_lits.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal l = lits[i];
+            if (m_fixed[l.var()]) {
+                if ((fixed_val[l.var()] != 0) != l.sign()) {
+                    // clause is satisfied by a fixed literal.
+                    m_clause_lits.shrink(old_sz);
+                    return;
+                }
+                continue;
+            }
+            m_clause_lits.push_back(l);
+        }
+        if (m_clause_lits.size() == old_sz) {
+            m_inconsistent = true;
+            return;
+        }
+        m_clause_begin.push_back(m_clause_lits.size());
+    }
+
+    void local_search::import(solver const& s, literal_vector const& fixed) {
+        m_num_vars = s.num_vars();
+        m_clause_begin.reset();
+        m_clause_lits.reset();
+        m_clause_begin.push_back(0);
+        m_inconsistent = false;
+        m_value.reset();
+        m_fixed.reset();
+        m_value.resize(m_num_vars, false);
+        m_fixed.resize(m_num_vars, false);
+
+        svector<char> fixed_val(m_num_vars, false);
+        unsigned sz = s.init_trail_size();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal l = s.m_trail[i];
+            m_fixed[l.var()] = true;
+            fixed_val[l.var()] = !l.sign();
+        }
+        for (unsigned i = 0; i < fixed.size(); ++i) {
+            literal l = fixed[i];
+            if (m_fixed[l.var()] && (fixed_val[l.var()] != 0) == l.sign())
+                m_inconsistent = true;
+            m_fixed[l.var()] = true;
+            fixed_val[l.var()] = !l.sign();
+        }
+
+        for (unsigned l_idx = 0; l_idx < s.m_watches.size(); ++l_idx) {
+            literal l = ~to_literal(l_idx);
+            watch_list const& wlist = s.m_watches[l_idx];
+            watch_list::const_iterator it = wlist.begin(), end = wlist.end();
+            for (; it != end; ++it) {
+                if (!it->is_binary_non_learned_clause())
+                    continue;
+                literal l2 = it->get_literal();
+                if (l.index() < l2.index()) {
+                    literal lits[2] = { l, l2 };
+                    add_clause(2, lits, fixed_val);
+                }
+            }
+        }
+        clause_vector::const_iterator it = s.m_clauses.begin(), end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const& c = *(*it);
+            add_clause(c.size(), c.begin(), fixed_val);
+        }
+
+        // initial assignment follows the saved phases.
+        for (bool_var v = 0; v < m_num_vars; ++v) {
+            if (m_fixed[v])
+                m_value[v] = fixed_val[v];
+            else if (s.m_phase[v] == PHASE_NOT_AVAILABLE)
+                m_value[v] = (m_rand() % 2) == 0;
+            else
+                m_value[v] = s.m_phase[v] == POS_PHASE;
+        }
+        m_best_value = m_value;
+        init_occs();
+    }
+
+    void local_search::init_occs() {
+        unsigned num_lits = 2 * m_num_vars;
+        m_occ_begin.reset();
+        m_occ_begin.resize(num_lits + 1, 0);
+        for (unsigned i = 0; i < m_clause_lits.size(); ++i) {
+            m_occ_begin[m_clause_lits[i].index() + 1]++;
+        }
+        for (unsigned i = 0; i < num_lits; ++i) {
+            m_occ_begin[i + 1] += m_occ_begin[i];
+        }
+        m_occs.reset();
+        m_occs.resize(m_clause_lits.size(), 0);
+        unsigned_vector pos;
+        for (unsigned i = 0; i < num_lits; ++i) {
+            pos.push_back(m_occ_begin[i]);
+        }
+        for (unsigned c = 0; c < num_clauses(); ++c) {
+            for (literal const* l = begin_clause(c); l != end_clause(c); ++l) {
+                m_occs[pos[l->index()]++] = c;
+            }
+        }
+    }
+
+    void local_search::init_state() {
+        unsigned n = num_clauses();
+        m_num_true.reset();
+        m_true_xor.reset();
+        m_unsat.reset();
+        m_unsat_pos.reset();
+        m_break.reset();
+        m_num_true.resize(n, 0);
+        m_true_xor.resize(n, 0);
+        m_unsat_pos.resize(n, UINT_MAX);
+        m_break.resize(m_num_vars, 0);
+        for (unsigned c = 0; c < n; ++c) {
+            for (literal const* l = begin_clause(c); l != end_clause(c); ++l) {
+                if (is_true(*l)) {
+                    m_num_true[c]++;
+                    m_true_xor[c] ^= l->var();
+                }
+            }
+            if (m_num_true[c] == 0)
+                add_unsat(c);
+            else if (m_num_true[c] == 1)
+                m_break[m_true_xor[c]]++;
+        }
+        m_best_unsat = m_unsat.size();
+        m_best_value = m_value;
+    }
+
+    void local_search::add_unsat(unsigned c) {
+        SASSERT(m_unsat_pos[c] == UINT_MAX);
+        m_unsat_pos[c] = m_unsat.size();
+        m_unsat.push_back(c);
+    }
+
+    void local_search::remove_unsat(unsigned c) {
+        unsigned pos = m_unsat_pos[c];
+        SASSERT(pos != UINT_MAX);
+        unsigned last = m_unsat.back();
+        m_unsat[pos] = last;
+        m_unsat_pos[last] = pos;
+        m_unsat.pop_back();
+        m_unsat_pos[c] = UINT_MAX;
+    }
+
+    void local_search::flip(bool_var v) {
+        SASSERT(!m_fixed[v]);
+        m_stats.m_flips++;
+        m_value[v] = !m_value[v];
+        literal t(v, !m_value[v]);
+        SASSERT(is_true(t));
+        // clauses containing t gain a true literal.
+        unsigned const* it  = m_occs.c_ptr() + m_occ_begin[t.index()];
+        unsigned const* end = m_occs.c_ptr() + m_occ_begin[t.index() + 1];
+        for (; it != end; ++it) {
+            unsigned c = *it;
+            unsigned n = m_num_true[c]++;
+            if (n == 0) {
+                remove_unsat(c);
+                m_break[v]++;
+            }
+            else if (n == 1) {
+                m_break[m_true_xor[c]]--;
+            }
+            m_true_xor[c] ^= v;
+        }
+        // clauses containing ~t lose a true literal.
+        literal f = ~t;
+        it  = m_occs.c_ptr() + m_occ_begin[f.index()];
+        end = m_occs.c_ptr() + m_occ_begin[f.index() + 1];
+        for (; it != end; ++it) {
+            unsigned c = *it;
+            unsigned n = --m_num_true[c];
+            m_true_xor[c] ^= v;
+            if (n == 0) {
+                add_unsat(c);
+                m_break[v]--;
+            }
+            else if (n == 1) {
+                m_break[m_true_xor[c]]++;
+            }
+        }
+    }
+
+    /**
+       \brief ProbSAT: select a variable of clause c with probability
+       proportional to cb^-break.
+    */
+    bool_var local_search::pick_var(unsigned c) {
+        double sum = 0;
+        m_probs.reset();
+        for (literal const* l = begin_clause(c); l != end_clause(c); ++l) {
+            bool_var v = l->var();
+            double p = m_fixed[v] ? 0 : m_prob_break[std::min(m_break[v], m_prob_break.size() - 1)];
+            m_probs.push_back(p);
+            sum += p;
+        }
+        SASSERT(sum > 0);
+        double r = sum * (static_cast<double>(m_rand()) / (random_gen::max_value() + 1.0));
+        unsigned i = 0;
+        literal const* l = begin_clause(c);
+        for (; l + 1 != end_clause(c); ++l, ++i) {
+            if (r < m_probs[i] && !m_fixed[l->var()])
+                return l->var();
+            r -= m_probs[i];
+        }
+        return l->var();
+    }
+
+    void local_search::save_best() {
+        m_stats.m_improvements++;
+        m_best_unsat = m_unsat.size();
+        m_best_value = m_value;
+    }
+
+    lbool local_search::check(unsigned max_flips) {
+        if (m_inconsistent)
+            return l_false;
+        m_stats.m_rounds++;
+        init_state();
+        for (unsigned flips = 0; flips < max_flips && !m_unsat.empty(); ++flips) {
+            if ((flips & 0xFF) == 0 && !m_limit.inc())
+                break;
+            unsigned c = m_unsat[m_rand(m_unsat.size())];
+            bool_var v = pick_var(c);
+            if (m_fixed[v])
+                continue;
+            flip(v);
+            if (m_unsat.size() < m_best_unsat)
+                save_best();
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat.local-search :flips " << m_stats.m_flips
+                   << " :unsat " << m_best_unsat << ")\n";);
+        return m_unsat.empty() ? l_true : l_undef;
+    }
+
+    void local_search::get_model(model& mdl) const {
+        mdl.reset();
+        for (bool_var v = 0; v < m_num_vars; ++v) {
+            mdl.push_back(m_best_value[v] ? l_true : l_false);
+        }
+    }
+
+    void local_search::collect_statistics(statistics& st) const {
+        st.update("local search flips", m_stats.m_flips);
+        st.update("local search rounds", m_stats.m_rounds);
+        st.update("local search improvements", m_stats.m_improvements);
+    }
+
+};
@@ -0,0 +1,116 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.h
+
+Abstract:
+
+    Stochastic local search (ProbSAT) over the clauses of a sat::solver.
+
+    Clauses are stored in flat arrays. Each clause maintains the number
+    of its true literals and the xor of the variables of its true
+    literals, so that the unique true variable of a critical clause is
+    available in constant time. Break counts are cached per variable and
+    updated incrementally on every flip.
+
+    The best assignment found is used to seed the saved phases of the
+    CDCL solver, or as a model when it satisfies all clauses.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#ifndef SAT_LOCAL_SEARCH_H_
+#define SAT_LOCAL_SEARCH_H_
+
+#include "sat/sat_types.h"
+#include "util/rlimit.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class local_search {
+        struct stats {
+            unsigned m_flips;
+            unsigned m_rounds;
+            unsigned m_improvements;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        reslimit&       m_limit;
+        random_gen      m_rand;
+        stats           m_stats;
+        bool            m_inconsistent;  // fixed literals falsify some clause
+        unsigned        m_num_vars;
+
+        // clause i occupies positions [m_clause_begin[i], m_clause_begin[i+1]) of m_clause_lits.
+        unsigned_vector m_clause_begin;
+        literal_vector  m_clause_lits;
+        // clauses containing literal l are m_occs[m_occ_begin[l.index()] .. m_occ_begin[l.index()+1]).
+        unsigned_vector m_occ_begin;
+        unsigned_vector m_occs;
+
+        svector<char>   m_value;        // current truth value of variables
+        svector<char>   m_fixed;        // variables that may not be flipped
+        unsigned_vector m_num_true;     // number of true literals per clause
+        unsigned_vector m_true_xor;     // xor of variables of true literals per clause
+        unsigned_vector m_break;        // number of clauses in which v is the only true variable
+        unsigned_vector m_unsat;        // unsatisfied clauses
+        unsigned_vector m_unsat_pos;    // position of clause in m_unsat
+
+        svector<char>   m_best_value;
+        unsigned        m_best_unsat;
+
+        double          m_cb;
+        svector<double> m_prob_break;   // m_cb^-k for break count k
+        svector<double> m_probs;
+
+        unsigned num_clauses() const { return m_clause_begin.size() - 1; }
+        literal const* begin_clause(unsigned c) const { return m_clause_lits.c_ptr() + m_clause_begin[c]; }
+        literal const* end_clause(unsigned c) const { return m_clause_lits.c_ptr() + m_clause_begin[c + 1]; }
+        bool is_true(literal l) const { return (m_value[l.var()] != 0) != l.sign(); }
+
+        void add_clause(unsigned sz, literal const* lits, svector<char> const& fixed_val);
+        void init_occs();
+        void init_state();
+        void add_unsat(unsigned c);
+        void remove_unsat(unsigned c);
+        bool_var pick_var(unsigned c);
+        void flip(bool_var v);
+        void save_best();
+
+    public:
+        local_search(reslimit& l, unsigned seed, double cb);
+
+        /**
+           \brief import the non-learned clauses of s.
+           Variables assigned at the base level of s, and the literals in fixed, are never flipped.
+           The initial assignment follows the saved phases of s.
+        */
+        void import(solver const& s, literal_vector const& fixed);
+
+        /**
+           \brief run at most max_flips flips.
+           Return l_true if all clauses are satisfied, l_false if the fixed
+           literals falsify some clause, and l_undef otherwise.
+        */
+        lbool check(unsigned max_flips);
+
+        unsigned best_unsat() const { return m_best_unsat; }
+        bool best_phase(bool_var v) const { return m_best_value[v] != 0; }
+        void get_model(model& mdl) const;
+
+        void collect_statistics(statistics& st) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,468 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Lookahead SAT solver in the style of March.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include "sat/sat_lookahead.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    lookahead::lookahead(solver& s):
+        s(s),
+        m_num_vars(0),
+        m_qhead(0),
+        m_inconsistent(false),
+        m_delta_trigger(0) {
+        config const& c = s.get_config();
+        m_cube_depth       = c.m_lookahead_cube_depth;
+        m_max_candidates   = c.m_lookahead_candidates;
+        m_double_lookahead = c.m_lookahead_double;
+    }
+
+    void lookahead::add_binary(literal l1, literal l2) {
+        m_binary[(~l1).index()].push_back(l2);
+        m_binary[(~l2).index()].push_back(l1);
+    }
+
+    void lookahead::add_clause(unsigned sz, literal const* lits) {
+        unsigned idx = m_clauses.size();
+        m_clauses.push_back(literal_vector(sz, lits));
+        for (unsigned i = 0; i < sz; ++i) {
+            m_occs[lits[i].index()].push_back(idx);
+        }
+        m_watches[lits[0].index()].push_back(idx);
+        m_watches[lits[1].index()].push_back(idx);
+    }
+
+    /**
+       \brief copy clauses from the solver.
+       Binary clauses (including learned ones) and non-learned clauses are copied.
+       Units at the base level and negated user scope literals are asserted at the root.
+    */
+    void lookahead::init() {
+        SASSERT(s.scope_lvl() == 0);
+        m_num_vars = s.num_vars();
+        m_binary.reset();
+        m_clauses.reset();
+        m_binary.resize(2 * m_num_vars);
+        m_watches.resize(2 * m_num_vars);
+        m_occs.resize(2 * m_num_vars);
+        m_value.resize(2 * m_num_vars, l_undef);
+        m_diff.resize(2 * m_num_vars, 0);
+        m_rating.resize(m_num_vars, 0);
+
+        for (unsigned l_idx = 0; l_idx < s.m_watches.size(); ++l_idx) {
+            literal l = ~to_literal(l_idx);
+            watch_list const& wlist = s.m_watches[l_idx];
+            watch_list::const_iterator it = wlist.begin(), end = wlist.end();
+            for (; it != end; ++it) {
+                if (!it->is_binary_clause())
+                    continue;
+                literal l2 = it->get_literal();
+                if (l.index() < l2.index() && s.value(l) == l_undef && s.value(l2) == l_undef)
+                    add_binary(l, l2);
+            }
+        }
+
+        literal_vector lits;
+        clause_vector::const_iterator it = s.m_clauses.begin(), end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const& c = *(*it);
+            lits.reset();
+            bool sat = false;
+            for (unsigned i = 0; !sat && i < c.size(); ++i) {
+                switch (s.value(c[i])) {
+                case l_true:  sat = true; break;
+                case l_undef: lits.push_back(c[i]); break;
+                default: break;
+                }
+            }
+            if (sat)
+                continue;
+            switch (lits.size()) {
+            case 0:
+                m_inconsistent = true;
+                break;
+            case 1:
+                assign(lits[0]);
+                break;
+            case 2:
+                add_binary(lits[0], lits[1]);
+                break;
+            default:
+                add_clause(lits.size(), lits.c_ptr());
+                break;
+            }
+        }
+
+        for (unsigned i = 0; i < s.m_trail.size(); ++i) {
+            assign(s.m_trail[i]);
+        }
+        for (unsigned i = 0; i < s.m_user_scope_literals.size(); ++i) {
+            assign(~s.m_user_scope_literals[i]);
+        }
+        propagate();
+    }
+
+    void lookahead::assign(literal l) {
+        switch (value(l)) {
+        case l_true:
+            break;
+        case l_false:
+            m_inconsistent = true;
+            break;
+        default:
+            m_value[l.index()]    = l_true;
+            m_value[(~l).index()] = l_false;
+            m_trail.push_back(l);
+            break;
+        }
+    }
+
+    bool lookahead::propagate() {
+        while (!inconsistent() && m_qhead < m_trail.size()) {
+            s.checkpoint();
+            literal l = m_trail[m_qhead++];
+            m_stats.m_propagations++;
+            literal_vector const& bins = m_binary[l.index()];
+            for (unsigned i = 0; !inconsistent() && i < bins.size(); ++i) {
+                assign(bins[i]);
+            }
+            // clauses watching ~l
+            literal not_l = ~l;
+            unsigned_vector& wlist = m_watches[not_l.index()];
+            unsigned j = 0, sz = wlist.size();
+            for (unsigned i = 0; i < sz; ++i) {
+                unsigned idx = wlist[i];
+                if (inconsistent()) {
+                    wlist[j++] = idx;
+                    continue;
+                }
+                literal_vector& c = m_clauses[idx];
+                if (c[0] == not_l)
+                    std::swap(c[0], c[1]);
+                SASSERT(c[1] == not_l);
+                if (value(c[0]) == l_true) {
+                    wlist[j++] = idx;
+                    continue;
+                }
+                bool found = false;
+                for (unsigned k = 2; !found && k < c.size(); ++k) {
+                    if (value(c[k]) != l_false) {
+                        std::swap(c[1], c[k]);
+                        m_watches[c[1].index()].push_back(idx);
+                        found = true;
+                    }
+                }
+                if (found)
+                    continue;
+                wlist[j++] = idx;
+                assign(c[0]);
+            }
+            wlist.shrink(j);
+        }
+        return !inconsistent();
+    }
+
+    void lookahead::push(literal l) {
+        SASSERT(!inconsistent());
+        SASSERT(m_qhead == m_trail.size());
+        m_trail_lim.push_back(m_trail.size());
+        m_cube_lim.push_back(m_cube.size());
+        assign(l);
+    }
+
+    void lookahead::pop() {
+        SASSERT(scope_lvl() > 0);
+        unsigned old_sz = m_trail_lim.back();
+        m_trail_lim.pop_back();
+        for (unsigned i = old_sz; i < m_trail.size(); ++i) {
+            literal l = m_trail[i];
+            m_value[l.index()]    = l_undef;
+            m_value[(~l).index()] = l_undef;
+        }
+        m_trail.shrink(old_sz);
+        m_qhead = old_sz;
+        m_cube.shrink(m_cube_lim.back());
+        m_cube_lim.pop_back();
+        m_inconsistent = false;
+    }
+
+    bool lookahead::is_sat_clause(literal_vector const& c) const {
+        for (unsigned i = 0; i < c.size(); ++i) {
+            if (value(c[i]) == l_true)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+       \brief rate the free variables by their occurrences in
+       unsatisfied clauses, weighted by the clause size, and keep the
+       best m_max_candidates of them.
+       Return false if all clauses are satisfied.
+    */
+    bool lookahead::preselect() {
+        m_candidates.reset();
+        for (bool_var v = 0; v < m_num_vars; ++v) {
+            m_rating[v] = 0;
+        }
+        bool has_open = false;
+        for (unsigned l_idx = 0; l_idx < m_binary.size(); ++l_idx) {
+            literal l = to_literal(l_idx);
+            if (value(l) != l_undef)
+                continue;
+            literal_vector const& bins = m_binary[l_idx];
+            for (unsigned i = 0; i < bins.size(); ++i) {
+                if (value(bins[i]) == l_undef) {
+                    // binary clause ~l \/ bins[i] is open
+                    m_rating[l.var()] += 1;
+                    has_open = true;
+                }
+            }
+        }
+        for (unsigned idx = 0; idx < m_clauses.size(); ++idx) {
+            literal_vector const& c = m_clauses[idx];
+            if (is_sat_clause(c))
+                continue;
+            unsigned num_undef = 0;
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (value(c[i]) == l_undef)
+                    ++num_undef;
+            }
+            if (num_undef < 2)
+                continue;
+            double w = 1.0 / (1 << std::min(num_undef - 2, 16u));
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (value(c[i]) == l_undef)
+                    m_rating[c[i].var()] += w;
+            }
+            has_open = true;
+        }
+        if (!has_open)
+            return false;
+        for (bool_var v = 0; v < m_num_vars; ++v) {
+            if (value(literal(v, false)) == l_undef && m_rating[v] > 0 && !s.was_eliminated(v))
+                m_candidates.push_back(v);
+        }
+        if (m_candidates.size() > m_max_candidates) {
+            struct rating_lt {
+                svector<double> const& r;
+                rating_lt(svector<double> const& r): r(r) {}
+                bool operator()(bool_var a, bool_var b) const { return r[a] > r[b]; }
+            };
+            std::sort(m_candidates.begin(), m_candidates.end(), rating_lt(m_rating));
+            m_candidates.shrink(m_max_candidates);
+        }
+        return true;
+    }
+
+    /**
+       \brief difference heuristic: weighted count of clauses that were reduced,
+       but not satisfied, by the assignments on the trail since old_trail_sz.
+       Clauses reduced to binary clauses count the most.
+    */
+    double lookahead::diff(unsigned old_trail_sz) const {
+        double result = 0;
+        for (unsigned i = old_trail_sz; i < m_trail.size(); ++i) {
+            literal l = m_trail[i];
+            unsigned_vector const& occs = m_occs[(~l).index()];
+            for (unsigned j = 0; j < occs.size(); ++j) {
+                literal_vector const& c = m_clauses[occs[j]];
+                unsigned num_undef = 0;
+                bool sat = false;
+                for (unsigned k = 0; !sat && k < c.size(); ++k) {
+                    switch (value(c[k])) {
+                    case l_true: sat = true; break;
+                    case l_undef: ++num_undef; break;
+                    default: break;
+                    }
+                }
+                if (!sat && num_undef >= 2) {
+                    result += 1.0 / (1 << std::min(2 * (num_undef - 2), 16u));
+                }
+            }
+        }
+        return result + 0.01 * (m_trail.size() - old_trail_sz);
+    }
+
+    /**
+       \brief look ahead on l.
+       Set failed if l is a failed literal.
+       Return false if asserting the negation of a failed literal produced a conflict.
+    */
+    bool lookahead::lookahead_lit(literal l, bool& failed) {
+        m_stats.m_lookaheads++;
+        unsigned old_sz = m_trail.size();
+        push(l);
+        failed = !propagate();
+        double d = 0;
+        if (!failed) {
+            d = diff(old_sz);
+            if (m_double_lookahead && d > m_delta_trigger) {
+                failed = !double_lookahead(l);
+                if (!failed) {
+                    m_delta_trigger = d;
+                    d = diff(old_sz);
+                }
+            }
+        }
+        pop();
+        m_diff[l.index()] = d;
+        if (failed) {
+            m_stats.m_failed_literals++;
+            TRACE("sat_lookahead", tout << "failed literal: " << l << "\n";);
+            push_cube(~l);
+            assign(~l);
+            return propagate();
+        }
+        return true;
+    }
+
+    /**
+       \brief look for failed literals under l.
+       A literal l2 that fails under l is asserted negatively under l.
+       Return false if l itself is failed.
+    */
+    bool lookahead::double_lookahead(literal l) {
+        m_stats.m_double_lookaheads++;
+        unsigned num = std::min(m_candidates.size(), std::max(1u, m_max_candidates / 2));
+        for (unsigned i = 0; i < num; ++i) {
+            bool_var v = m_candidates[i];
+            for (unsigned sign = 0; sign < 2; ++sign) {
+                literal l2(v, sign != 0);
+                if (value(l2) != l_undef)
+                    continue;
+                push(l2);
+                bool ok = propagate();
+                pop();
+                if (!ok) {
+                    m_stats.m_double_failed_literals++;
+                    assign(~l2);
+                    if (!propagate())
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+       \brief select a branching variable.
+       Return false if the current node was refuted by failed literals.
+       v is set to null_bool_var if all clauses are satisfied.
+    */
+    bool lookahead::select(bool_var& v) {
+        v = null_bool_var;
+        bool change = true;
+        // the delta trigger decays so that double lookahead is attempted again.
+        m_delta_trigger *= 0.9;
+        while (change) {
+            if (!preselect())
+                return true;
+            change = false;
+            for (unsigned i = 0; i < m_candidates.size(); ++i) {
+                bool_var w = m_candidates[i];
+                for (unsigned sign = 0; sign < 2; ++sign) {
+                    literal l(w, sign != 0);
+                    if (value(l) != l_undef)
+                        continue;
+                    bool failed = false;
+                    if (!lookahead_lit(l, failed))
+                        return false;
+                    change |= failed;
+                }
+            }
+        }
+        double best = -1;
+        for (unsigned i = 0; i < m_candidates.size(); ++i) {
+            bool_var w = m_candidates[i];
+            if (value(literal(w, false)) != l_undef)
+                continue;
+            double p = m_diff[literal(w, false).index()];
+            double n = m_diff[literal(w, true).index()];
+            double score = 1024 * p * n + p + n;
+            if (score > best) {
+                best = score;
+                v = w;
+            }
+        }
+        SASSERT(v != null_bool_var);
+        return true;
+    }
+
+    lbool lookahead::search(unsigned depth, vector<literal_vector>& cubes) {
+        s.checkpoint();
+        if (depth >= m_cube_depth) {
+            m_stats.m_cubes++;
+            cubes.push_back(m_cube);
+            return l_undef;
+        }
+        bool_var v;
+        if (!select(v)) {
+            m_stats.m_refuted_cubes++;
+            return l_false;
+        }
+        if (v == null_bool_var) {
+            cubes.reset();
+            cubes.push_back(m_cube);
+            return l_true;
+        }
+        m_stats.m_decisions++;
+        // branch first on the polarity that reduces more clauses.
+        literal l(v, m_diff[literal(v, false).index()] < m_diff[literal(v, true).index()]);
+        lbool result = l_false;
+        for (unsigned i = 0; i < 2; ++i, l.neg()) {
+            TRACE("sat_lookahead", tout << "decide " << depth << ": " << l << "\n";);
+            push(l);
+            push_cube(l);
+            lbool r = propagate() ? search(depth + 1, cubes) : l_false;
+            pop();
+            if (r == l_true)
+                return l_true;
+            if (r == l_undef)
+                result = l_undef;
+            else
+                m_stats.m_refuted_cubes++;
+        }
+        return result;
+    }
+
+    lbool lookahead::cube(vector<literal_vector>& cubes) {
+        cubes.reset();
+        init();
+        if (inconsistent())
+            return l_false;
+        lbool r = search(0, cubes);
+        IF_VERBOSE(1, verbose_stream() << "(sat.lookahead :cubes " << cubes.size()
+                   << " :refuted " << m_stats.m_refuted_cubes
+                   << " :failed-literals " << m_stats.m_failed_literals << ")\n";);
+        return r;
+    }
+
+    void lookahead::collect_statistics(statistics& st) const {
+        st.update("lookahead propagations", m_stats.m_propagations);
+        st.update("lookaheads", m_stats.m_lookaheads);
+        st.update("double lookaheads", m_stats.m_double_lookaheads);
+        st.update("lookahead failed literals", m_stats.m_failed_literals);
+        st.update("double lookahead failed literals", m_stats.m_double_failed_literals);
+        st.update("lookahead decisions", m_stats.m_decisions);
+        st.update("lookahead cubes", m_stats.m_cubes);
+        st.update("lookahead refuted cubes", m_stats.m_refuted_cubes);
+    }
+
+};
@@ -0,0 +1,124 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.h
+
+Abstract:
+
+    Lookahead SAT solver in the style of March.
+    It is used for splitting a CNF into cubes
+    for cube and conquer.
+
+    Each search node performs a lookahead on a preselected
+    set of variables. Failed literals are asserted at the node.
+    Lookaheads that reduce many clauses trigger a double lookahead
+    that looks for failed literals under the first literal.
+    The variable with the best combined difference score on
+    both polarities is selected for branching.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#ifndef SAT_LOOKAHEAD_H_
+#define SAT_LOOKAHEAD_H_
+
+#include "sat/sat_types.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class lookahead {
+        struct stats {
+            unsigned m_propagations;
+            unsigned m_lookaheads;
+            unsigned m_double_lookaheads;
+            unsigned m_failed_literals;
+            unsigned m_double_failed_literals;
+            unsigned m_decisions;
+            unsigned m_refuted_cubes;
+            unsigned m_cubes;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        solver&                 s;
+        stats                   m_stats;
+        unsigned                m_num_vars;
+
+        // binary clauses are kept as implications:
+        // m_binary[l.index()] contains the literals implied by l.
+        vector<literal_vector>  m_binary;
+        // clauses of size >= 3. The first two literals are watched.
+        vector<literal_vector>  m_clauses;
+        vector<unsigned_vector> m_watches;  // m_watches[l.index()] clauses watching l.
+        vector<unsigned_vector> m_occs;     // m_occs[l.index()] clauses containing l.
+
+        svector<char>           m_value;    // value indexed by literal.
+        literal_vector          m_trail;
+        unsigned_vector         m_trail_lim;
+        unsigned                m_qhead;
+        bool                    m_inconsistent;
+
+        // literals forced on the current path: decisions and failed literals.
+        literal_vector          m_cube;
+        unsigned_vector         m_cube_lim;
+
+        // lookahead scores
+        svector<double>         m_rating;   // rating of variable during preselection.
+        svector<double>         m_diff;     // difference score indexed by literal.
+        bool_var_vector         m_candidates;
+        double                  m_delta_trigger; // threshold for double lookahead.
+
+        // config
+        unsigned                m_cube_depth;
+        unsigned                m_max_candidates;
+        bool                    m_double_lookahead;
+
+        void init();
+        void add_binary(literal l1, literal l2);
+        void add_clause(unsigned sz, literal const* lits);
+
+        lbool value(literal l) const { return static_cast<lbool>(m_value[l.index()]); }
+        bool inconsistent() const { return m_inconsistent; }
+        unsigned scope_lvl() const { return m_trail_lim.size(); }
+        void assign(literal l);
+        bool propagate();
+        void push(literal l);
+        void pop();
+        void push_cube(literal l) { m_cube.push_back(l); }
+
+        bool is_sat_clause(literal_vector const& c) const;
+        bool preselect();
+        double diff(unsigned old_trail_sz) const;
+        bool lookahead_lit(literal l, bool& failed);
+        bool double_lookahead(literal l);
+        bool select(bool_var& v);
+        lbool search(unsigned depth, vector<literal_vector>& cubes);
+
+    public:
+        lookahead(solver& s);
+
+        /**
+           \brief split the clauses of s into cubes.
+           Return l_false if every cube was refuted during cubing.
+           Return l_true if cubing found a satisfying assignment; cubes then
+           contains a single cube whose propagation satisfies all clauses.
+           Return l_undef otherwise, in which case the disjunction of the
+           produced cubes covers every model of s.
+        */
+        lbool cube(vector<literal_vector>& cubes);
+
+        void collect_statistics(statistics& st) const;
+    };
+
+};
+
+#endif
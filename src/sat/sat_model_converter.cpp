@@ -223,6 +223,21 @@ namespace sat {
         out << ")\n";
     }
 
+    void model_converter::restore(bool_var v, literal_vector & r) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_entries.size(); ++i) {
+            entry & e = m_entries[i];
+            if (e.var() == v) {
+                r.append(e.m_clauses);
+                continue;
+            }
+            if (i != j)
+                m_entries[j] = e;
+            ++j;
+        }
+        m_entries.shrink(j);
+    }
+
     void model_converter::copy(model_converter const & src) {
         vector<entry>::const_iterator it  = src.m_entries.begin();
         vector<entry>::const_iterator end = src.m_entries.end();
@@ -66,6 +66,14 @@ namespace sat {
         void insert(entry & e, clause_wrapper const & c);
 
         bool empty() const { return m_entries.empty(); }
+        unsigned size() const { return m_entries.size(); }
+        bool_var last_var() const { return m_entries.back().var(); }
+
+        /**
+           \brief remove the entries for v and append their clauses to r.
+           The clauses are separated by null_literal.
+        */
+        void restore(bool_var v, literal_vector & r);
 
         void reset();
         bool check_invariant(unsigned num_vars) const;
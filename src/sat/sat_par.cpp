@@ -21,7 +21,39 @@ Revision History:
 
 namespace sat {
 
-    par::par() {}
+    void par::clause_ring::push(unsigned sz, literal const* lits) {
+        SASSERT(sz + 1 <= capacity());
+        // drop the oldest entries that are overwritten by this one.
+        while (m_tail + sz + 1 - m_head > capacity()) {
+            m_head += get(m_head) + 1;
+        }
+        set(m_tail++, sz);
+        for (unsigned i = 0; i < sz; ++i) {
+            set(m_tail++, lits[i].index());
+        }
+    }
+
+    void par::clause_ring::read(uint64& pos, literal_vector& lits, unsigned_vector& sizes) const {
+        if (pos < m_head) {
+            pos = m_head;
+        }
+        while (pos < m_tail) {
+            unsigned sz = get(pos++);
+            sizes.push_back(sz);
+            for (unsigned i = 0; i < sz; ++i) {
+                lits.push_back(to_literal(get(pos++)));
+            }
+        }
+    }
+
+    par::par(unsigned num_solvers, unsigned buffer_size) {
+        m_rings.resize(num_solvers);
+        m_cursors.resize(num_solvers);
+        for (unsigned i = 0; i < num_solvers; ++i) {
+            m_rings[i].reserve(buffer_size);
+            m_cursors[i].resize(num_solvers, 0);
+        }
+    }
 
     void par::exchange(literal_vector const& in, unsigned& limit, literal_vector& out) {
         #pragma omp critical (par_solver)
@@ -40,6 +72,30 @@ namespace sat {
             limit = m_units.size();
         }
     }
-    
-};
 
+    void par::share_clause(unsigned owner, unsigned sz, literal const* lits) {
+        SASSERT(owner < num_solvers());
+        clause_ring& r = m_rings[owner];
+        if (sz + 1 > r.capacity()) {
+            return;
+        }
+        #pragma omp critical (par_solver)
+        {
+            r.push(sz, lits);
+        }
+    }
+
+    void par::get_clauses(unsigned reader, literal_vector& lits, unsigned_vector& sizes) {
+        SASSERT(reader < num_solvers());
+        svector<uint64>& cursors = m_cursors[reader];
+        #pragma omp critical (par_solver)
+        {
+            for (unsigned owner = 0; owner < num_solvers(); ++owner) {
+                if (owner != reader) {
+                    m_rings[owner].read(cursors[owner], lits, sizes);
+                }
+            }
+        }
+    }
+
+};
@@ -27,11 +27,51 @@ namespace sat {
 
     class par {
         typedef hashtable<unsigned, u_hash, u_eq> index_set;
-        literal_vector m_units;
-        index_set      m_unit_set;
+
+        /**
+           \brief Bounded ring of clauses exported by a single solver.
+
+           Each entry is stored as its length followed by the literal indices.
+           Positions are logical (they grow monotonically), the physical slot
+           is the position modulo the capacity. When the writer laps the
+           oldest entry, that entry is dropped and readers that have not
+           consumed it yet skip ahead to the oldest intact entry.
+        */
+        class clause_ring {
+            unsigned_vector m_buffer;
+            uint64          m_head; // position of the oldest intact entry
+            uint64          m_tail; // position of the next write
+            unsigned get(uint64 pos) const { return m_buffer[static_cast<unsigned>(pos % m_buffer.size())]; }
+            void set(uint64 pos, unsigned v) { m_buffer[static_cast<unsigned>(pos % m_buffer.size())] = v; }
+        public:
+            clause_ring(): m_head(0), m_tail(0) {}
+            void reserve(unsigned sz) { m_buffer.resize(sz, 0); }
+            unsigned capacity() const { return m_buffer.size(); }
+            void push(unsigned sz, literal const* lits);
+            void read(uint64& pos, literal_vector& lits, unsigned_vector& sizes) const;
+        };
+
+        literal_vector       m_units;
+        index_set            m_unit_set;
+        vector<clause_ring>  m_rings;      // one ring per solver, written only by its owner.
+        vector<svector<uint64> > m_cursors; // m_cursors[reader][owner] read position of reader in ring of owner.
     public:
-        par();
+        par(unsigned num_solvers, unsigned buffer_size);
+
+        unsigned num_solvers() const { return m_rings.size(); }
+
         void exchange(literal_vector const& in, unsigned& limit, literal_vector& out);
+
+        /**
+           \brief publish a learned clause of solver owner to the other solvers.
+        */
+        void share_clause(unsigned owner, unsigned sz, literal const* lits);
+
+        /**
+           \brief retrieve the clauses published by other solvers since the last call by reader.
+           Clauses are returned back to back in lits, with their lengths in sizes.
+        */
+        void get_clauses(unsigned reader, literal_vector& lits, unsigned_vector& sizes);
     };
 
 };
@@ -60,7 +60,8 @@ namespace sat {
     bool probing::try_lit(literal l, bool updt_cache) {
         SASSERT(s.m_qhead == s.m_trail.size());
         SASSERT(s.value(l.var()) == l_undef);
-        literal_vector * implied_lits = updt_cache ? 0 : cached_implied_lits(l);
+        // cached implications may depend on deleted clauses, they are not used for DRAT proofs.
+        literal_vector * implied_lits = (updt_cache || s.m_config.m_drat) ? 0 : cached_implied_lits(l);
         if (implied_lits) {
             literal_vector::iterator it  = implied_lits->begin();
             literal_vector::iterator end = implied_lits->end();
@@ -99,6 +100,11 @@ namespace sat {
             literal_vector::iterator it  = m_to_assert.begin();
             literal_vector::iterator end = m_to_assert.end();
             for (; it != end; ++it) {
+                if (s.m_config.m_drat) {
+                    // *it is implied by both m_assigned_lit and l.
+                    s.m_drat.add(~m_assigned_lit, *it);
+                    s.m_drat.add(~l, *it);
+                }
                 s.assign(*it, justification());
                 m_num_assigned++;
             }
@@ -127,6 +133,7 @@ namespace sat {
         }
         // collect literals that were assigned after assigning l
         m_assigned.reset();
+        m_assigned_lit = l;
         unsigned tr_sz = s.m_trail.size();
         for (unsigned i = old_tr_sz; i < tr_sz; i++) {
             m_assigned.insert(s.m_trail[i]);
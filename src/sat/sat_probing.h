@@ -30,6 +30,7 @@ namespace sat {
         solver &        s;
         unsigned        m_stopped_at;  // where did it stop
         literal_set     m_assigned;    // literals assigned in the first branch
+        literal         m_assigned_lit; // literal assigned in the first branch
         literal_vector  m_to_assert;
 
         // counters
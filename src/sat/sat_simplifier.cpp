@@ -151,7 +151,7 @@ namespace sat {
     void simplifier::operator()(bool learned) {
         if (s.inconsistent())
             return;
-        if (!m_subsumption && !m_elim_blocked_clauses && !m_resolution)
+        if (!m_subsumption && !m_elim_blocked_clauses && !m_resolution && !m_bva)
             return;
 
         // solver::scoped_disable_checkpoint _scoped_disable_checkpoint(s);
@@ -176,7 +176,9 @@ namespace sat {
         }
         register_clauses(s.m_clauses);
 
-        if (!learned && (m_elim_blocked_clauses || m_elim_blocked_clauses_at == m_num_calls))
+        // blocked clause elimination does not mark variables as eliminated, so
+        // it cannot be undone when clauses are added incrementally.
+        if (!learned && !s.m_config.m_inprocess && (m_elim_blocked_clauses || m_elim_blocked_clauses_at == m_num_calls))
             elim_blocked_clauses();
 
         if (!learned)
@@ -201,6 +203,9 @@ namespace sat {
                 break;
         }
         while (!m_sub_todo.empty());
+
+        if (!learned)
+            bva();
     }
 
     void simplifier::scoped_finalize_fn() {
@@ -294,6 +299,7 @@ namespace sat {
                 continue;
             }
             if (sz == 2) {
+                if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
                 s.mk_bin_clause(c[0], c[1], c.is_learned());
                 s.del_clause(c);
                 continue;
@@ -558,7 +564,8 @@ namespace sat {
             literal l = c[i];
             switch (value(l)) {
             case l_undef:
-                c[j] = l;
+                // swap, so that c keeps its literals for the DRAT proof.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             case l_false:
@@ -571,11 +578,15 @@ namespace sat {
                 break;
             case l_true:
                 r = true;
-                c[j] = l;
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
         }
+        if (s.m_config.m_drat && j < sz) {
+            s.m_drat.add(j, c.begin());
+            s.m_drat.del(c);
+        }
         c.shrink(j);
         return r;
     }
@@ -645,6 +656,14 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_elim_todo(l.var());
+        if (s.m_config.m_drat) {
+            literal_vector new_lits;
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (c[i] != l) new_lits.push_back(c[i]);
+            }
+            s.m_drat.add(new_lits.size(), new_lits.c_ptr());
+            s.m_drat.del(c);
+        }
         c.elim(l);
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
@@ -668,6 +687,7 @@ namespace sat {
             return;
         case 2:
             TRACE("elim_lit", tout << "clause became binary: " << c[0] << " " << c[1] << "\n";);
+            if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
             s.mk_bin_clause(c[0], c[1], c.is_learned());
             m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
             remove_clause(c);
@@ -861,6 +881,7 @@ namespace sat {
                 }
                 if (sz == 2) {
                     TRACE("subsumption", tout << "clause became binary: " << c << "\n";);
+                    if (s.m_config.m_drat) s.m_drat.add(c[0], c[1]);
                     s.mk_bin_clause(c[0], c[1], c.is_learned());
                     m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
                     remove_clause(c);
@@ -1246,8 +1267,8 @@ namespace sat {
                 return;
             }
         }
-        wlist1.push_back(watched(l2, false));
-        wlist2.push_back(watched(l1, false));
+        push_binary_watch(wlist1, watched(l2, false));
+        push_binary_watch(wlist2, watched(l1, false));
     }
 
     /**
@@ -1298,6 +1319,218 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Return the index of a clause in cs that consists of exactly the literals lits, or -1.
+    */
+    int simplifier::find_clause(clause_wrapper_vector const & cs, unsigned n, literal const * lits) {
+        m_elim_counter -= cs.size();
+        for (unsigned i = 0; i < cs.size(); ++i) {
+            clause_wrapper const & c = cs[i];
+            if (c.size() != n)
+                continue;
+            unsigned j = 0;
+            while (j < n && c.contains(lits[j]))
+                ++j;
+            if (j == n)
+                return i;
+        }
+        return -1;
+    }
+
+    /**
+       \brief Find l = AND(x_1, ..., x_n), that is, a clause (l \/ ~x_1 \/ ... \/ ~x_n) in lcls,
+       and binary clauses (~l \/ x_i) in ncls.
+       Equivalences l = x are the special case n = 1.
+    */
+    bool simplifier::find_and_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls,
+                                   unsigned_vector & lidx, unsigned_vector & nidx) {
+        m_gate_lits.reset();
+        for (unsigned i = 0; i < ncls.size(); ++i) {
+            clause_wrapper const & c = ncls[i];
+            if (c.size() != 2)
+                continue;
+            literal x = c[0] == ~l ? c[1] : c[0];
+            if (!is_marked(~x)) {
+                mark_visited(~x);
+                m_gate_lits.push_back(~x);
+            }
+        }
+        int found = -1;
+        if (!m_gate_lits.empty()) {
+            for (unsigned j = 0; found < 0 && j < lcls.size(); ++j) {
+                clause_wrapper const & c = lcls[j];
+                unsigned k = 0, sz = c.size();
+                while (k < sz && (c[k] == l || is_marked(c[k])))
+                    ++k;
+                if (k == sz)
+                    found = j;
+            }
+        }
+        for (unsigned i = 0; i < m_gate_lits.size(); ++i)
+            unmark_visited(m_gate_lits[i]);
+        if (found < 0)
+            return false;
+        clause_wrapper const & def = lcls[found];
+        lidx.push_back(found);
+        for (unsigned i = 0; i < ncls.size(); ++i) {
+            clause_wrapper const & c = ncls[i];
+            if (c.size() != 2)
+                continue;
+            literal x = c[0] == ~l ? c[1] : c[0];
+            if (def.contains(~x))
+                nidx.push_back(i);
+        }
+        if (def.size() == 2)
+            m_num_equiv_gates++;
+        else
+            m_num_and_gates++;
+        return true;
+    }
+
+    /**
+       \brief Find a XOR gate over the variables of a clause c in lcls:
+       all clauses over these variables with the same parity of negations as c.
+    */
+    bool simplifier::find_xor_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls) {
+        static const unsigned c_max_xor_size = 5;
+        literal lits[c_max_xor_size];
+        for (unsigned j = 0; j < lcls.size(); ++j) {
+            clause_wrapper const & c = lcls[j];
+            unsigned sz = c.size();
+            if (sz < 3 || sz > c_max_xor_size)
+                continue;
+            m_gate_lits.reset();
+            m_gate_lits.push_back(l);
+            for (unsigned k = 0; k < sz; ++k) {
+                if (c[k] != l)
+                    m_gate_lits.push_back(c[k]);
+            }
+            m_gate_pos_idx.reset();
+            m_gate_neg_idx.reset();
+            bool ok = true;
+            // flip an even number of literals of c.
+            for (unsigned mask = 0; ok && mask < (1u << sz); ++mask) {
+                unsigned parity = 0;
+                for (unsigned k = 0; k < sz; ++k) {
+                    bool flip = (mask & (1u << k)) != 0;
+                    parity ^= flip;
+                    lits[k] = flip ? ~m_gate_lits[k] : m_gate_lits[k];
+                }
+                if (parity != 0)
+                    continue;
+                bool is_neg = (mask & 1) != 0;
+                int idx = find_clause(is_neg ? ncls : lcls, sz, lits);
+                if (idx < 0)
+                    ok = false;
+                else if (is_neg)
+                    m_gate_neg_idx.push_back(idx);
+                else
+                    m_gate_pos_idx.push_back(idx);
+            }
+            if (ok) {
+                m_num_xor_gates++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+       \brief Find l = ite(c, t, e), that is, clauses (l \/ ~c \/ ~t), (l \/ c \/ ~e) in lcls
+       and (~l \/ ~c \/ t), (~l \/ c \/ e) in ncls.
+    */
+    bool simplifier::find_ite_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls) {
+        for (unsigned j = 0; j < lcls.size(); ++j) {
+            clause_wrapper const & c1 = lcls[j];
+            if (c1.size() != 3)
+                continue;
+            literal p = null_literal, q = null_literal;
+            for (unsigned k = 0; k < 3; ++k) {
+                if (c1[k] == l) continue;
+                if (p == null_literal) p = c1[k]; else q = c1[k];
+            }
+            for (unsigned r = 0; r < 2; ++r, std::swap(p, q)) {
+                // c = ~p, t = ~q
+                literal n1[3] = { ~l, p, ~q };
+                int i1 = find_clause(ncls, 3, n1);
+                if (i1 < 0)
+                    continue;
+                for (unsigned j2 = 0; j2 < lcls.size(); ++j2) {
+                    clause_wrapper const & c2 = lcls[j2];
+                    if (j2 == j || c2.size() != 3 || !c2.contains(~p) || c2.contains(q.var()))
+                        continue;
+                    literal x = null_literal;
+                    for (unsigned k = 0; k < 3; ++k) {
+                        if (c2[k] != l && c2[k] != ~p)
+                            x = c2[k];
+                    }
+                    // e = ~x
+                    literal n2[3] = { ~l, ~p, ~x };
+                    int i2 = find_clause(ncls, 3, n2);
+                    if (i2 < 0)
+                        continue;
+                    m_gate_pos_idx.reset();
+                    m_gate_neg_idx.reset();
+                    m_gate_pos_idx.push_back(j);
+                    m_gate_pos_idx.push_back(j2);
+                    m_gate_neg_idx.push_back(i1);
+                    m_gate_neg_idx.push_back(i2);
+                    m_num_ite_gates++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+       \brief Move the clauses at the (sorted) positions idx to the front of cs.
+    */
+    void simplifier::move_to_front(clause_wrapper_vector & cs, unsigned_vector const & idx) {
+        clause_wrapper_vector rest;
+        unsigned j = 0, k = 0;
+        for (unsigned i = 0; i < cs.size(); ++i) {
+            if (k < idx.size() && idx[k] == i) {
+                cs[j++] = cs[i];
+                ++k;
+            }
+            else {
+                rest.push_back(cs[i]);
+            }
+        }
+        for (unsigned i = 0; i < rest.size(); ++i)
+            cs[j++] = rest[i];
+    }
+
+    /**
+       \brief Find a gate that defines v in m_pos_cls and m_neg_cls.
+       If a gate is found, the gate clauses are moved to the front and
+       m_pos_gate_sz, m_neg_gate_sz are set to the number of gate clauses.
+    */
+    void simplifier::find_gate(bool_var v) {
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        m_gate_pos_idx.reset();
+        m_gate_neg_idx.reset();
+        bool found =
+            find_and_gate(pos_l, m_pos_cls, m_neg_cls, m_gate_pos_idx, m_gate_neg_idx) ||
+            find_and_gate(neg_l, m_neg_cls, m_pos_cls, m_gate_neg_idx, m_gate_pos_idx) ||
+            find_ite_gate(pos_l, m_pos_cls, m_neg_cls) ||
+            find_xor_gate(pos_l, m_pos_cls, m_neg_cls);
+        if (!found)
+            return;
+        // the same binary clause may be watched twice.
+        std::sort(m_gate_pos_idx.begin(), m_gate_pos_idx.end());
+        std::sort(m_gate_neg_idx.begin(), m_gate_neg_idx.end());
+        m_gate_pos_idx.set_end(std::unique(m_gate_pos_idx.begin(), m_gate_pos_idx.end()));
+        m_gate_neg_idx.set_end(std::unique(m_gate_neg_idx.begin(), m_gate_neg_idx.end()));
+        TRACE("resolution", tout << "gate for " << v << " pos: " << m_gate_pos_idx.size() << " neg: " << m_gate_neg_idx.size() << "\n";);
+        move_to_front(m_pos_cls, m_gate_pos_idx);
+        move_to_front(m_neg_cls, m_gate_neg_idx);
+        m_pos_gate_sz = m_gate_pos_idx.size();
+        m_neg_gate_sz = m_gate_neg_idx.size();
+    }
+
     bool simplifier::try_eliminate(bool_var v) {
         TRACE("resolution_bug", tout << "processing: " << v << "\n";);
         if (value(v) != l_undef)
@@ -1354,18 +1587,23 @@ namespace sat {
 
         m_elim_counter -= num_pos * num_neg + before_lits;
 
+        m_pos_gate_sz = 0;
+        m_neg_gate_sz = 0;
+        if (m_elim_gates)
+            find_gate(v);
+
         TRACE("resolution_detail", tout << "collecting number of after_clauses\n";);
         unsigned before_clauses = num_pos + num_neg;
         unsigned after_clauses  = 0;
-        clause_wrapper_vector::iterator it1  = m_pos_cls.begin();
-        clause_wrapper_vector::iterator end1 = m_pos_cls.end();
-        for (; it1 != end1; ++it1) {
-            clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
-            clause_wrapper_vector::iterator end2 = m_neg_cls.end();
-            for (; it2 != end2; ++it2) {
+        for (unsigned i = 0; i < m_pos_cls.size(); ++i) {
+            for (unsigned j = 0; j < m_neg_cls.size(); ++j) {
+                if (!use_resolvent(i, j))
+                    continue;
+                clause_wrapper const & c1 = m_pos_cls[i];
+                clause_wrapper const & c2 = m_neg_cls[j];
                 m_new_cls.reset();
-                if (resolve(*it1, *it2, pos_l, m_new_cls)) {
-                    TRACE("resolution_detail", tout << *it1 << "\n" << *it2 << "\n-->\n";
+                if (resolve(c1, c2, pos_l, m_new_cls)) {
+                    TRACE("resolution_detail", tout << c1 << "\n" << c2 << "\n-->\n";
                           for (unsigned i = 0; i < m_new_cls.size(); i++) tout << m_new_cls[i] << " "; tout << "\n";);
                     after_clauses++;
                     if (after_clauses > before_clauses) {
@@ -1392,16 +1630,16 @@ namespace sat {
 
         m_elim_counter -= num_pos * num_neg + before_lits;
 
-        it1  = m_pos_cls.begin();
-        end1 = m_pos_cls.end();
-        for (; it1 != end1; ++it1) {
-            clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
-            clause_wrapper_vector::iterator end2 = m_neg_cls.end();
-            for (; it2 != end2; ++it2) {
+        for (unsigned i = 0; i < m_pos_cls.size(); ++i) {
+            for (unsigned j = 0; j < m_neg_cls.size(); ++j) {
+                if (!use_resolvent(i, j))
+                    continue;
+                clause_wrapper const & c1 = m_pos_cls[i];
+                clause_wrapper const & c2 = m_neg_cls[j];
                 m_new_cls.reset();
-                if (!resolve(*it1, *it2, pos_l, m_new_cls))
+                if (!resolve(c1, c2, pos_l, m_new_cls))
                     continue;
-                TRACE("resolution_new_cls", tout << *it1 << "\n" << *it2 << "\n-->\n" << m_new_cls << "\n";);
+                TRACE("resolution_new_cls", tout << c1 << "\n" << c2 << "\n-->\n" << m_new_cls << "\n";);
                 if (cleanup_clause(m_new_cls))
                     continue; // clause is already satisfied.
                 switch (m_new_cls.size()) {
@@ -1413,6 +1651,7 @@ namespace sat {
                     break;
                 case 2:
                     s.m_stats.m_mk_bin_clause++;
+                    if (s.m_config.m_drat) s.m_drat.add(m_new_cls[0], m_new_cls[1]);
                     add_non_learned_binary_clause(m_new_cls[0], m_new_cls[1]);
                     back_subsumption1(m_new_cls[0], m_new_cls[1], false);
                     break;
@@ -1422,6 +1661,7 @@ namespace sat {
                     else
                         s.m_stats.m_mk_clause++;
                     clause * new_c = s.m_cls_allocator.mk_clause(m_new_cls.size(), m_new_cls.c_ptr(), false);
+                    if (s.m_config.m_drat) s.m_drat.add(*new_c);
                     s.m_clauses.push_back(new_c);
                     m_use_list.insert(*new_c);
                     if (m_sub_counter > 0)
@@ -1482,6 +1722,255 @@ namespace sat {
         m_new_cls.finalize();
     }
 
+    // -----------------------
+    //
+    // Bounded variable addition
+    //
+    // -----------------------
+
+    struct simplifier::bva_report {
+        simplifier & m_simplifier;
+        stopwatch    m_watch;
+        unsigned     m_num_bva_vars;
+        unsigned     m_num_bva_reduced;
+        bva_report(simplifier & s):
+            m_simplifier(s),
+            m_num_bva_vars(s.m_num_bva_vars),
+            m_num_bva_reduced(s.m_num_bva_reduced) {
+            m_watch.start();
+        }
+
+        ~bva_report() {
+            m_watch.stop();
+            IF_VERBOSE(SAT_VB_LVL,
+                       verbose_stream() << " (sat-bva :new-vars "
+                       << (m_simplifier.m_num_bva_vars - m_num_bva_vars)
+                       << " :reduced-clauses " << (m_simplifier.m_num_bva_reduced - m_num_bva_reduced)
+                       << mem_stat()
+                       << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
+        }
+    };
+
+    unsigned simplifier::get_num_occs(literal l) const {
+        return m_use_list.get(l).size() + get_num_non_learned_bin(l);
+    }
+
+    static int bva_reduction(unsigned num_lits, unsigned num_cls) {
+        return static_cast<int>(num_lits * num_cls) - static_cast<int>(num_lits + num_cls);
+    }
+
+    struct bva_match_lt {
+        bool operator()(std::pair<literal, unsigned> const & a, std::pair<literal, unsigned> const & b) const {
+            return a.first.index() < b.first.index() || (a.first == b.first && a.second < b.second);
+        }
+    };
+
+    void simplifier::bva_add_clause(literal_vector const & lits) {
+        SASSERT(lits.size() >= 2);
+        if (lits.size() == 2) {
+            s.m_stats.m_mk_bin_clause++;
+            if (s.m_config.m_drat) s.m_drat.add(lits[0], lits[1]);
+            add_non_learned_binary_clause(lits[0], lits[1]);
+        }
+        else {
+            if (lits.size() == 3)
+                s.m_stats.m_mk_ter_clause++;
+            else
+                s.m_stats.m_mk_clause++;
+            clause * c = s.m_cls_allocator.mk_clause(lits.size(), lits.c_ptr(), false);
+            if (s.m_config.m_drat) s.m_drat.add(*c);
+            s.m_clauses.push_back(c);
+            m_use_list.insert(*c);
+        }
+    }
+
+    /**
+       \brief remove the clause c with l replaced by l2.
+    */
+    void simplifier::bva_remove_clause(clause_wrapper const & c, literal l, literal l2) {
+        unsigned sz = c.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            if (c[i] != l) mark_visited(c[i]);
+        }
+        m_bva_occs.reset();
+        collect_clauses(l2, m_bva_occs);
+        for (unsigned i = 0; i < m_bva_occs.size(); ++i) {
+            clause_wrapper const & d = m_bva_occs[i];
+            if (d.size() != sz)
+                continue;
+            unsigned k = 0;
+            while (k < sz && (d[k] == l2 || is_marked(d[k])))
+                ++k;
+            if (k < sz)
+                continue;
+            if (d.is_binary()) {
+                literal l1 = d[0], l3 = d[1];
+                remove_bin_clause_half(l1, l3, false);
+                remove_bin_clause_half(l3, l1, false);
+                if (s.m_config.m_drat) s.m_drat.del(l1, l3);
+                insert_elim_todo(l1.var());
+                insert_elim_todo(l3.var());
+            }
+            else {
+                remove_clause(*d.get_clause());
+            }
+            m_num_bva_reduced++;
+            break;
+        }
+        for (unsigned i = 0; i < sz; ++i) {
+            if (c[i] != l) unmark_visited(c[i]);
+        }
+    }
+
+    /**
+       \brief SimpleBVA for literal l.
+       m_bva_lits holds l_1 = l, ..., l_n and m_bva_cls holds clauses (l \/ C_1), ..., (l \/ C_m),
+       such that all clauses (l_i \/ C_j) exist. The sets are extended greedily
+       with the literal that occurs most often as a replacement of l.
+    */
+    bool simplifier::bva(literal l) {
+        m_bva_cls.reset();
+        collect_clauses(l, m_bva_cls);
+        m_bva_lits.reset();
+        m_bva_lits.push_back(l);
+        while (m_bva_counter >= 0) {
+            m_bva_matches.reset();
+            for (unsigned i = 0; i < m_bva_cls.size(); ++i) {
+                clause_wrapper const & c = m_bva_cls[i];
+                unsigned sz = c.size();
+                literal lmin = null_literal;
+                unsigned min_occs = UINT_MAX;
+                for (unsigned k = 0; k < sz; ++k) {
+                    if (c[k] == l)
+                        continue;
+                    mark_visited(c[k]);
+                    unsigned n = get_num_occs(c[k]);
+                    if (n < min_occs) {
+                        min_occs = n;
+                        lmin = c[k];
+                    }
+                }
+                m_bva_occs.reset();
+                collect_clauses(lmin, m_bva_occs);
+                m_bva_counter -= m_bva_occs.size() * sz;
+                for (unsigned j = 0; j < m_bva_occs.size(); ++j) {
+                    clause_wrapper const & d = m_bva_occs[j];
+                    if (d.size() != sz)
+                        continue;
+                    literal l2 = null_literal;
+                    unsigned k = 0;
+                    for (; k < sz; ++k) {
+                        if (is_marked(d[k]))
+                            continue;
+                        if (l2 != null_literal)
+                            break;
+                        l2 = d[k];
+                    }
+                    if (k < sz || l2 == null_literal || l2.var() == l.var() || m_bva_lits.contains(l2))
+                        continue;
+                    m_bva_matches.push_back(bva_match(l2, i));
+                }
+                for (unsigned k = 0; k < sz; ++k) {
+                    if (c[k] != l) unmark_visited(c[k]);
+                }
+            }
+            if (m_bva_matches.empty())
+                break;
+            std::sort(m_bva_matches.begin(), m_bva_matches.end(), bva_match_lt());
+            literal lmax = null_literal;
+            unsigned max_count = 0;
+            for (unsigned i = 0; i < m_bva_matches.size(); ) {
+                literal l2 = m_bva_matches[i].first;
+                unsigned count = 0;
+                unsigned j = i;
+                for (; j < m_bva_matches.size() && m_bva_matches[j].first == l2; ++j) {
+                    if (j == i || m_bva_matches[j].second != m_bva_matches[j-1].second)
+                        ++count;
+                }
+                if (count > max_count) {
+                    max_count = count;
+                    lmax = l2;
+                }
+                i = j;
+            }
+            if (bva_reduction(m_bva_lits.size() + 1, max_count) <= bva_reduction(m_bva_lits.size(), m_bva_cls.size()))
+                break;
+            // keep the clauses that have a match for lmax.
+            unsigned j = 0;
+            unsigned last = UINT_MAX;
+            for (unsigned i = 0; i < m_bva_matches.size(); ++i) {
+                if (m_bva_matches[i].first == lmax && m_bva_matches[i].second != last) {
+                    last = m_bva_matches[i].second;
+                    m_bva_cls[j++] = m_bva_cls[last];
+                }
+            }
+            m_bva_cls.shrink(j);
+            m_bva_lits.push_back(lmax);
+        }
+        if (bva_reduction(m_bva_lits.size(), m_bva_cls.size()) <= 0)
+            return false;
+
+        bool_var x = s.mk_var(false, true);
+        m_use_list.reserve(s.num_vars());
+        m_visited.resize(2 * s.num_vars(), false);
+        literal xl(x, false);
+        TRACE("bva", tout << "x" << x << " replaces " << m_bva_lits << " in " << m_bva_cls.size() << " clauses\n";);
+        // x is the first literal, so that the new clauses have the RAT property on x for DRAT.
+        for (unsigned i = 0; i < m_bva_cls.size(); ++i) {
+            clause_wrapper const & c = m_bva_cls[i];
+            m_new_cls.reset();
+            m_new_cls.push_back(xl);
+            for (unsigned k = 0; k < c.size(); ++k) {
+                if (c[k] != l) m_new_cls.push_back(c[k]);
+            }
+            bva_add_clause(m_new_cls);
+        }
+        for (unsigned i = 0; i < m_bva_lits.size(); ++i) {
+            m_new_cls.reset();
+            m_new_cls.push_back(~xl);
+            m_new_cls.push_back(m_bva_lits[i]);
+            bva_add_clause(m_new_cls);
+        }
+        // (l_i \/ C_j) is the resolvent of (~x \/ l_i) and (x \/ C_j).
+        for (unsigned i = 0; i < m_bva_cls.size(); ++i) {
+            for (unsigned k = 0; k < m_bva_lits.size(); ++k) {
+                bva_remove_clause(m_bva_cls[i], l, m_bva_lits[k]);
+            }
+        }
+        m_need_cleanup = true;
+        m_num_bva_vars++;
+        return true;
+    }
+
+    void simplifier::bva() {
+        if (!m_bva) return;
+        bva_report rpt(*this);
+        m_bva_counter = m_bva_limit;
+        svector<std::pair<unsigned, unsigned> > lits;
+        unsigned num_lits = 2 * s.num_vars();
+        for (unsigned l_idx = 0; l_idx < num_lits; ++l_idx) {
+            literal l = to_literal(l_idx);
+            if (was_eliminated(l.var()) || value(l) != l_undef)
+                continue;
+            unsigned n = get_num_occs(l);
+            if (n >= 2)
+                lits.push_back(std::make_pair(n, l_idx));
+        }
+        // literals with most occurrences first.
+        std::sort(lits.begin(), lits.end());
+        for (unsigned i = lits.size(); i-- > 0 && m_bva_counter >= 0; ) {
+            checkpoint();
+            literal l = to_literal(lits[i].second);
+            if (get_num_occs(l) >= 2)
+                bva(l);
+            if (s.inconsistent())
+                break;
+        }
+        m_bva_cls.finalize();
+        m_bva_occs.finalize();
+        m_bva_matches.finalize();
+    }
+
     void simplifier::updt_params(params_ref const & _p) {
         sat_simplifier_params p(_p);
         m_elim_blocked_clauses    = p.elim_blocked_clauses();
@@ -1501,6 +1990,9 @@ namespace sat {
         m_subsumption             = p.subsumption();
         m_subsumption_limit       = p.subsumption_limit();
         m_elim_vars               = p.elim_vars();
+        m_elim_gates              = p.elim_vars_gates();
+        m_bva                     = p.bva();
+        m_bva_limit               = std::min(p.bva_limit(), static_cast<unsigned>(INT_MAX));
     }
 
     void simplifier::collect_param_descrs(param_descrs & r) {
@@ -1513,6 +2005,12 @@ namespace sat {
         st.update("elim literals", m_num_elim_lits);
         st.update("elim bool vars", m_num_elim_vars);
         st.update("elim blocked clauses", m_num_blocked_clauses);
+        st.update("elim equiv gates", m_num_equiv_gates);
+        st.update("elim and gates", m_num_and_gates);
+        st.update("elim xor gates", m_num_xor_gates);
+        st.update("elim ite gates", m_num_ite_gates);
+        st.update("bva vars", m_num_bva_vars);
+        st.update("bva reduced clauses", m_num_bva_reduced);
     }
 
     void simplifier::reset_statistics() {
@@ -1521,5 +2019,11 @@ namespace sat {
         m_num_sub_res = 0;
         m_num_elim_lits = 0;
         m_num_elim_vars = 0;
+        m_num_equiv_gates = 0;
+        m_num_and_gates = 0;
+        m_num_xor_gates = 0;
+        m_num_ite_gates = 0;
+        m_num_bva_vars = 0;
+        m_num_bva_reduced = 0;
     }
 };
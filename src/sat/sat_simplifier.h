@@ -10,6 +10,14 @@ Abstract:
     SAT simplification procedures that use a "full" occurrence list:
     Subsumption, Blocked Clause Removal, Variable Elimination, ...
 
+    Variable elimination recognizes AND (and equivalence), XOR and ITE
+    gates that define the variable being eliminated. When a gate is found,
+    only resolvents between gate and non-gate clauses are added.
+
+    Bounded variable addition replaces clauses of the form (l_i \/ C_j),
+    for literals l_1..l_n and clauses C_1..C_m, by (x \/ C_j) and (~x \/ l_i)
+    for a fresh variable x, when n*m > n + m.
+
 
 Author:
 
@@ -38,6 +46,7 @@ namespace sat {
         vector<clause_use_list> m_use_list;
     public:
         void init(unsigned num_vars);
+        void reserve(unsigned num_vars) { m_use_list.reserve(2 * num_vars); }
         void insert(clause & c);
         void erase(clause & c);
         void erase(clause & c, literal l);
@@ -63,6 +72,7 @@ namespace sat {
         // counters
         int                    m_sub_counter;
         int                    m_elim_counter;
+        int                    m_bva_counter;
 
         // config
         bool                   m_elim_blocked_clauses;
@@ -83,6 +93,9 @@ namespace sat {
         bool                   m_subsumption;
         unsigned               m_subsumption_limit;
         bool                   m_elim_vars;
+        bool                   m_elim_gates;
+        bool                   m_bva;
+        unsigned               m_bva_limit;
 
         // stats
         unsigned               m_num_blocked_clauses;
@@ -90,6 +103,12 @@ namespace sat {
         unsigned               m_num_elim_vars;
         unsigned               m_num_sub_res;
         unsigned               m_num_elim_lits;
+        unsigned               m_num_equiv_gates;
+        unsigned               m_num_and_gates;
+        unsigned               m_num_xor_gates;
+        unsigned               m_num_ite_gates;
+        unsigned               m_num_bva_vars;
+        unsigned               m_num_bva_reduced;
 
         bool                   m_learned_in_use_lists;
         unsigned               m_old_num_elim_vars;
@@ -169,9 +188,39 @@ namespace sat {
         bool try_eliminate(bool_var v);
         void elim_vars();
 
+        // gate detection: gate clauses are moved to the front of m_pos_cls and m_neg_cls.
+        unsigned       m_pos_gate_sz;
+        unsigned       m_neg_gate_sz;
+        unsigned_vector m_gate_pos_idx;
+        unsigned_vector m_gate_neg_idx;
+        literal_vector m_gate_lits;
+        int find_clause(clause_wrapper_vector const & cs, unsigned n, literal const * lits);
+        bool find_and_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls,
+                           unsigned_vector & lidx, unsigned_vector & nidx);
+        bool find_xor_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls);
+        bool find_ite_gate(literal l, clause_wrapper_vector const & lcls, clause_wrapper_vector const & ncls);
+        void move_to_front(clause_wrapper_vector & cs, unsigned_vector const & idx);
+        void find_gate(bool_var v);
+        bool use_resolvent(unsigned i, unsigned j) const {
+            return m_pos_gate_sz == 0 || ((i < m_pos_gate_sz) != (j < m_neg_gate_sz));
+        }
+
+        // bounded variable addition
+        typedef std::pair<literal, unsigned> bva_match;
+        clause_wrapper_vector m_bva_cls;
+        clause_wrapper_vector m_bva_occs;
+        literal_vector        m_bva_lits;
+        svector<bva_match>    m_bva_matches;
+        unsigned get_num_occs(literal l) const;
+        bool bva(literal l);
+        void bva_add_clause(literal_vector const & lits);
+        void bva_remove_clause(clause_wrapper const & c, literal l, literal l2);
+        void bva();
+
         struct blocked_cls_report;
         struct subsumption_report;
         struct elim_var_report;
+        struct bva_report;
 
         class scoped_finalize {
             simplifier& s;
@@ -21,6 +21,7 @@ Revision History:
 #include "util/luby.h"
 #include "util/trace.h"
 #include "util/max_cliques.h"
+#include "util/scoped_ptr_vector.h"
 
 // define to update glue during propagation
 #define UPDATE_GLUE
@@ -47,6 +48,10 @@ namespace sat {
         m_num_frozen(0),
         m_activity_inc(128),
         m_case_split_queue(m_activity),
+        m_chb_alpha(0.4),
+        m_chb_queue(m_chb),
+        m_branching(BH_VSIDS),
+        m_stable(true),
         m_qhead(0),
         m_scope_lvl(0),
         m_params(p) {
@@ -54,7 +59,11 @@ namespace sat {
         m_conflicts_since_gc      = 0;
         m_conflicts               = 0;
         m_next_simplify           = 0;
+        m_inprocess_budget        = 0;
+        m_inprocess_ticks         = 0;
+        m_inprocess_new_clauses   = 0;
         m_num_checkpoints         = 0;
+        m_par_id                  = 0;
     }
 
     solver::~solver() {
@@ -124,6 +133,8 @@ namespace sat {
 
         m_user_scope_literals.reset();
         m_user_scope_literals.append(src.m_user_scope_literals);
+        m_user_scope_mc_lim.reset();
+        m_user_scope_mc_lim.resize(m_user_scope_literals.size(), 0);
     }
 
     // -----------------------
@@ -152,7 +163,11 @@ namespace sat {
         m_phase.push_back(PHASE_NOT_AVAILABLE);
         m_prev_phase.push_back(PHASE_NOT_AVAILABLE);
         m_assigned_since_gc.push_back(false);
+        m_chb.push_back(0);
+        m_chb_last_conflict.push_back(0);
         m_case_split_queue.mk_var_eh(v);
+        m_chb_queue.mk_var_eh(v);
+        m_vmtf.mk_var_eh(v);
         m_simplifier.insert_elim_todo(v);
         SASSERT(!was_eliminated(v));
         return v;
@@ -160,20 +175,67 @@ namespace sat {
 
     void solver::mk_clause(unsigned num_lits, literal * lits) {
         m_model_is_current = false;
-        DEBUG_CODE({
-            for (unsigned i = 0; i < num_lits; i++)
-                SASSERT(m_eliminated[lits[i].var()] == false);
-        });
+        // variables eliminated by inprocessing are restored lazily.
+        for (unsigned i = 0; i < num_lits; i++) {
+            if (was_eliminated(lits[i].var()))
+                restore_var(lits[i].var());
+        }
 
+        clause * c;
         if (m_user_scope_literals.empty()) {
-            mk_clause_core(num_lits, lits, false);
+            c = mk_clause_core(num_lits, lits, false);
         }
         else {
             m_aux_literals.reset();
             m_aux_literals.append(num_lits, lits);
             m_aux_literals.append(m_user_scope_literals);
-            mk_clause_core(m_aux_literals.size(), m_aux_literals.c_ptr(), false);
+            c = mk_clause_core(m_aux_literals.size(), m_aux_literals.c_ptr(), false);
+        }
+        if (m_config.m_inprocess) {
+            m_inprocess_new_clauses++;
+            // new clauses are candidates for (backward) subsumption in the next inprocessing round.
+            if (c) c->mark_strengthened();
+        }
+    }
+
+    void solver::set_external(bool_var v) {
+        if (was_eliminated(v))
+            restore_var(v);
+        m_external[v] = true;
+    }
+
+    /**
+       \brief undo the elimination of v by adding the clauses that were saved in
+       the model converter when v was eliminated. Variables occurring in these clauses
+       that were eliminated later are restored as well.
+    */
+    void solver::restore_var(bool_var v) {
+        SASSERT(scope_lvl() == 0);
+        literal_vector clauses;
+        m_mc.restore(v, clauses);
+        if (m_eliminated[v]) {
+            m_eliminated[v] = false;
+            m_stats.m_restored_vars++;
+            switch (m_branching) {
+            case BH_VSIDS: m_case_split_queue.unassign_var_eh(v); break;
+            case BH_CHB:   m_chb_queue.unassign_var_eh(v); break;
+            case BH_VMTF:  m_vmtf.unassign_var_eh(v); break;
+            }
         }
+        TRACE("sat", tout << "restore " << v << ": " << clauses << "\n";);
+        literal_vector lits;
+        for (unsigned i = 0; i < clauses.size(); ++i) {
+            literal l = clauses[i];
+            if (l != null_literal) {
+                if (was_eliminated(l.var()))
+                    restore_var(l.var());
+                lits.push_back(l);
+                continue;
+            }
+            mk_clause_core(lits);
+            lits.reset();
+        }
+        m_model_is_current = false;
     }
 
     void solver::mk_clause(literal l1, literal l2) {
@@ -186,22 +248,34 @@ namespace sat {
         mk_clause(3, ls);
     }
 
-    void solver::del_clause(clause& c) {
+    void solver::del_clause(clause& c, bool enable_drat) {
         if (!c.is_learned()) m_stats.m_non_learned_generation++;
+        if (m_config.m_drat && enable_drat) m_drat.del(c);
         m_cls_allocator.del_clause(&c);
         m_stats.m_del_clause++;
     }
 
     clause * solver::mk_clause_core(unsigned num_lits, literal * lits, bool learned) {
         TRACE("sat", tout << "mk_clause: " << mk_lits_pp(num_lits, lits) << (learned?" learned":" aux") << "\n";);
+        bool simplified = false;
         if (!learned) {
+            unsigned old_num_lits = num_lits;
             bool keep = simplify_clause(num_lits, lits);
             TRACE("sat_mk_clause", tout << "mk_clause (after simp), keep: " << keep << "\n" << mk_lits_pp(num_lits, lits) << "\n";);
             if (!keep) {
                 return 0; // clause is equivalent to true.
             }
+            simplified = num_lits < old_num_lits;
             ++m_stats.m_non_learned_generation;
         }
+        // units are logged when they are assigned at the base level,
+        // input clauses are part of the problem.
+        if (m_config.m_drat && num_lits != 1 && (learned || simplified)) {
+            if (num_lits == 0)
+                m_drat.add();
+            else
+                m_drat.add(num_lits, lits);
+        }
 
         switch (num_lits) {
         case 0:
@@ -228,8 +302,8 @@ namespace sat {
                 m_clauses_to_reinit.push_back(clause_wrapper(l1, l2));
         }
         m_stats.m_mk_bin_clause++;
-        m_watches[(~l1).index()].push_back(watched(l2, learned));
-        m_watches[(~l2).index()].push_back(watched(l1, learned));
+        push_binary_watch(m_watches[(~l1).index()], watched(l2, learned));
+        push_binary_watch(m_watches[(~l2).index()], watched(l1, learned));
     }
 
     bool solver::propagate_bin_clause(literal l1, literal l2) {
@@ -499,13 +573,18 @@ namespace sat {
         m_inconsistent = true;
         m_conflict = c;
         m_not_l    = not_l;
+        if (m_config.m_drat && scope_lvl() == 0)
+            m_drat.add();
     }
 
     void solver::assign_core(literal l, justification j) {
         SASSERT(value(l) == l_undef);
         TRACE("sat_assign_core", tout << l << " " << j << " level: " << scope_lvl() << "\n";);
-        if (scope_lvl() == 0)
+        if (scope_lvl() == 0) {
             j = justification(); // erase justification for level 0
+            if (m_config.m_drat)
+                m_drat.add(l);
+        }
         m_assignment[l.index()]    = l_true;
         m_assignment[(~l).index()] = l_false;
         bool_var v = l.var();
@@ -570,8 +649,25 @@ namespace sat {
             m_asymm_branch.dec(wlist.size());
             m_probing.dec(wlist.size());
             watch_list::iterator it  = wlist.begin();
-            watch_list::iterator it2 = it;
             watch_list::iterator end = wlist.end();
+            // Binary watches are usually kept in a prefix of the watch list (see push_binary_watch).
+            // They are processed first, and conflicts are detected without touching clause memory.
+            // The prefix is not modified, so there is nothing to cleanup on a conflict.
+            for (; it != end && it->is_binary_clause(); ++it) {
+                l1 = it->get_literal();
+                switch (value(l1)) {
+                case l_false:
+                    set_conflict(justification(not_l), ~l1);
+                    return false;
+                case l_undef:
+                    m_stats.m_bin_propagate++;
+                    assign_core(l1, justification(not_l));
+                    break;
+                case l_true:
+                    break; // skip
+                }
+            }
+            watch_list::iterator it2 = it;
 #define CONFLICT_CLEANUP() {                    \
                 for (; it != end; ++it, ++it2)  \
                     *it2 = *it;                 \
@@ -618,6 +714,10 @@ namespace sat {
                     it2++;
                     break;
                 case watched::CLAUSE: {
+                    // load the next clause while this one is processed.
+                    if (it + 1 != end && (it + 1)->is_clause() && value((it + 1)->get_blocked_literal()) != l_true) {
+                        m_cls_allocator.prefetch((it + 1)->get_clause_offset());
+                    }
                     if (value(it->get_blocked_literal()) == l_true) {
                         TRACE("propagate_clause_bug", tout << "blocked literal " << it->get_blocked_literal() << "\n";
                               clause_offset cls_off = it->get_clause_offset();
@@ -720,13 +820,47 @@ namespace sat {
     // Search
     //
     // -----------------------
+    /**
+       \brief inprocessing is paid for by search: each call to check earns
+       inprocess.effort percent of the resource ticks it spent searching, and
+       simplification rounds consume the ticks they use.
+    */
+    struct solver::scoped_inprocess_budget {
+        solver& s;
+        uint64  m_start;
+        scoped_inprocess_budget(solver& s): s(s), m_start(s.m_rlimit.count()) {
+            s.m_inprocess_ticks = 0;
+        }
+        ~scoped_inprocess_budget() {
+            uint64 total = s.m_rlimit.count() - m_start;
+            uint64 search = total > s.m_inprocess_ticks ? total - s.m_inprocess_ticks : 0;
+            s.m_inprocess_budget += static_cast<int64>(search * s.m_config.m_inprocess_effort / 100);
+        }
+    };
+
+    bool solver::should_inprocess() const {
+        return
+            m_config.m_inprocess &&
+            !m_config.m_drat &&
+            m_inprocess_new_clauses > 0 &&
+            m_inprocess_budget >= 0;
+    }
+
     lbool solver::check(unsigned num_lits, literal const* lits) {
         pop_to_base_level();
         IF_VERBOSE(2, verbose_stream() << "(sat.sat-solver)\n";);
         SASSERT(scope_lvl() == 0);
-        if (m_config.m_num_parallel > 1 && !m_par) {
+        // the parallel solvers do not contribute to the DRAT proof.
+        if (m_config.m_num_parallel > 1 && !m_par && !m_config.m_drat) {
             return check_par(num_lits, lits);
         }
+        scoped_inprocess_budget _budget(*this);
+        if (should_inprocess()) {
+            // clauses were added since the last call: simplify before searching.
+            m_next_simplify = m_conflicts;
+            m_inprocess_new_clauses = 0;
+            m_stats.m_inprocess++;
+        }
 #ifdef CLONE_BEFORE_SOLVING
         if (m_mc.empty()) {
             m_clone = alloc(solver, m_params, 0 /* do not clone extension */);
@@ -796,12 +930,15 @@ namespace sat {
     };
 
     lbool solver::check_par(unsigned num_lits, literal const* lits) {
-        int num_threads = static_cast<int>(m_config.m_num_parallel);
-        int num_extra_solvers = num_threads - 1;
+        int num_local_search = static_cast<int>(m_config.m_local_search_threads);
+        int num_threads = static_cast<int>(m_config.m_num_parallel) + num_local_search;
+        int num_extra_solvers = num_threads - 1 - num_local_search;
+        int main_solver = num_extra_solvers;
         scoped_limits scoped_rlimit(rlimit());
-        vector<reslimit> rlims(num_extra_solvers);
+        vector<reslimit> rlims(num_extra_solvers + num_local_search);
         ptr_vector<sat::solver> solvers(num_extra_solvers);
-        sat::par par;
+        scoped_ptr_vector<local_search> local_searchers;
+        sat::par par(num_threads, m_config.m_par_buffer_size);
         symbol saved_phase = m_params.get_sym("phase", symbol("caching"));
         for (int i = 0; i < num_extra_solvers; ++i) {
             m_params.set_uint("random_seed", m_rand());
@@ -810,10 +947,20 @@ namespace sat {
             }
             solvers[i] = alloc(sat::solver, m_params, rlims[i], 0);
             solvers[i]->copy(*this);
-            solvers[i]->set_par(&par);
+            solvers[i]->set_par(&par, i);
             scoped_rlimit.push_child(&solvers[i]->rlimit());
         }
-        set_par(&par);
+        literal_vector fixed(num_lits, lits);
+        for (unsigned i = 0; i < m_user_scope_literals.size(); ++i) {
+            fixed.push_back(~m_user_scope_literals[i]);
+        }
+        for (int i = 0; i < num_local_search; ++i) {
+            reslimit& rl = rlims[num_extra_solvers + i];
+            local_searchers.push_back(alloc(local_search, rl, m_rand(), m_config.m_local_search_cb));
+            local_searchers[i]->import(*this, fixed);
+            scoped_rlimit.push_child(&rl);
+        }
+        set_par(&par, num_extra_solvers);
         m_params.set_sym("phase", saved_phase);
         int finished_id = -1;
         std::string        ex_msg;
@@ -827,9 +974,15 @@ namespace sat {
                 if (i < num_extra_solvers) {
                     r = solvers[i]->check(num_lits, lits);
                 }
-                else {
+                else if (i == main_solver) {
                     r = check(num_lits, lits);
                 }
+                else {
+                    // local search only contributes when it finds a model.
+                    if (l_true != local_searchers[i - main_solver - 1]->check(UINT_MAX))
+                        continue;
+                    r = l_true;
+                }
                 bool first = false;
                 #pragma omp critical (par_solver)
                 {
@@ -840,15 +993,10 @@ namespace sat {
                     }
                 }
                 if (first) {
-                    if (r == l_true && i < num_extra_solvers) {
-                        set_model(solvers[i]->get_model());
-                    }
-                    else if (r == l_false && i < num_extra_solvers) {
-                        m_core.reset();
-                        m_core.append(solvers[i]->get_core());
-                    }
-                    for (int j = 0; j < num_extra_solvers; ++j) {
-                        if (i != j) {
+                    // rlims has no entry for the main solver.
+                    int own = i < main_solver ? i : (i > main_solver ? i - 1 : -1);
+                    for (int j = 0; j < num_extra_solvers + num_local_search; ++j) {
+                        if (j != own) {
                             rlims[j].cancel();
                         }
                     }
@@ -867,9 +1015,24 @@ namespace sat {
                 }
             }
         }
-        set_par(0);
+        set_par(0, 0);
+        // the main solver may still be running when another thread wins,
+        // so its model, core and model converter are only touched after the join.
         if (finished_id != -1 && finished_id < num_extra_solvers) {
             m_stats = solvers[finished_id]->m_stats;
+            if (result == l_true) {
+                set_model(solvers[finished_id]->get_model());
+            }
+            else if (result == l_false) {
+                m_core.reset();
+                m_core.append(solvers[finished_id]->get_core());
+            }
+        }
+        else if (finished_id > main_solver && result == l_true) {
+            model mdl;
+            local_searchers[finished_id - main_solver - 1]->get_model(mdl);
+            m_mc(mdl);
+            set_model(mdl);
         }
 
         for (int i = 0; i < num_extra_solvers; ++i) {
@@ -916,8 +1079,64 @@ namespace sat {
         }
     }
 
-    void solver::set_par(par* p) {
+    /*
+      \brief export a learned clause to parallel sat solvers.
+      Binary clauses are always exported, longer clauses only if
+      they are short and have low glue.
+     */
+    void solver::share_par_clause(unsigned sz, literal const* lits, unsigned glue) {
+        if (!m_par || sz <= 1)
+            return;
+        if (sz > 2 && (sz > m_config.m_par_share_size || glue > m_config.m_par_share_lbd))
+            return;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (lits[i].var() >= m_par_num_vars)
+                return;
+        }
+        m_stats.m_par_clauses_out++;
+        m_par->share_clause(m_par_id, sz, lits);
+    }
+
+    /*
+      \brief import learned clauses exported by parallel sat solvers.
+      Clauses are simplified with respect to the units at the base level.
+      Clauses that use variables eliminated by this solver are skipped.
+     */
+    void solver::import_par_clauses() {
+        if (!m_par || scope_lvl() != 0 || inconsistent())
+            return;
+        m_par_lits.reset();
+        m_par_sizes.reset();
+        m_par->get_clauses(m_par_id, m_par_lits, m_par_sizes);
+        unsigned num_in = 0;
+        literal_vector lits;
+        literal const* ptr = m_par_lits.c_ptr();
+        for (unsigned i = 0; !inconsistent() && i < m_par_sizes.size(); ptr += m_par_sizes[i], ++i) {
+            unsigned sz = m_par_sizes[i];
+            bool keep = true;
+            lits.reset();
+            for (unsigned j = 0; keep && j < sz; ++j) {
+                literal lit = ptr[j];
+                SASSERT(lit.var() < m_par_num_vars);
+                if (was_eliminated(lit.var()) || value(lit) == l_true)
+                    keep = false;
+                else if (value(lit) == l_undef)
+                    lits.push_back(lit);
+            }
+            if (!keep)
+                continue;
+            ++num_in;
+            mk_clause_core(lits.size(), lits.c_ptr(), true);
+        }
+        m_stats.m_par_clauses_in += num_in;
+        if (num_in > 0) {
+            IF_VERBOSE(2, verbose_stream() << "(sat-sync clauses in: " << num_in << ")\n";);
+        }
+    }
+
+    void solver::set_par(par* p, unsigned id) {
         m_par = p;
+        m_par_id = id;
         m_par_num_vars = num_vars();
         m_par_limit_in = 0;
         m_par_limit_out = 0;
@@ -935,10 +1154,29 @@ namespace sat {
                 return next;
         }
 
-        while (!m_case_split_queue.empty()) {
-            next = m_case_split_queue.next_var();
-            if (value(next) == l_undef && !was_eliminated(next))
-                return next;
+        switch (m_branching) {
+        case BH_VSIDS:
+            while (!m_case_split_queue.empty()) {
+                next = m_case_split_queue.next_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+            }
+            break;
+        case BH_CHB:
+            while (!m_chb_queue.empty()) {
+                next = m_chb_queue.next_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+            }
+            break;
+        case BH_VMTF:
+            // variables after the search cursor are assigned.
+            next = m_vmtf.search();
+            while (next != null_bool_var && (value(next) != l_undef || was_eliminated(next)))
+                next = m_vmtf.prev(next);
+            if (next != null_bool_var)
+                m_vmtf.set_search(next);
+            return next;
         }
 
         return null_bool_var;
@@ -1169,6 +1407,7 @@ namespace sat {
         m_gc_threshold            = m_config.m_gc_initial;
         m_restarts                = 0;
         m_min_d_tk                = 1.0;
+        init_mode();
         m_stopwatch.reset();
         m_stopwatch.start();
         m_core.reset();
@@ -1186,6 +1425,7 @@ namespace sat {
             return;
         }
         IF_VERBOSE(2, verbose_stream() << "(sat.simplify)\n";);
+        uint64 start_ticks = m_rlimit.count();
 
         // Disable simplification during MUS computation.
         // if (m_mus.is_active()) return;
@@ -1231,6 +1471,10 @@ namespace sat {
 
         reinit_assumptions();
 
+        uint64 spent = m_rlimit.count() - start_ticks;
+        m_inprocess_ticks  += spent;
+        m_inprocess_budget -= static_cast<int64>(spent);
+
         if (m_next_simplify == 0) {
             m_next_simplify = m_config.m_restart_initial * m_config.m_simplify_mult1;
         }
@@ -1349,8 +1593,18 @@ namespace sat {
                    << " :time " << std::fixed << std::setprecision(2) << m_stopwatch.get_current_seconds() << ")\n";);
         IF_VERBOSE(30, display_status(verbose_stream()););
         pop_reinit(scope_lvl());
+        import_par_clauses();
+        if (m_config.m_local_search && m_restarts % m_config.m_local_search_restarts == 0)
+            do_local_search();
         m_conflicts_since_restart = 0;
-        switch (m_config.m_restart) {
+        if (m_config.m_branching_mode == BM_SWITCH && m_conflicts >= m_next_mode_switch) {
+            switch_mode();
+        }
+        else if (!m_stable) {
+            // focused mode restarts at a short fixed interval.
+            m_restart_threshold = m_config.m_restart_initial;
+        }
+        else switch (m_config.m_restart) {
         case RS_GEOMETRIC:
             m_restart_threshold = static_cast<unsigned>(m_restart_threshold * m_config.m_restart_factor);
             break;
@@ -1365,6 +1619,33 @@ namespace sat {
         CASSERT("sat_restart", check_invariant());
     }
 
+    /**
+       \brief run a round of local search over the current clauses.
+       Assumptions are kept fixed. The best assignment found becomes the saved phase,
+       so the next decisions follow it.
+    */
+    void solver::do_local_search() {
+        if (inconsistent())
+            return;
+        if (!m_local_search)
+            m_local_search = alloc(local_search, m_rlimit, m_rand(), m_config.m_local_search_cb);
+        literal_vector fixed;
+        if (tracking_assumptions()) {
+            fixed.append(m_assumptions);
+            for (unsigned i = 0; i < m_user_scope_literals.size(); ++i)
+                fixed.push_back(~m_user_scope_literals[i]);
+        }
+        m_local_search->import(*this, fixed);
+        lbool r = m_local_search->check(m_config.m_local_search_flips);
+        if (r == l_false)
+            return;
+        for (bool_var v = 0; v < num_vars(); ++v) {
+            if (!was_eliminated(v) && value(v) == l_undef)
+                m_phase[v] = m_local_search->best_phase(v) ? POS_PHASE : NEG_PHASE;
+        }
+        IF_VERBOSE(1, verbose_stream() << "(sat-local-search :unsat " << m_local_search->best_unsat() << ")\n";);
+    }
+
     // -----------------------
     //
     // GC
@@ -1393,15 +1674,77 @@ namespace sat {
                 return;
             gc_dyn_psm();
             break;
+        case GC_TIERED:
+            gc_tiered();
+            break;
         default:
             UNREACHABLE();
             break;
         }
+        compact_clauses();
         m_conflicts_since_gc = 0;
         m_gc_threshold += m_config.m_gc_increment;
         CASSERT("sat_gc_bug", check_invariant());
     }
 
+    /**
+       \brief copy the live clauses into a fresh arena and relocate the
+       references to them: watches, justifications, the reinit stack and
+       the clause vectors.
+
+       Clauses are copied in the order of the watch lists, so that
+       clauses watched by the same literal are adjacent in memory.
+       Clauses that are not watched (e.g., frozen clauses) follow.
+    */
+    void solver::compact_clauses() {
+        size_t old_words = m_cls_allocator.num_words();
+        m_cls_allocator.begin_compaction();
+        vector<watch_list>::iterator it  = m_watches.begin();
+        vector<watch_list>::iterator end = m_watches.end();
+        for (; it != end; ++it) {
+            watch_list::iterator it2  = it->begin();
+            watch_list::iterator end2 = it->end();
+            for (; it2 != end2; ++it2) {
+                if (it2->is_clause()) {
+                    clause * c = m_cls_allocator.move_clause(m_cls_allocator.get_old_clause(it2->get_clause_offset()));
+                    it2->set_clause_offset(get_offset(*c));
+                }
+            }
+        }
+        for (unsigned i = 0; i < m_clauses.size(); ++i) {
+            m_clauses[i] = m_cls_allocator.move_clause(m_clauses[i]);
+        }
+        for (unsigned i = 0; i < m_learned.size(); ++i) {
+            m_learned[i] = m_cls_allocator.move_clause(m_learned[i]);
+        }
+        for (unsigned i = 0; i < m_clauses_to_reinit.size(); ++i) {
+            clause_wrapper & cw = m_clauses_to_reinit[i];
+            if (!cw.is_binary()) {
+                clause * c = m_cls_allocator.relocate(cw.get_clause());
+                SASSERT(c);
+                cw = clause_wrapper(*c);
+            }
+        }
+        // justifications of unassigned variables are stale; they are reset.
+        // assigned variables justified by deleted clauses are at the base level.
+        for (bool_var v = 0; v < num_vars(); ++v) {
+            justification & js = m_justification[v];
+            if (!js.is_clause())
+                continue;
+            clause_offset cls_off = js.get_clause_offset();
+            if (value(v) != l_undef && m_cls_allocator.relocate(cls_off)) {
+                js = justification(cls_off);
+            }
+            else {
+                SASSERT(value(v) == l_undef || lvl(v) == 0);
+                js = justification();
+            }
+        }
+        m_cls_allocator.end_compaction();
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :compact " << old_words << " -> "
+                   << m_cls_allocator.num_words() << " words)\n";);
+    }
+
     /**
        \brief Lex on (glue, size)
     */
@@ -1603,6 +1946,96 @@ namespace sat {
                    " :frozen " << frozen << " :activated " << activated << " :deleted " << deleted << ")\n";);
     }
 
+    /**
+       \brief Order on local learned clauses: clauses used since the last gc
+       come first, then lex on (glue, size).
+    */
+    struct tiered_lt {
+        bool operator()(clause const * c1, clause const * c2) const {
+            bool u1 = c1->inact_rounds() == 0;
+            bool u2 = c2->inact_rounds() == 0;
+            if (u1 != u2) return u1;
+            if (c1->glue() < c2->glue()) return true;
+            return c1->glue() == c2->glue() && c1->size() < c2->size();
+        }
+    };
+
+    /**
+       \brief Three tier management of learned clauses.
+
+       - core:  clauses with glue <= gc.core_lbd are kept.
+       - tier2: clauses with glue <= gc.tier2_lbd are kept as long as they are
+                used in conflicts between two gc rounds, otherwise they are
+                demoted to the local tier.
+       - local: the worse half of the remaining clauses is deleted.
+
+       Clauses are promoted to a better tier when their glue is
+       reduced in conflict analysis (see bump_learned).
+    */
+    void solver::gc_tiered() {
+        TRACE("sat", tout << "gc\n";);
+        unsigned sz = m_learned.size();
+        unsigned j  = 0;
+        unsigned num_core = 0, num_tier2 = 0;
+        clause_vector local;
+        for (unsigned i = 0; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (c.glue() <= m_config.m_gc_core_lbd) {
+                num_core++;
+                m_learned[j++] = &c;
+            }
+            else if (c.glue() <= m_config.m_gc_tier2_lbd && c.inact_rounds() == 0) {
+                num_tier2++;
+                m_learned[j++] = &c;
+            }
+            else {
+                if (c.glue() <= m_config.m_gc_tier2_lbd) {
+                    c.set_glue(m_config.m_gc_tier2_lbd + 1);
+                    m_stats.m_demoted_clause++;
+                }
+                local.push_back(&c);
+            }
+        }
+        std::stable_sort(local.begin(), local.end(), tiered_lt());
+        unsigned num_keep = local.size() / 2;
+        for (unsigned i = 0; i < local.size(); i++) {
+            clause & c = *(local[i]);
+            if (i >= num_keep && can_delete(c)) {
+                detach_clause(c);
+                del_clause(c);
+                m_stats.m_gc_clause++;
+            }
+            else {
+                m_learned[j++] = &c;
+            }
+        }
+        m_learned.shrink(j);
+        for (unsigned i = 0; i < j; i++) {
+            clause & c = *(m_learned[i]);
+            if (c.inact_rounds() < 255)
+                c.inc_inact_rounds();
+        }
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tiered :core " << num_core << " :tier2 " << num_tier2
+                   << " :local " << (j - num_core - num_tier2) << " :deleted " << (sz - j) << ")\n";);
+    }
+
+    /**
+       \brief c is used in conflict analysis.
+       Mark it as active for the tiered gc, and recompute its glue.
+       The clause is promoted if its glue decreases.
+    */
+    void solver::bump_learned(clause & c) {
+        c.reset_inact_rounds();
+        if (c.glue() <= m_config.m_gc_core_lbd)
+            return;
+        unsigned glue = num_diff_levels(c.size(), c.begin());
+        if (glue < c.glue()) {
+            if ((glue <= m_config.m_gc_core_lbd) || (glue <= m_config.m_gc_tier2_lbd && c.glue() > m_config.m_gc_tier2_lbd))
+                m_stats.m_promoted_clause++;
+            c.set_glue(glue);
+        }
+    }
+
     // return true if should keep the clause, and false if we should delete it.
     bool solver::activate_frozen_clause(clause & c) {
         TRACE("sat_gc", tout << "reactivating:\n" << c << "\n";);
@@ -1618,7 +2051,8 @@ namespace sat {
             case l_false:
                 break;
             case l_undef:
-                c[j] = c[i];
+                // swap, so that the literals of c are preserved for del_clause.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
@@ -1633,9 +2067,14 @@ namespace sat {
             assign(c[0], justification());
             return false;
         case 2:
+            if (m_config.m_drat) m_drat.add(c[0], c[1]);
             mk_bin_clause(c[0], c[1], true);
             return false;
         default:
+            if (m_config.m_drat && new_sz < sz) {
+                m_drat.add(new_sz, c.begin());
+                m_drat.del(c);
+            }
             c.shrink(new_sz);
             attach_clause(c);
             return true;
@@ -1698,6 +2137,8 @@ namespace sat {
         }
 
         if (m_conflict_lvl == 0) {
+            if (m_config.m_drat)
+                m_drat.add();
             return false;
         }
 
@@ -1733,6 +2174,8 @@ namespace sat {
                 break;
             case justification::CLAUSE: {
                 clause & c = *(m_cls_allocator.get_clause(js.get_clause_offset()));
+                if (c.is_learned() && m_config.m_gc_strategy == GC_TIERED)
+                    bump_learned(c);
                 unsigned i   = 0;
                 if (consequent != null_literal) {
                     SASSERT(c[0] == consequent || c[1] == consequent);
@@ -1810,6 +2253,7 @@ namespace sat {
         if (lemma) {
             lemma->set_glue(glue);
         }
+        share_par_clause(m_lemma.size(), m_lemma.c_ptr(), glue);
         decay_activity();
         updt_phase_counters();
         return true;
@@ -1880,6 +2324,8 @@ namespace sat {
 
     bool solver::resolve_conflict_for_init() {
         if (m_conflict_lvl == 0) {
+            if (m_config.m_drat)
+                m_drat.add();
             return false;
         }
         m_lemma.reset();
@@ -2453,8 +2899,9 @@ namespace sat {
                     break;
                 }
             }
-            // try to use cached implication if available
-            literal_vector * implied_lits = m_probing.cached_implied_lits(~l);
+            // try to use cached implication if available.
+            // cached implications are not in the clause database of DRAT proofs.
+            literal_vector * implied_lits = m_config.m_drat ? 0 : m_probing.cached_implied_lits(~l);
             if (implied_lits) {
                 literal_vector::iterator it  = implied_lits->begin();
                 literal_vector::iterator end = implied_lits->end();
@@ -2572,7 +3019,11 @@ namespace sat {
             m_assignment[(~l).index()] = l_undef;
             bool_var v = l.var();
             SASSERT(value(v) == l_undef);
-            m_case_split_queue.unassign_var_eh(v);
+            switch (m_branching) {
+            case BH_VSIDS: m_case_split_queue.unassign_var_eh(v); break;
+            case BH_CHB:   m_chb_queue.unassign_var_eh(v); break;
+            case BH_VMTF:  m_vmtf.unassign_var_eh(v); break;
+            }
         }
         m_trail.shrink(old_sz);
         m_qhead = old_sz;
@@ -2621,6 +3072,7 @@ namespace sat {
         bool_var new_v = mk_var(true, false);
         lit = literal(new_v, false);
         m_user_scope_literals.push_back(lit);
+        m_user_scope_mc_lim.push_back(m_mc.size());
         TRACE("sat", tout << "user_push: " << lit << "\n";);
     }
 
@@ -2694,6 +3146,8 @@ namespace sat {
         if (v < m_level.size()) {
             for (bool_var i = v; i < m_level.size(); ++i) {
                 m_case_split_queue.del_var_eh(i);
+                m_chb_queue.del_var_eh(i);
+                m_vmtf.del_var_eh(i);
             }
             m_watches.shrink(2*v);
             m_assignment.shrink(2*v);
@@ -2702,6 +3156,8 @@ namespace sat {
             m_eliminated.shrink(v);
             m_external.shrink(v);
             m_activity.shrink(v);
+            m_chb.shrink(v);
+            m_chb_last_conflict.shrink(v);
             m_level.shrink(v);
             m_mark.shrink(v);
             m_lit_mark.shrink(2*v);
@@ -2715,6 +3171,12 @@ namespace sat {
     void solver::user_pop(unsigned num_scopes) {
         pop_to_base_level();
         while (num_scopes > 0) {
+            // variables eliminated in the scope may have clauses with lit in the model converter.
+            unsigned mc_lim = m_user_scope_mc_lim.back();
+            m_user_scope_mc_lim.pop_back();
+            while (m_mc.size() > mc_lim) {
+                restore_var(m_mc.last_var());
+            }
             literal lit = m_user_scope_literals.back();
             m_user_scope_literals.pop_back();
             get_wlist(lit).reset();
@@ -2751,6 +3213,8 @@ namespace sat {
     void solver::updt_params(params_ref const & p) {
         m_params = p;
         m_config.updt_params(p);
+        if (m_config.m_drat && !m_drat.is_open())
+            m_drat.open(m_config.m_drat_file.bare_str(), m_config.m_drat_binary);
         m_simplifier.updt_params(p);
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
@@ -2773,6 +3237,7 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        if (m_local_search) m_local_search->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
@@ -2798,6 +3263,124 @@ namespace sat {
         m_activity_inc >>= 14;
     }
 
+    /**
+       \brief bump a variable that participates in conflict analysis
+       when vmtf or chb is used.
+       - vmtf: the variable is moved to the front of the queue when the
+         analysis is complete, see decay_var_scores.
+       - chb: the score is moved towards the reward 1/(k+1), where k is the
+         number of conflicts since the variable last participated in a conflict.
+    */
+    void solver::bump_var(bool_var v) {
+        switch (m_branching) {
+        case BH_VMTF:
+            m_vmtf_bumped.push_back(v);
+            break;
+        case BH_CHB: {
+            double reward = 1.0 / (m_conflicts - m_chb_last_conflict[v] + 1);
+            double old_score = m_chb[v];
+            m_chb[v] = (1.0 - m_chb_alpha) * old_score + m_chb_alpha * reward;
+            m_chb_last_conflict[v] = m_conflicts;
+            if (m_chb[v] >= old_score)
+                m_chb_queue.activity_increased_eh(v);
+            else
+                m_chb_queue.activity_decreased_eh(v);
+            break;
+        }
+        default:
+            UNREACHABLE();
+            break;
+        }
+    }
+
+    struct vmtf_stamp_lt {
+        vmtf_queue const& m_vmtf;
+        vmtf_stamp_lt(vmtf_queue const& q): m_vmtf(q) {}
+        bool operator()(bool_var v1, bool_var v2) const { return m_vmtf.stamp(v1) < m_vmtf.stamp(v2); }
+    };
+
+    void solver::decay_var_scores() {
+        switch (m_branching) {
+        case BH_VMTF:
+            // move bumped variables to the front, preserving their relative order.
+            std::sort(m_vmtf_bumped.begin(), m_vmtf_bumped.end(), vmtf_stamp_lt(m_vmtf));
+            for (bool_var v : m_vmtf_bumped) {
+                m_vmtf.bump(v, value(v) == l_undef && !was_eliminated(v));
+            }
+            m_vmtf_bumped.reset();
+            break;
+        case BH_CHB:
+            if (m_chb_alpha > 0.06)
+                m_chb_alpha -= 1e-6;
+            break;
+        default:
+            UNREACHABLE();
+            break;
+        }
+    }
+
+    template<typename Q>
+    static void rebuild_queue(solver const& s, Q& q) {
+        q.reset();
+        for (bool_var v = 0; v < s.num_vars(); ++v) {
+            if (s.value(v) == l_undef && !s.was_eliminated(v))
+                q.mk_var_eh(v);
+        }
+    }
+
+    /**
+       \brief switch the branching heuristic to h.
+       The queue of h is rebuilt from the unassigned variables, since
+       it is not maintained while another heuristic is used.
+    */
+    void solver::set_branching(branching_heuristic h) {
+        if (h == m_branching)
+            return;
+        m_branching = h;
+        m_vmtf_bumped.reset();
+        switch (h) {
+        case BH_VSIDS:
+            rebuild_queue(*this, m_case_split_queue);
+            break;
+        case BH_CHB:
+            rebuild_queue(*this, m_chb_queue);
+            break;
+        case BH_VMTF:
+            m_vmtf.reset_search();
+            break;
+        }
+    }
+
+    void solver::init_mode() {
+        m_stable           = m_config.m_branching_mode != BM_FOCUSED;
+        m_mode_length      = m_config.m_branching_mode_conflicts;
+        m_next_mode_switch = m_conflicts + m_mode_length;
+        if (m_config.m_branching_mode == BM_SWITCH)
+            m_stable = false; // start in focused mode
+        m_chb_alpha = m_config.m_chb_alpha;
+        set_branching(m_stable ? m_config.m_branching_heuristic : BH_VMTF);
+    }
+
+    /**
+       \brief alternate between focused mode (vmtf, frequent restarts) and
+       stable mode (branching.heuristic, luby or geometric restarts).
+       The mode lengths double after every stable mode.
+       Only heuristic state changes, so the scopes of assumptions and
+       user scopes that a restart keeps may be open.
+    */
+    void solver::switch_mode() {
+        if (m_stable)
+            m_mode_length *= 2;
+        m_stable = !m_stable;
+        m_next_mode_switch = m_conflicts + m_mode_length;
+        m_stats.m_mode_switch++;
+        m_luby_idx = 1;
+        m_restart_threshold = m_config.m_restart_initial;
+        set_branching(m_stable ? m_config.m_branching_heuristic : BH_VMTF);
+        IF_VERBOSE(2, verbose_stream() << "(sat.mode " << (m_stable ? "stable" : "focused")
+                   << " :conflicts " << m_conflicts << " :length " << m_mode_length << ")\n";);
+    }
+
     // -----------------------
     //
     // Iterators
@@ -3717,6 +4300,13 @@ namespace sat {
         st.update("minimized lits", m_minimized_lits);
         st.update("dyn subsumption resolution", m_dyn_sub_res);
         st.update("blocked correction sets", m_blocked_corr_sets);
+        st.update("shared clauses out", m_par_clauses_out);
+        st.update("shared clauses in", m_par_clauses_in);
+        st.update("promoted clauses", m_promoted_clause);
+        st.update("mode switches", m_mode_switch);
+        st.update("demoted clauses", m_demoted_clause);
+        st.update("inprocess rounds", m_inprocess);
+        st.update("restored vars", m_restored_vars);
     }
 
     void stats::reset() {
@@ -3733,9 +4323,16 @@ namespace sat {
         m_gc_clause = 0;
         m_del_clause = 0;
         m_minimized_lits = 0;
+        m_inprocess = 0;
+        m_restored_vars = 0;
         m_dyn_sub_res = 0;
         m_non_learned_generation = 0;
         m_blocked_corr_sets = 0;
+        m_par_clauses_out = 0;
+        m_par_clauses_in = 0;
+        m_promoted_clause = 0;
+        m_mode_switch = 0;
+        m_demoted_clause = 0;
     }
 
     void mk_stat::display(std::ostream & out) const {
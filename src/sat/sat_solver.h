@@ -34,6 +34,8 @@ Revision History:
 #include "sat/sat_probing.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_par.h"
+#include "sat/sat_local_search.h"
+#include "sat/sat_drat.h"
 #include "util/params.h"
 #include "util/statistics.h"
 #include "util/stopwatch.h"
@@ -62,6 +64,13 @@ namespace sat {
         unsigned m_dyn_sub_res;
         unsigned m_non_learned_generation;
         unsigned m_blocked_corr_sets;
+        unsigned m_par_clauses_out;
+        unsigned m_par_clauses_in;
+        unsigned m_promoted_clause;
+        unsigned m_mode_switch;
+        unsigned m_inprocess;
+        unsigned m_restored_vars;
+        unsigned m_demoted_clause;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -79,6 +88,7 @@ namespace sat {
         par*                    m_par;
         random_gen              m_rand;
         clause_allocator        m_cls_allocator;
+        drat                    m_drat;
         cleaner                 m_cleaner;
         model                   m_model;        
         model_converter         m_mc;
@@ -114,6 +124,16 @@ namespace sat {
         bool                    m_phase_cache_on;
         unsigned                m_phase_counter; 
         var_queue               m_case_split_queue;
+        // chb (conflict history based branching)
+        svector<double>         m_chb;
+        unsigned_vector         m_chb_last_conflict;
+        double                  m_chb_alpha;
+        var_queue_t<double>     m_chb_queue;
+        // vmtf (variable move-to-front)
+        vmtf_queue              m_vmtf;
+        bool_var_vector         m_vmtf_bumped;
+        branching_heuristic     m_branching;   // heuristic in use
+        bool                    m_stable;      // stable or focused mode
         unsigned                m_qhead;
         unsigned                m_scope_lvl;
         literal_vector          m_trail;
@@ -131,9 +151,14 @@ namespace sat {
         literal_set             m_assumption_set;   // set of enabled assumptions
         literal_vector          m_core;             // unsat core
 
+        scoped_ptr<local_search> m_local_search;
+
+        unsigned                m_par_id;
         unsigned                m_par_limit_in;
         unsigned                m_par_limit_out;
         unsigned                m_par_num_vars;
+        literal_vector          m_par_lits;
+        unsigned_vector         m_par_sizes;
 
         void del_clauses(clause * const * begin, clause * const * end);
 
@@ -146,6 +171,8 @@ namespace sat {
         friend class probing;
         friend class iff3_finder;
         friend class mus;
+        friend class lookahead;
+        friend class local_search;
         friend struct mk_stat;
     public:
         solver(params_ref const & p, reslimit& l, extension * ext);
@@ -183,7 +210,7 @@ namespace sat {
         void mk_clause(literal l1, literal l2, literal l3);
 
     protected:
-        void del_clause(clause & c);
+        void del_clause(clause & c, bool enable_drat = true);
         clause * mk_clause_core(unsigned num_lits, literal * lits, bool learned);
         void mk_clause_core(literal_vector const& lits) { mk_clause_core(lits.size(), lits.c_ptr()); }
         void mk_clause_core(unsigned num_lits, literal * lits) { mk_clause_core(num_lits, lits, false); }
@@ -247,7 +274,7 @@ namespace sat {
         unsigned num_clauses() const;
         unsigned num_restarts() const { return m_restarts; }
         bool is_external(bool_var v) const { return m_external[v] != 0; }
-        void set_external(bool_var v) { m_external[v] = true; }
+        void set_external(bool_var v);
         bool was_eliminated(bool_var v) const { return m_eliminated[v] != 0; }
         unsigned scope_lvl() const { return m_scope_lvl; }
         lbool value(literal l) const { return static_cast<lbool>(m_assignment[l.index()]); }
@@ -280,7 +307,7 @@ namespace sat {
             m_num_checkpoints = 0;
             if (memory::get_allocation_size() > m_config.m_max_memory) throw solver_exception(Z3_MAX_MEMORY_MSG);
         }
-        void set_par(par* p);
+        void set_par(par* p, unsigned id);
         bool canceled() { return !m_rlimit.inc(); }
         config const& get_config() { return m_config; }
         typedef std::pair<literal, literal> bin_clause;
@@ -329,17 +356,28 @@ namespace sat {
         unsigned m_conflicts_since_restart;
         unsigned m_restart_threshold;
         unsigned m_luby_idx;
+        unsigned m_mode_length;
+        unsigned m_next_mode_switch;
         unsigned m_conflicts_since_gc;
         unsigned m_gc_threshold;
         unsigned m_num_checkpoints;
         double   m_min_d_tk;
         unsigned m_next_simplify;
+        // incremental inprocessing
+        int64    m_inprocess_budget;     // in resource limit ticks
+        uint64   m_inprocess_ticks;      // ticks spent on simplification in the current call
+        unsigned m_inprocess_new_clauses;
+        struct scoped_inprocess_budget;
+        bool should_inprocess() const;
         bool decide();
         bool_var next_var();
         lbool bounded_search();
         lbool final_check();
         lbool propagate_and_backjump_step(bool& done);
         void init_search();
+        void init_mode();
+        void switch_mode();
+        void set_branching(branching_heuristic h);
         
         literal_vector m_min_core;
         bool           m_min_core_valid;
@@ -357,8 +395,11 @@ namespace sat {
         void mk_model();
         bool check_model(model const & m) const;
         void restart();
+        void do_local_search();
         void sort_watch_lits();
         void exchange_par();
+        void share_par_clause(unsigned sz, literal const* lits, unsigned glue);
+        void import_par_clauses();
         lbool check_par(unsigned num_lits, literal const* lits);
 
         // -----------------------
@@ -368,6 +409,7 @@ namespace sat {
         // -----------------------
     protected:
         void gc();
+        void compact_clauses();
         void gc_glue();
         void gc_psm();
         void gc_glue_psm();
@@ -375,6 +417,8 @@ namespace sat {
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
+        void gc_tiered();
+        void bump_learned(clause & c);
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
         bool can_delete(clause const & c) const {
@@ -441,6 +485,8 @@ namespace sat {
         void reinit_clauses(unsigned old_sz);
 
         literal_vector m_user_scope_literals;
+        unsigned_vector m_user_scope_mc_lim;   // size of the model converter at user_push
+        void restore_var(bool_var v);
         literal_vector m_aux_literals;
         svector<bin_clause> m_user_bin_clauses;
         void gc_lit(clause_vector& clauses, literal lit);
@@ -515,6 +561,10 @@ namespace sat {
         // -----------------------
     public:
         void inc_activity(bool_var v) {
+            if (m_branching != BH_VSIDS) {
+                bump_var(v);
+                return;
+            }
             unsigned & act = m_activity[v];
             act += m_activity_inc;
             m_case_split_queue.activity_increased_eh(v);
@@ -523,12 +573,18 @@ namespace sat {
         }
 
         void decay_activity() {
+            if (m_branching != BH_VSIDS) {
+                decay_var_scores();
+                return;
+            }
             m_activity_inc *= 11;
             m_activity_inc /= 10;
         }
 
     private:
         void rescale_activity();
+        void bump_var(bool_var v);
+        void decay_var_scores();
 
         // -----------------------
         //
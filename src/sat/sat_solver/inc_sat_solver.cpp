@@ -20,6 +20,8 @@ Notes:
 #include "solver/solver.h"
 #include "tactic/tactical.h"
 #include "sat/sat_solver.h"
+#include "sat/sat_lookahead.h"
+#include "sat/sat_params.hpp"
 #include "solver/tactic2solver.h"
 #include "tactic/aig/aig_tactic.h"
 #include "tactic/core/propagate_values_tactic.h"
@@ -34,6 +36,7 @@ Notes:
 #include "tactic/bv/bit_blaster_model_converter.h"
 #include "ast/ast_translation.h"
 #include "ast/ast_util.h"
+#include "util/scoped_ptr_vector.h"
 #include "tactic/core/propagate_values_tactic.h"
 
 // incremental SAT solver.
@@ -43,6 +46,7 @@ class inc_sat_solver : public solver {
     goal2sat        m_goal2sat;
     params_ref      m_params;
     bool            m_optimize_model; // parameter
+    bool            m_inprocess;      // parameter: variables may be eliminated between calls
     expr_ref_vector m_fmls;
     expr_ref_vector m_asmsf;
     unsigned_vector m_fmls_lim;
@@ -63,13 +67,14 @@ class inc_sat_solver : public solver {
     expr_dependency_ref m_dep_core;
     svector<double>     m_weights;
     std::string         m_unknown;
+    statistics          m_cube_stats;
 
 
     typedef obj_map<expr, sat::literal> dep2asm_t;
 public:
     inc_sat_solver(ast_manager& m, params_ref const& p):
         m(m), m_solver(p, m.limit(), 0),
-        m_params(p), m_optimize_model(false),
+        m_params(p), m_optimize_model(false), m_inprocess(false),
         m_fmls(m),
         m_asmsf(m),
         m_fmls_head(0),
@@ -78,8 +83,7 @@ public:
         m_num_scopes(0),
         m_dep_core(m),
         m_unknown("no reason given") {
-        m_params.set_bool("elim_vars", false);
-        m_solver.updt_params(m_params);
+        updt_solver_params();
         init_preprocess();
     }
 
@@ -162,7 +166,13 @@ public:
         r = internalize_assumptions(sz, _assumptions.c_ptr(), dep2asm);
         if (r != l_true) return r;
 
-        r = m_solver.check(m_asms.size(), m_asms.c_ptr());
+        // the cube workers do not contribute to the DRAT proof
+        if (m_solver.get_config().m_mode == sat::SM_CUBE && m_asms.empty() && !m_solver.get_config().m_drat) {
+            r = check_cubes();
+        }
+        else {
+            r = m_solver.check(m_asms.size(), m_asms.c_ptr());
+        }
 
         switch (r) {
         case l_true:
@@ -234,13 +244,13 @@ public:
     }
     virtual void updt_params(params_ref const & p) {
         m_params = p;
-        m_params.set_bool("elim_vars", false);
-        m_solver.updt_params(m_params);
+        updt_solver_params();
         m_optimize_model = m_params.get_bool("optimize_model", false);
     }
     virtual void collect_statistics(statistics & st) const {
         if (m_preprocess) m_preprocess->collect_statistics(st);
         m_solver.collect_statistics(st);
+        st.copy(m_cube_stats);
     }
     virtual void get_unsat_core(ptr_vector<expr> & r) {
         r.reset();
@@ -270,6 +280,9 @@ public:
         if (r != l_true) return r;
         r = internalize_vars(vars, bvars);
         if (r != l_true) return r;
+        for (unsigned i = 0; i < bvars.size(); ++i) {
+            m_solver.set_external(bvars[i]);
+        }
         r = internalize_assumptions(assumptions.size(), assumptions.c_ptr(), dep2asm);
         if (r != l_true) return r;
         r = m_solver.get_consequences(m_asms, bvars, lconseq);
@@ -301,6 +314,7 @@ public:
     }
 
     virtual lbool find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes) {
+        m_solver.pop_to_base_level();
         sat::literal_vector ls;
         u_map<expr*> lit2var;
         for (unsigned i = 0; i < vars.size(); ++i) {
@@ -309,6 +323,7 @@ public:
             sat::bool_var v = m_map.to_bool_var(e);
             if (v != sat::null_bool_var) {
                 sat::literal lit(v, neg);
+                m_solver.set_external(v);
                 ls.push_back(lit);
                 lit2var.insert(lit.index(), vars[i]);
             }
@@ -380,8 +395,117 @@ public:
 
 private:
 
+    /**
+       \brief cube and conquer: split the clauses into cubes using the
+       lookahead solver, then solve the cubes using copies of m_solver
+       running in parallel threads. The first cube that is satisfiable
+       (or whose outcome is unknown) determines the result.
+    */
+    lbool check_cubes() {
+        m_solver.pop_to_base_level();
+        if (m_solver.inconsistent()) return l_false;
+        vector<sat::literal_vector> cubes;
+        sat::lookahead lh(m_solver);
+        lbool r = lh.cube(cubes);
+        m_cube_stats.reset();
+        lh.collect_statistics(m_cube_stats);
+        if (r == l_false) return l_false;
+        return conquer_cubes(cubes);
+    }
+
+    lbool conquer_cubes(vector<sat::literal_vector> const& cubes) {
+        unsigned num_cubes = cubes.size();
+        int num_threads = static_cast<int>(std::max(1u, std::min(m_solver.get_config().m_num_parallel, num_cubes)));
+        params_ref p(m_params);
+        p.set_uint("parallel_threads", 1);
+        // workers must not overwrite the DRAT proof of m_solver.
+        p.set_sym("drat.file", symbol(""));
+        scoped_limits scoped_rlimit(m.limit());
+        vector<reslimit> rlims(num_threads);
+        scoped_ptr_vector<sat::solver> workers;
+        for (int i = 0; i < num_threads; ++i) {
+            p.set_uint("random_seed", i);
+            workers.push_back(alloc(sat::solver, p, rlims[i], 0));
+            workers[i]->copy(m_solver);
+            scoped_rlimit.push_child(&rlims[i]);
+        }
+        unsigned next_cube = 0;
+        int finished_id = -1;
+        lbool result = l_false;
+        std::string ex_msg;
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                while (true) {
+                    unsigned idx = num_cubes;
+                    #pragma omp critical (inc_sat_cube)
+                    {
+                        if (finished_id == -1) idx = next_cube++;
+                    }
+                    if (idx >= num_cubes) break;
+                    sat::literal_vector const& cube = cubes[idx];
+                    lbool r = workers[i]->check(cube.size(), cube.c_ptr());
+                    IF_VERBOSE(2, verbose_stream() << "(sat.cube :worker " << i << " :cube " << idx << " " << r << ")\n";);
+                    if (r == l_false) continue;
+                    bool first = false;
+                    #pragma omp critical (inc_sat_cube)
+                    {
+                        if (finished_id == -1) {
+                            finished_id = i;
+                            result = r;
+                            first = true;
+                        }
+                    }
+                    if (first) {
+                        for (int j = 0; j < num_threads; ++j) {
+                            if (i != j) rlims[j].cancel();
+                        }
+                    }
+                    break;
+                }
+            }
+            catch (z3_exception & ex) {
+                bool first = false;
+                #pragma omp critical (inc_sat_cube)
+                {
+                    if (finished_id == -1) {
+                        finished_id = i;
+                        result = l_undef;
+                        ex_msg = ex.msg();
+                        first = true;
+                    }
+                }
+                if (first) {
+                    for (int j = 0; j < num_threads; ++j) {
+                        if (i != j) rlims[j].cancel();
+                    }
+                }
+            }
+        }
+        if (result == l_true) {
+            // worker models are over the clauses of m_solver,
+            // variables eliminated by m_solver are fixed using its model converter.
+            sat::model mdl(workers[finished_id]->get_model());
+            m_solver.get_model_converter()(mdl);
+            m_solver.set_model(mdl);
+        }
+        else if (result == l_undef && !ex_msg.empty()) {
+            set_reason_unknown(ex_msg.c_str());
+        }
+        return result;
+    }
+
+    void updt_solver_params() {
+        m_solver.updt_params(m_params);
+        // without inprocessing every variable is frozen, so elimination is pointless.
+        m_inprocess = m_solver.get_config().m_inprocess;
+        if (!m_inprocess) {
+            m_params.set_bool("elim_vars", false);
+            m_solver.updt_params(m_params);
+        }
+    }
 
-    lbool internalize_goal(goal_ref& g, dep2asm_t& dep2asm) {
+    lbool internalize_goal(goal_ref& g, dep2asm_t& dep2asm, bool default_external = true) {
         m_mc.reset();
         m_pc.reset();
         m_dep_core.reset();
@@ -407,7 +531,7 @@ private:
         g = m_subgoals[0];
         expr_ref_vector atoms(m);
         TRACE("sat", g->display_with_dependencies(tout););
-        m_goal2sat(*g, m_params, m_solver, m_map, dep2asm, true);
+        m_goal2sat(*g, m_params, m_solver, m_map, dep2asm, default_external);
         m_goal2sat.get_interpreted_atoms(atoms);
         if (!atoms.empty()) {
             std::stringstream strm;
@@ -553,7 +677,7 @@ private:
         for (unsigned i = m_fmls_head ; i < m_fmls.size(); ++i) {
             g->assert_expr(m_fmls[i].get());
         }
-        lbool res = internalize_goal(g, dep2asm);
+        lbool res = internalize_goal(g, dep2asm, !m_inprocess);
         if (res != l_undef) {
             m_fmls_head = m_fmls.size();
         }
@@ -567,6 +691,7 @@ private:
         for (unsigned i = 0; i < sz; ++i) {
             if (dep2asm.find(asms[i], lit)) {
                 SASSERT(lit.var() <= m_solver.num_vars());
+                m_solver.set_external(lit.var());
                 m_asms.push_back(lit);
                 if (i != j && !m_weights.empty()) {
                     m_weights[j] = m_weights[i];
@@ -577,6 +702,7 @@ private:
         for (unsigned i = 0; i < get_num_assumptions(); ++i) {
             if (dep2asm.find(get_assumption(i), lit)) {
                 SASSERT(lit.var() <= m_solver.num_vars());
+                m_solver.set_external(lit.var());
                 m_asms.push_back(lit);
             }
         }
@@ -9,6 +9,12 @@ Abstract:
 
     SAT variable priority queue.
 
+    var_queue_t is a heap over variable scores (VSIDS activities, CHB scores).
+    vmtf_queue implements variable move-to-front: variables are kept in a
+    doubly linked list ordered by the time they were last bumped, and a
+    search cursor points to the most recently bumped variable that may be
+    unassigned. All variables after the cursor are assigned.
+
 Author:
 
     Leonardo de Moura (leonardo) 2011-05-21.
@@ -24,21 +30,27 @@ Revision History:
 
 namespace sat {
     
-    class var_queue {
+    template<typename T>
+    class var_queue_t {
         struct lt {
-            svector<unsigned> & m_activity;
-            lt(svector<unsigned> & act):m_activity(act) {}
+            svector<T> & m_activity;
+            lt(svector<T> & act):m_activity(act) {}
             bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
         };
         heap<lt>  m_queue;
     public:
-        var_queue(svector<unsigned> & act):m_queue(128, lt(act)) {}
+        var_queue_t(svector<T> & act):m_queue(128, lt(act)) {}
         
         void activity_increased_eh(bool_var v) {
             if (m_queue.contains(v))
                 m_queue.decreased(v);
         }
 
+        void activity_decreased_eh(bool_var v) {
+            if (m_queue.contains(v))
+                m_queue.increased(v);
+        }
+
         void mk_var_eh(bool_var v) {
             m_queue.reserve(v+1);
             m_queue.insert(v);
@@ -62,6 +74,84 @@ namespace sat {
 
         bool_var next_var() { SASSERT(!empty()); return m_queue.erase_min(); }
     };
+
+    typedef var_queue_t<unsigned> var_queue;
+
+    class vmtf_queue {
+        svector<bool_var> m_prev;
+        svector<bool_var> m_next;
+        svector<uint64>   m_stamp;
+        uint64            m_stamp_counter;
+        bool_var          m_first;
+        bool_var          m_last;
+        bool_var          m_search;
+
+        void unlink(bool_var v) {
+            bool_var p = m_prev[v], n = m_next[v];
+            if (p == null_bool_var) m_first = n; else m_next[p] = n;
+            if (n == null_bool_var) m_last = p; else m_prev[n] = p;
+            if (m_search == v) m_search = p != null_bool_var ? p : n;
+        }
+
+        void enqueue(bool_var v) {
+            m_prev[v] = m_last;
+            m_next[v] = null_bool_var;
+            if (m_last == null_bool_var) m_first = v; else m_next[m_last] = v;
+            m_last = v;
+            m_stamp[v] = ++m_stamp_counter;
+        }
+
+    public:
+        vmtf_queue(): m_stamp_counter(0), m_first(null_bool_var), m_last(null_bool_var), m_search(null_bool_var) {}
+
+        void mk_var_eh(bool_var v) {
+            if (v >= m_prev.size()) {
+                m_prev.resize(v + 1, null_bool_var);
+                m_next.resize(v + 1, null_bool_var);
+                m_stamp.resize(v + 1, 0);
+            }
+            enqueue(v);
+            m_search = v;
+        }
+
+        void del_var_eh(bool_var v) {
+            unlink(v);
+        }
+
+        void unassign_var_eh(bool_var v) {
+            if (m_search == null_bool_var || m_stamp[v] > m_stamp[m_search])
+                m_search = v;
+        }
+
+        /**
+           \brief move v to the front of the queue.
+           is_unassigned indicates whether v is currently unassigned.
+        */
+        void bump(bool_var v, bool is_unassigned) {
+            if (m_last != v) {
+                unlink(v);
+                enqueue(v);
+            }
+            else {
+                m_stamp[v] = ++m_stamp_counter;
+            }
+            if (is_unassigned)
+                m_search = v;
+        }
+
+        uint64 stamp(bool_var v) const { return m_stamp[v]; }
+
+        /**
+           \brief reset the search cursor to the front of the queue.
+        */
+        void reset_search() { m_search = m_last; }
+
+        // the caller walks from search() towards the back of the queue using prev()
+        // until it finds an unassigned variable, and then calls set_search().
+        bool_var search() const { return m_search; }
+        bool_var prev(bool_var v) const { return m_prev[v]; }
+        void set_search(bool_var v) { m_search = v; }
+    };
 };
 
 #endif
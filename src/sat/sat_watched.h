@@ -126,6 +126,32 @@ namespace sat {
 
     typedef vector<watched> watch_list;
 
+    /**
+       \brief add a binary watch to wlist.
+       Binary watches are kept in a prefix of the watch list, so that
+       propagation can process them before touching clause memory.
+       The watch is appended when the list ends with a binary watch,
+       otherwise it is swapped with the first non-binary watch, which is
+       found by binary search over the prefix.
+       The order of the other watches is not preserved.
+    */
+    inline void push_binary_watch(watch_list & wlist, watched const & w) {
+        SASSERT(w.is_binary_clause());
+        wlist.push_back(w);
+        unsigned sz = wlist.size() - 1;
+        if (sz == 0 || wlist[sz - 1].is_binary_clause())
+            return;
+        unsigned lo = 0, hi = sz - 1;
+        while (lo < hi) {
+            unsigned mid = (lo + hi) / 2;
+            if (wlist[mid].is_binary_clause())
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        std::swap(wlist[lo], wlist[sz]);
+    }
+
     bool erase_clause_watch(watch_list & wlist, clause_offset c);
     inline void erase_ternary_watch(watch_list & wlist, literal l1, literal l2) { wlist.erase(watched(l1, l2)); }
 
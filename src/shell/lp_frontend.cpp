@@ -21,7 +21,9 @@ static lean::lp_solver<double, double>* g_solver = 0;
 
 static void display_statistics() {
     if (g_solver && g_solver->settings().print_statistics) {
-        // TBD display relevant information about statistics
+        lean::stats const & st = g_solver->settings().st();
+        std::cout << "iterations: " << st.m_total_iterations << "\n";
+        std::cout << "factorizations: " << st.m_num_factorizations << "\n";
     }
 }
 
@@ -80,6 +82,8 @@ void run_solver(lp_params & params, char const * mps_file_name) {
     solver->settings().set_message_ostream(&std::cout);
     solver->settings().report_frequency = params.rep_freq();
     solver->settings().print_statistics = params.print_stats();
+    solver->settings().lu_max_updates = params.lu_max_updates();
+    solver->settings().lu_eta_growth_factor = params.lu_eta_growth_factor();
     solver->settings().simplex_strategy() = lean:: simplex_strategy_enum::lu;
     
     solver->find_maximal_solution();
@@ -549,6 +549,21 @@ namespace smt {
             m_candidates.reset();
         }
 
+        /**
+           \brief Remove the first num candidates, they were already matched.
+        */
+        void remove_candidates(unsigned num) {
+            SASSERT(num <= m_candidates.size());
+            if (num == m_candidates.size()) {
+                m_candidates.reset();
+                return;
+            }
+            unsigned sz = m_candidates.size();
+            for (unsigned i = num; i < sz; ++i)
+                m_candidates[i - num] = m_candidates[i];
+            m_candidates.shrink(sz - num);
+        }
+
         enode_vector const & get_candidates() const {
             return m_candidates;
         }
@@ -1850,6 +1865,15 @@ namespace smt {
     typedef svector<backtrack_point> backtrack_stack;
 
     class interpreter {
+    public:
+        struct stats {
+            unsigned m_num_candidates;
+            unsigned m_num_dup_candidates;
+            unsigned m_num_deferred_candidates;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+    private:
         context &           m_context;
         ast_manager &       m_ast_manager;
         mam &               m_mam;
@@ -1860,6 +1884,7 @@ namespace smt {
         backtrack_stack     m_backtrack_stack;
         unsigned            m_top;
         const instruction * m_pc;
+        stats               m_stats;
 
         // auxiliary temporary variables
         unsigned            m_max_generation;  // the maximum generation of an app enode processed.
@@ -2009,6 +2034,8 @@ namespace smt {
         ~interpreter() {
         }
 
+        stats const & get_stats() const { return m_stats; }
+
         void init(code_tree * t) {
             TRACE("mam_bug", tout << "preparing to match tree:\n" << *t << "\n";);
             m_registers.reserve(t->get_num_regs(), 0);
@@ -2017,36 +2044,40 @@ namespace smt {
                 m_backtrack_stack.resize(t->get_num_choices());
         }
 
-        void execute(code_tree * t) {
+        /**
+           \brief Match the candidates of t, at most budget of them.
+           A candidate is skipped if it is not a congruence root, or if it
+           occurs more than once in the candidates of this round.
+           The candidates that were not considered are kept in t for the next round.
+        */
+        void execute(code_tree * t, unsigned & budget) {
             TRACE("trigger_bug", tout << "execute for code tree:\n"; t->display(tout););
             init(t);
-            enode_vector::const_iterator it  = t->get_candidates().begin();
-            enode_vector::const_iterator end = t->get_candidates().end();
-            if (t->filter_candidates()) {
-                for (; it != end; ++it) {
-                    enode * app = *it;
-                    if (!app->is_marked() && app->is_cgr()) {
-                        execute_core(t, app);
-                        app->set_mark();
-                    }
+            enode_vector const & candidates = t->get_candidates();
+            unsigned sz = candidates.size();
+            unsigned i  = 0;
+            for (; i < sz && budget > 0; ++i) {
+                enode * app = candidates[i];
+                TRACE("trigger_bug", tout << "candidate\n" << mk_ismt2_pp(app->get_owner(), m_ast_manager) << "\n";);
+                if (app->is_marked()) {
+                    m_stats.m_num_dup_candidates++;
                 }
-                it  = t->get_candidates().begin();
-                for (; it != end; ++it) {
-                    enode * app = *it;
-                    if (app->is_marked())
-                        app->unset_mark();
+                else if (app->is_cgr()) {
+                    TRACE("trigger_bug", tout << "is_cgr\n";);
+                    execute_core(t, app);
+                    app->set_mark();
+                    m_stats.m_num_candidates++;
+                    --budget;
                 }
             }
-            else {
-                for (; it != end; ++it) {
-                    enode * app = *it;
-                    TRACE("trigger_bug", tout << "candidate\n" << mk_ismt2_pp(app->get_owner(), m_ast_manager) << "\n";);
-                    if (app->is_cgr()) {
-                        TRACE("trigger_bug", tout << "is_cgr\n";);
-                        execute_core(t, app);
-                    }
-                }
+            for (unsigned j = 0; j < i; ++j) {
+                enode * app = candidates[j];
+                if (app->is_marked())
+                    app->unset_mark();
             }
+            if (i < sz)
+                m_stats.m_num_deferred_candidates += sz - i;
+            t->remove_candidates(i);
         }
 
         // init(t) must be invoked before execute_core
@@ -3900,15 +3931,27 @@ namespace smt {
 
         virtual void match() {
             TRACE("trigger_bug", tout << "match\n"; display(tout););
-            ptr_vector<code_tree>::iterator it  = m_to_match.begin();
-            ptr_vector<code_tree>::iterator end = m_to_match.end();
-            for (; it != end; ++it) {
-                code_tree * t = *it;
+            // at most qi.max_match_candidates candidates are matched in each round.
+            // The remaining candidates stay in m_to_match, and they are matched
+            // in the next round after the core propagated the new instances.
+            unsigned budget = m_context.get_fparams().m_qi_max_match_candidates;
+            unsigned sz = m_to_match.size();
+            unsigned i  = 0;
+            for (; i < sz && budget > 0; ++i) {
+                code_tree * t = m_to_match[i];
                 SASSERT(t->has_candidates());
-                m_interpreter.execute(t);
-                t->reset_candidates();
+                m_interpreter.execute(t, budget);
+                if (t->has_candidates())
+                    break;
+            }
+            if (i == sz) {
+                m_to_match.reset();
+            }
+            else {
+                for (unsigned j = i; j < sz; ++j)
+                    m_to_match[j - i] = m_to_match[j];
+                m_to_match.shrink(sz - i);
             }
-            m_to_match.reset();
             if (!m_new_patterns.empty()) {
                 match_new_patterns();
                 m_new_patterns.reset();
@@ -4000,6 +4043,13 @@ namespace smt {
             return !m_to_match.empty() || !m_new_patterns.empty();
         }
 
+        virtual void collect_statistics(::statistics & st) const {
+            interpreter::stats const & s = m_interpreter.get_stats();
+            st.update("mam candidates", s.m_num_candidates);
+            st.update("mam dup candidates", s.m_num_dup_candidates);
+            st.update("mam deferred candidates", s.m_num_deferred_candidates);
+        }
+
         virtual void add_eq_eh(enode * r1, enode * r2) {
             flet<enode *> l1(m_r1, r1);
             flet<enode *> l2(m_r2, r2);
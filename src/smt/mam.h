@@ -20,6 +20,7 @@ Revision History:
 #define MAM_H_
 
 #include "ast/ast.h"
+#include "util/statistics.h"
 #include "smt/smt_types.h"
 
 namespace smt {
@@ -61,6 +62,8 @@ namespace smt {
         
         virtual bool is_shared(enode * n) const = 0;
 
+        virtual void collect_statistics(::statistics & st) const = 0;
+
 #ifdef Z3DEBUG
         virtual bool check_missing_instances() = 0;
 #endif
@@ -34,7 +34,11 @@ void qi_params::updt_params(params_ref const & _p) {
     m_qi_eager_threshold = p.qi_eager_threshold();
     m_qi_lazy_threshold = p.qi_lazy_threshold();
     m_qi_cost = p.qi_cost();
+    m_qi_trace_file = p.qi_trace_file();
     m_qi_max_eager_multipatterns = p.qi_max_multi_patterns();
+    m_qi_batch_size = p.qi_batch_size();
+    m_qi_dedup = p.qi_dedup();
+    m_qi_max_match_candidates = p.qi_max_match_candidates();
 }
 
 #define DISPLAY_PARAM(X) out << #X"=" << X << std::endl;
@@ -55,6 +59,10 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_qi_max_instances);
     DISPLAY_PARAM(m_qi_lazy_instantiation);
     DISPLAY_PARAM(m_qi_conservative_final_check);
+    DISPLAY_PARAM(m_qi_batch_size);
+    DISPLAY_PARAM(m_qi_dedup);
+    DISPLAY_PARAM(m_qi_max_match_candidates);
+    DISPLAY_PARAM(m_qi_trace_file);
     DISPLAY_PARAM(m_mbqi);
     DISPLAY_PARAM(m_mbqi_max_cexs);
     DISPLAY_PARAM(m_mbqi_max_cexs_incr);
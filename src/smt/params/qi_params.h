@@ -32,6 +32,7 @@ struct qi_params {
     bool               m_qi_ematching;
     std::string        m_qi_cost;
     std::string        m_qi_new_gen;
+    std::string        m_qi_trace_file;
     double             m_qi_eager_threshold;
     double             m_qi_lazy_threshold;
     unsigned           m_qi_max_eager_multipatterns;
@@ -44,6 +45,9 @@ struct qi_params {
     unsigned           m_qi_max_instances;
     bool               m_qi_lazy_instantiation;
     bool               m_qi_conservative_final_check;
+    unsigned           m_qi_batch_size;
+    bool               m_qi_dedup;
+    unsigned           m_qi_max_match_candidates;
 
     bool               m_mbqi;
     unsigned           m_mbqi_max_cexs;
@@ -93,6 +97,9 @@ struct qi_params {
         m_qi_max_instances(UINT_MAX),
         m_qi_lazy_instantiation(false),
         m_qi_conservative_final_check(false),
+        m_qi_batch_size(UINT_MAX),
+        m_qi_dedup(true),
+        m_qi_max_match_candidates(UINT_MAX),
         m_mbqi(true), // enabled by default
         m_mbqi_max_cexs(1),
         m_mbqi_max_cexs_incr(1),
@@ -28,6 +28,18 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_relevancy_lvl = p.relevancy();
     m_ematching   = p.ematching();
     m_phase_selection = static_cast<phase_selection>(p.phase_selection());
+    m_phase_target = p.phase_target();
+    symbol rp = p.phase_rephase();
+    if (rp == "none") m_rephase = RP_NONE;
+    else if (rp == "best") m_rephase = RP_BEST;
+    else if (rp == "flipped") m_rephase = RP_FLIPPED;
+    else if (rp == "original") m_rephase = RP_ORIGINAL;
+    else if (rp == "random") m_rephase = RP_RANDOM;
+    else if (rp == "walk") m_rephase = RP_WALK;
+    else if (rp == "cycle") m_rephase = RP_CYCLE;
+    else throw default_exception("invalid value for smt.phase.rephase, expected: none, best, flipped, original, random, walk or cycle");
+    m_rephase_base = p.phase_rephase_base();
+    m_rephase_walk_flips = p.phase_rephase_walk_flips();
     m_restart_strategy = static_cast<restart_strategy>(p.restart_strategy());
     m_restart_factor = p.restart_factor();
     m_case_split_strategy = static_cast<case_split_strategy>(p.case_split());
@@ -39,9 +51,16 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_timeout = p.timeout();
     m_rlimit  = p.rlimit();
     m_max_conflicts = p.max_conflicts();
+    m_lemma_gc_glue = p.lemma_gc_glue();
+    m_lemma_gc_compact = p.lemma_gc_compact();
     m_core_validate = p.core_validate();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
+    m_threads = p.threads();
+    m_threads_max_clause_size = p.threads_max_clause_size();
+    m_cube_depth = p.cube_depth();
+    m_cube_conflicts = p.cube_conflicts();
+    m_cube_theory_weight = p.cube_theory_weight();
     model_params mp(_p);
     m_model_compact = mp.compact();
     if (_p.get_bool("arith.greatest_error_pivot", false))
@@ -98,6 +117,10 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_phase_selection);
     DISPLAY_PARAM(m_phase_caching_on);
     DISPLAY_PARAM(m_phase_caching_off);
+    DISPLAY_PARAM(m_phase_target);
+    DISPLAY_PARAM(m_rephase);
+    DISPLAY_PARAM(m_rephase_base);
+    DISPLAY_PARAM(m_rephase_walk_flips);
     DISPLAY_PARAM(m_minimize_lemmas);
     DISPLAY_PARAM(m_max_conflicts);
     DISPLAY_PARAM(m_simplify_clauses);
@@ -127,6 +150,8 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_recent_lemmas_size);
     DISPLAY_PARAM(m_lemma_gc_initial);
     DISPLAY_PARAM(m_lemma_gc_factor);
+    DISPLAY_PARAM(m_lemma_gc_glue);
+    DISPLAY_PARAM(m_lemma_gc_compact);
     DISPLAY_PARAM(m_new_old_ratio);
     DISPLAY_PARAM(m_new_clause_activity);
     DISPLAY_PARAM(m_old_clause_activity);
@@ -161,4 +186,11 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_check_at_labels);
     DISPLAY_PARAM(m_dump_goal_as_smt);
     DISPLAY_PARAM(m_auto_config);
+
+    DISPLAY_PARAM(m_string_solver);
+    DISPLAY_PARAM(m_threads);
+    DISPLAY_PARAM(m_threads_max_clause_size);
+    DISPLAY_PARAM(m_cube_depth);
+    DISPLAY_PARAM(m_cube_conflicts);
+    DISPLAY_PARAM(m_cube_theory_weight);
 }
@@ -41,6 +41,16 @@ enum phase_selection {
     PS_OCCURRENCE
 };
 
+enum rephase_strategy {
+    RP_NONE,
+    RP_BEST,     // phases of the longest conflict-free trail.
+    RP_FLIPPED,  // negate the saved phases.
+    RP_ORIGINAL, // forget the saved phases.
+    RP_RANDOM,
+    RP_WALK,     // phases of the best assignment found by a local search over the clauses.
+    RP_CYCLE     // best, walk, best, flipped, best, original, best, random.
+};
+
 enum restart_strategy {
     RS_GEOMETRIC,
     RS_IN_OUT_GEOMETRIC,
@@ -97,6 +107,10 @@ struct smt_params : public preprocessor_params,
     phase_selection  m_phase_selection;
     unsigned         m_phase_caching_on;
     unsigned         m_phase_caching_off;
+    bool             m_phase_target;
+    rephase_strategy m_rephase;
+    unsigned         m_rephase_base;
+    unsigned         m_rephase_walk_flips;
     bool             m_minimize_lemmas;
     unsigned         m_max_conflicts;
     bool             m_simplify_clauses;
@@ -159,6 +173,8 @@ struct smt_params : public preprocessor_params,
     unsigned          m_new_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     unsigned          m_old_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     double            m_inv_clause_decay;     //!< clause activity decay
+    unsigned          m_lemma_gc_glue;        //!< lemmas with at most this glue are not deleted.
+    bool              m_lemma_gc_compact;     //!< compact the memory used by lemmas after lemma gc.
 
     // -----------------------------------
     //
@@ -234,6 +250,23 @@ struct smt_params : public preprocessor_params,
     // -----------------------------------
     symbol m_string_solver;
 
+    // -----------------------------------
+    //
+    // Parallel portfolio
+    //
+    // -----------------------------------
+    unsigned            m_threads;
+    unsigned            m_threads_max_clause_size;
+
+    // -----------------------------------
+    //
+    // Cube and conquer
+    //
+    // -----------------------------------
+    unsigned            m_cube_depth;
+    unsigned            m_cube_conflicts;
+    double              m_cube_theory_weight;
+
     smt_params(params_ref const & p = params_ref()):
         m_display_proof(false),
         m_display_dot_proof(false),
@@ -251,6 +284,10 @@ struct smt_params : public preprocessor_params,
         m_phase_selection(PS_CACHING_CONSERVATIVE),
         m_phase_caching_on(400),
         m_phase_caching_off(100),
+        m_phase_target(false),
+        m_rephase(RP_NONE),
+        m_rephase_base(1000),
+        m_rephase_walk_flips(100000),
         m_minimize_lemmas(true),
         m_max_conflicts(UINT_MAX),
         m_simplify_clauses(true),
@@ -283,6 +320,8 @@ struct smt_params : public preprocessor_params,
         m_new_clause_relevancy(45),
         m_old_clause_relevancy(6),
         m_inv_clause_decay(1),
+        m_lemma_gc_glue(2),
+        m_lemma_gc_compact(true),
         m_smtlib_dump_lemmas(false),
         m_logic(symbol::null),
         m_profile_res_sub(false),
@@ -305,7 +344,12 @@ struct smt_params : public preprocessor_params,
         m_check_at_labels(false),
         m_dump_goal_as_smt(false),
         m_auto_config(true),
-        m_string_solver(symbol("auto")){
+        m_string_solver(symbol("auto")),
+        m_threads(1),
+        m_threads_max_clause_size(3),
+        m_cube_depth(0),
+        m_cube_conflicts(1000),
+        m_cube_theory_weight(2.0) {
         updt_local_params(p);
     }
 
@@ -31,9 +31,14 @@ void theory_arith_params::updt_params(params_ref const & _p) {
     m_arith_euclidean_solver = p.arith_euclidean_solver();
     m_arith_propagate_eqs = p.arith_propagate_eqs();
     m_arith_branch_cut_ratio = p.arith_branch_cut_ratio();
+    m_arith_mir_cuts = p.arith_mir_cuts();
+    m_arith_cover_cuts = p.arith_cover_cuts();
+    m_arith_max_cuts_per_round = p.arith_max_cuts_per_round();
+    m_arith_cut_pool_size = p.arith_cut_pool_size();
     m_arith_int_eq_branching = p.arith_int_eq_branch();
     m_arith_ignore_int = p.arith_ignore_int();
     m_arith_bound_prop = static_cast<bound_prop_mode>(p.arith_propagation_mode());
+    m_arith_bound_prop_budget = p.arith_propagation_budget();
     m_arith_dump_lemmas = p.arith_dump_lemmas();
     m_arith_reflect = p.arith_reflect();
 }
@@ -47,6 +52,7 @@ void theory_arith_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_arith_blands_rule_threshold);
     DISPLAY_PARAM(m_arith_propagate_eqs);
     DISPLAY_PARAM(m_arith_bound_prop);
+    DISPLAY_PARAM(m_arith_bound_prop_budget);
     DISPLAY_PARAM(m_arith_stronger_lemmas);
     DISPLAY_PARAM(m_arith_skip_rows_with_big_coeffs);
     DISPLAY_PARAM(m_arith_max_lemma_size);
@@ -64,6 +70,10 @@ void theory_arith_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_arith_dump_lemmas);
     DISPLAY_PARAM(m_arith_eager_eq_axioms);
     DISPLAY_PARAM(m_arith_branch_cut_ratio);
+    DISPLAY_PARAM(m_arith_mir_cuts);
+    DISPLAY_PARAM(m_arith_cover_cuts);
+    DISPLAY_PARAM(m_arith_max_cuts_per_round);
+    DISPLAY_PARAM(m_arith_cut_pool_size);
     DISPLAY_PARAM(m_arith_int_eq_branching);
     DISPLAY_PARAM(m_arith_enum_const_mod);
     DISPLAY_PARAM(m_arith_gcd_test);
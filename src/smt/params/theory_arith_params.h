@@ -28,7 +28,8 @@ enum arith_solver_id {
     AS_ARITH,
     AS_DENSE_DIFF_LOGIC,
     AS_UTVPI,
-    AS_OPTINF
+    AS_OPTINF,
+    AS_LRA
 };
 
 enum bound_prop_mode {
@@ -54,6 +55,7 @@ struct theory_arith_params {
     unsigned                m_arith_blands_rule_threshold;
     bool                    m_arith_propagate_eqs;
     bound_prop_mode         m_arith_bound_prop; 
+    unsigned                m_arith_bound_prop_budget; //!< initial number of row entries visited in a bound propagation round
     bool                    m_arith_stronger_lemmas;
     bool                    m_arith_skip_rows_with_big_coeffs;
     unsigned                m_arith_max_lemma_size; 
@@ -71,6 +73,10 @@ struct theory_arith_params {
     bool                    m_arith_dump_lemmas;
     bool                    m_arith_eager_eq_axioms;
     unsigned                m_arith_branch_cut_ratio;
+    bool                    m_arith_mir_cuts;
+    bool                    m_arith_cover_cuts;
+    unsigned                m_arith_max_cuts_per_round;
+    unsigned                m_arith_cut_pool_size;
     bool                    m_arith_int_eq_branching;
     bool                    m_arith_enum_const_mod;
 
@@ -113,6 +119,7 @@ struct theory_arith_params {
         m_arith_blands_rule_threshold(1000),
         m_arith_propagate_eqs(true),
         m_arith_bound_prop(BP_REFINE),
+        m_arith_bound_prop_budget(20000),
         m_arith_stronger_lemmas(true),
         m_arith_skip_rows_with_big_coeffs(true),
         m_arith_max_lemma_size(128),
@@ -130,6 +137,10 @@ struct theory_arith_params {
         m_arith_dump_lemmas(false),
         m_arith_eager_eq_axioms(true),
         m_arith_branch_cut_ratio(2),
+        m_arith_mir_cuts(false),
+        m_arith_cover_cuts(false),
+        m_arith_max_cuts_per_round(4),
+        m_arith_cut_pool_size(256),
         m_arith_int_eq_branching(false),
         m_arith_enum_const_mod(false),
         m_arith_gcd_test(true),
@@ -23,6 +23,7 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "ast/rewriter/var_subst.h"
 #include "util/stats.h"
+#include <algorithm>
 
 namespace smt {
 
@@ -37,6 +38,7 @@ namespace smt {
         m_parser(m_manager),
         m_evaluator(m_manager),
         m_subst(m_manager),
+        m_batch(DEFAULT_HASHTABLE_INITIAL_CAPACITY, entry_root_hash(m_new_entries), entry_root_eq(m_new_entries)),
         m_instances(m_manager) {
         init_parser_vars();
         m_vals.resize(15, 0.0f);
@@ -144,24 +146,86 @@ namespace smt {
               }
               tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        m_new_entries.push_back(entry(f, pat, cost, generation));
+    }
+
+    unsigned qi_queue::entry_root_hash::operator()(unsigned idx) const {
+        fingerprint * f = m_entries[idx].m_qb;
+        unsigned h      = static_cast<quantifier*>(f->get_data())->get_id();
+        unsigned num    = f->get_num_args();
+        for (unsigned i = 0; i < num; i++)
+            h = combine_hash(h, f->get_arg(i)->get_root()->hash());
+        return h;
+    }
+
+    bool qi_queue::entry_root_eq::operator()(unsigned idx1, unsigned idx2) const {
+        fingerprint * f1 = m_entries[idx1].m_qb;
+        fingerprint * f2 = m_entries[idx2].m_qb;
+        if (f1->get_data() != f2->get_data())
+            return false;
+        unsigned num = f1->get_num_args();
+        SASSERT(num == f2->get_num_args());
+        for (unsigned i = 0; i < num; i++)
+            if (f1->get_arg(i)->get_root() != f2->get_arg(i)->get_root())
+                return false;
+        return true;
+    }
+
+    struct entry_lt {
+        template<typename Entry>
+        bool operator()(Entry const & e1, Entry const & e2) const {
+            return e1.m_cost < e2.m_cost || (e1.m_cost == e2.m_cost && e1.m_generation < e2.m_generation);
+        }
+    };
+
+    /**
+       \brief Order the instances found in this round by cost and generation.
+       So, the cheapest instance of a set of instances with congruent bindings is
+       created, and the cheapest instances are created first when the number of
+       instances per round is bounded.
+    */
+    void qi_queue::sort_new_entries() {
+        std::stable_sort(m_new_entries.begin(), m_new_entries.end(), entry_lt());
     }
 
     void qi_queue::instantiate() {
-        svector<entry>::iterator it               = m_new_entries.begin();
-        svector<entry>::iterator end              = m_new_entries.end();
+        bool dedup   = m_params.m_qi_dedup;
+        bool batched = m_params.m_qi_batch_size != UINT_MAX;
+        if (dedup || batched)
+            sort_new_entries();
+        m_batch.reset();
+        unsigned                 num_eager        = 0;
         unsigned                 since_last_check = 0;
-        for (; it != end; ++it) {
-            entry & curr       = *it;
+        unsigned                 sz               = m_new_entries.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            entry & curr       = m_new_entries[i];
             fingerprint * f    = curr.m_qb;
             quantifier * qa    = static_cast<quantifier*>(f->get_data());
 
-            if (curr.m_cost <= m_eager_cost_threshold) {
+            if (dedup) {
+                // An instance with congruent bindings is redundant as long as the equalities hold.
+                // The fingerprint of curr is removed when they are backtracked.
+                if (m_batch.contains(i)) {
+                    TRACE("qi_queue", tout << "duplicate instance " << f << " of " << qa->get_qid() << "\n";);
+                    m_stats.m_num_dup_instances++;
+                    continue;
+                }
+                m_batch.insert(i);
+            }
+
+            if (batched && num_eager >= m_params.m_qi_batch_size) {
+                TRACE("qi_queue", tout << "postponing quantifier instantiation... " << f << "\n";);
+                m_stats.m_num_postponed_instances++;
+                m_delayed_entries.push_back(curr);
+            }
+            else if (curr.m_cost <= m_eager_cost_threshold) {
+                num_eager++;
                 instantiate(curr);
             }
             else if (m_params.m_qi_promote_unsat && m_checker.is_unsat(qa->get_expr(), f->get_num_args(), f->get_args())) {
                 // do not delay instances that produce a conflict.
                 TRACE("qi_unsat", tout << "promoting instance that produces a conflict\n" << mk_pp(qa, m_manager) << "\n";);
+                num_eager++;
                 instantiate(curr);
             }
             else {
@@ -179,6 +243,7 @@ namespace smt {
             }
         }
         m_new_entries.reset();
+        m_batch.reset();
         TRACE("new_entries_bug", tout << "[qi:instatiate]\n";);
     }
 
@@ -291,7 +356,12 @@ namespace smt {
         m_stats.m_num_instances++;
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
+        qi_trace * trace = m_context.get_qi_trace();
+        if (trace)
+            trace->begin_instance(q, ent.m_pat, num_bindings, bindings, gen, ent.m_cost);
         m_context.internalize_instance(lemma, pr1, gen);
+        if (trace)
+            trace->end_instance();
         TRACE_CODE({
             static unsigned num_useless = 0;
             if (m_manager.is_or(lemma)) {
@@ -470,6 +540,10 @@ namespace smt {
     void qi_queue::collect_statistics(::statistics & st) const {
         st.update("quant instantiations", m_stats.m_num_instances);
         st.update("lazy quant instantiations", m_stats.m_num_lazy_instances);
+        if (m_stats.m_num_dup_instances > 0)
+            st.update("dup quant instantiations", m_stats.m_num_dup_instances);
+        if (m_stats.m_num_postponed_instances > 0)
+            st.update("postponed quant instantiations", m_stats.m_num_postponed_instances);
         st.update("missed quant instantiations", m_delayed_entries.size());
         float min, max;
         get_min_max_costs(min, max);
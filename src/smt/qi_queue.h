@@ -34,7 +34,7 @@ namespace smt {
     class context;
 
     struct qi_queue_stats {
-        unsigned m_num_instances, m_num_lazy_instances;
+        unsigned m_num_instances, m_num_lazy_instances, m_num_dup_instances, m_num_postponed_instances;
         void reset() { memset(this, 0, sizeof(qi_queue_stats)); }
         qi_queue_stats() { reset(); }
     };
@@ -55,12 +55,31 @@ namespace smt {
         double                        m_eager_cost_threshold;
         struct entry {
             fingerprint * m_qb;
+            app *         m_pat;   // pattern that produced the instance, 0 if it was not found by E-matching.
             float         m_cost;
             unsigned      m_generation:31;
             unsigned      m_instantiated:1;
-            entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
+            entry(fingerprint * f, app * pat, float c, unsigned g):m_qb(f), m_pat(pat), m_cost(c), m_generation(g), m_instantiated(false) {}
         };
         svector<entry>                m_new_entries;
+
+        /**
+           \brief Hash and equality of the entries in m_new_entries (given by their index) modulo the
+           current equivalence classes: entries of the same quantifier are equal if the roots of
+           their bindings are equal.
+        */
+        struct entry_root_hash {
+            svector<entry> const & m_entries;
+            entry_root_hash(svector<entry> const & es):m_entries(es) {}
+            unsigned operator()(unsigned idx) const;
+        };
+        struct entry_root_eq {
+            svector<entry> const & m_entries;
+            entry_root_eq(svector<entry> const & es):m_entries(es) {}
+            bool operator()(unsigned idx1, unsigned idx2) const;
+        };
+        typedef hashtable<unsigned, entry_root_hash, entry_root_eq> entry_set;
+        entry_set                     m_batch;         // entries of the current round that are not duplicates.
         svector<entry>                m_delayed_entries;
         expr_ref_vector               m_instances;
         unsigned_vector               m_instantiated_trail;
@@ -76,6 +95,7 @@ namespace smt {
         float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
         unsigned get_new_gen(quantifier * q, unsigned generation, float cost);
         void instantiate(entry & ent);
+        void sort_new_entries();
         void get_min_max_costs(float & min, float & max) const;
         void display_instance_profile(fingerprint * f, quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned proof_id, unsigned generation);
 
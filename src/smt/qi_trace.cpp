@@ -0,0 +1,279 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    qi_trace.cpp
+
+Abstract:
+
+    Machine readable trace of quantifier instantiation.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+--*/
+#include<sstream>
+#include<algorithm>
+#include<cmath>
+#include "smt/qi_trace.h"
+#include "smt/smt_enode.h"
+#include "ast/ast_smt2_pp.h"
+#include "util/warning.h"
+
+namespace smt {
+
+    unsigned qi_trace::clause_hash::operator()(unsigned idx) const {
+        unsigned const * lits = m_trace.m_lits.c_ptr() + m_trace.m_lits_lim[idx];
+        unsigned sz = m_trace.m_lits_lim[idx + 1] - m_trace.m_lits_lim[idx];
+        unsigned h = sz;
+        for (unsigned i = 0; i < sz; ++i)
+            h = combine_hash(h, lits[i]);
+        return h;
+    }
+
+    bool qi_trace::clause_eq::operator()(unsigned idx1, unsigned idx2) const {
+        unsigned b1 = m_trace.m_lits_lim[idx1], e1 = m_trace.m_lits_lim[idx1 + 1];
+        unsigned b2 = m_trace.m_lits_lim[idx2], e2 = m_trace.m_lits_lim[idx2 + 1];
+        if (e1 - b1 != e2 - b2)
+            return false;
+        for (; b1 < e1; ++b1, ++b2)
+            if (m_trace.m_lits[b1] != m_trace.m_lits[b2])
+                return false;
+        return true;
+    }
+
+    qi_trace::qi_trace(ast_manager & m, char const * file_name):
+        m(m),
+        m_file_name(file_name),
+        m_pinned(m),
+        m_num_instances(0),
+        m_curr_instance(UINT_MAX),
+        m_failed(false),
+        m_clauses(DEFAULT_HASHTABLE_INITIAL_CAPACITY, clause_hash(*this), clause_eq(*this)) {
+        m_lits_lim.push_back(0);
+    }
+
+    qi_trace::~qi_trace() {
+        m_out.flush();
+    }
+
+    /**
+       \brief The file is opened when the first instance is created, and the records are
+       appended. So, the contexts created by a solver, for example for each check of
+       a tactic, write consecutive sections to the same file.
+    */
+    bool qi_trace::open() {
+        if (m_out.is_open())
+            return true;
+        if (m_failed)
+            return false;
+        m_out.open(m_file_name.c_str(), std::ios_base::out | std::ios_base::app);
+        if (!m_out) {
+            warning_msg("could not open quantifier instantiation trace file '%s'", m_file_name.c_str());
+            m_failed = true;
+            return false;
+        }
+        m_out << "{\"type\":\"context\"}\n";
+        return true;
+    }
+
+    void qi_trace::display_string(char const * s) {
+        m_out << '"';
+        for (; *s; ++s) {
+            switch (*s) {
+            case '"':  m_out << "\\\""; break;
+            case '\\': m_out << "\\\\"; break;
+            case '\n': m_out << "\\n"; break;
+            case '\t': m_out << "\\t"; break;
+            default:   m_out << *s; break;
+            }
+        }
+        m_out << '"';
+    }
+
+    unsigned qi_trace::mk_quantifier(quantifier * q) {
+        unsigned id;
+        if (m_quantifier2id.find(q, id))
+            return id;
+        id = m_quantifier2id.size();
+        m_quantifier2id.insert(q, id);
+        m_pinned.push_back(q);
+        m_out << "{\"type\":\"quantifier\",\"id\":" << id << ",\"qid\":";
+        display_string(q->get_qid().str().c_str());
+        m_out << "}\n";
+        return id;
+    }
+
+    unsigned qi_trace::mk_pattern(quantifier * q, unsigned qid, app * pat) {
+        unsigned id;
+        if (m_pattern2id.find(q, pat, id))
+            return id;
+        id = m_pattern2id.size();
+        m_pattern2id.insert(q, pat, id);
+        m_pinned.push_back(pat);
+        std::ostringstream buffer;
+        for (unsigned i = 0; i < pat->get_num_args(); ++i) {
+            if (i > 0) buffer << " ";
+            buffer << mk_ismt2_pp(pat->get_arg(i), m);
+        }
+        m_out << "{\"type\":\"pattern\",\"id\":" << id << ",\"quantifier\":" << qid << ",\"pattern\":";
+        display_string(buffer.str().c_str());
+        m_out << "}\n";
+        return id;
+    }
+
+    void qi_trace::begin_instance(quantifier * q, app * pat, unsigned num_bindings, enode * const * bindings, unsigned generation, float cost) {
+        if (!open())
+            return;
+        unsigned qid = mk_quantifier(q);
+        unsigned pid = pat ? mk_pattern(q, qid, pat) : UINT_MAX;
+        m_curr_instance = m_num_instances++;
+        m_used.push_back(false);
+        m_out << "{\"type\":\"instance\",\"id\":" << m_curr_instance << ",\"quantifier\":" << qid << ",\"pattern\":";
+        if (pat)
+            m_out << pid;
+        else
+            m_out << "null";
+        m_out << ",\"bindings\":[";
+        for (unsigned i = 0; i < num_bindings; ++i) {
+            if (i > 0) m_out << ",";
+            m_out << bindings[i]->get_owner_id();
+        }
+        m_out << "],\"generation\":" << generation << ",\"cost\":";
+        // JSON has no representation of inf and nan.
+        if (std::isfinite(cost))
+            m_out << cost;
+        else
+            m_out << "null";
+        m_out << "}\n";
+    }
+
+    void qi_trace::push_lits(unsigned num_lits, literal const * lits) {
+        unsigned sz = m_lits.size();
+        for (unsigned i = 0; i < num_lits; ++i)
+            m_lits.push_back(lits[i].index());
+        std::sort(m_lits.begin() + sz, m_lits.end());
+        m_lits_lim.push_back(m_lits.size());
+    }
+
+    void qi_trace::add_unit(unsigned inst, literal l) {
+        unsigned v = l.var();
+        if (v >= m_var2instance.size())
+            m_var2instance.resize(v + 1, UINT_MAX);
+        if (m_var2instance[v] == UINT_MAX) {
+            m_var2instance[v] = inst;
+            m_units.push_back(v);
+        }
+    }
+
+    void qi_trace::add_clause(unsigned inst, unsigned num_lits, literal const * lits) {
+        push_lits(num_lits, lits);
+        unsigned idx = num_clauses();
+        m_clause2instance.push_back(inst);
+        if (!m_clauses.contains(idx)) {
+            m_clauses.insert(idx);
+        }
+        else {
+            // a clause with the same literals already belongs to a previous instance.
+            m_clause2instance.pop_back();
+            m_lits_lim.pop_back();
+            m_lits.shrink(m_lits_lim.back());
+        }
+    }
+
+    unsigned qi_trace::find_instance(unsigned num_lits, literal const * lits) {
+        if (m_clauses.empty())
+            return UINT_MAX;
+        // use the slot after the last clause for the lookup.
+        push_lits(num_lits, lits);
+        unsigned idx = num_clauses();
+        m_clause2instance.push_back(UINT_MAX);
+        unsigned found;
+        bool is_instance = m_clauses.find(idx, found);
+        m_clause2instance.pop_back();
+        m_lits_lim.pop_back();
+        m_lits.shrink(m_lits_lim.back());
+        return is_instance ? m_clause2instance[found] : UINT_MAX;
+    }
+
+    void qi_trace::mk_clause_eh(unsigned num_lits, literal const * lits) {
+        if (m_curr_instance == UINT_MAX)
+            return;
+        if (num_lits == 0)
+            // the instance is in conflict with the current assignment.
+            mark_used(m_curr_instance);
+        else if (num_lits == 1)
+            add_unit(m_curr_instance, lits[0]);
+        else
+            add_clause(m_curr_instance, num_lits, lits);
+    }
+
+    void qi_trace::simplify_clause_eh(unsigned num_lits, literal const * lits, unsigned num_new_lits, literal const * new_lits) {
+        unsigned inst = find_instance(num_lits, lits);
+        if (inst != UINT_MAX)
+            add_clause(inst, num_new_lits, new_lits);
+    }
+
+    void qi_trace::axiom_eh(literal l, unsigned num_lits, literal const * lits) {
+        unsigned inst = find_instance(num_lits, lits);
+        if (inst != UINT_MAX)
+            add_unit(inst, l);
+    }
+
+    void qi_trace::resolve_eh(unsigned num_lits, literal const * lits) {
+        unsigned inst = find_instance(num_lits, lits);
+        if (inst != UINT_MAX)
+            mark_used(inst);
+    }
+
+    void qi_trace::resolve_eh(literal l) {
+        unsigned v = l.var();
+        if (v < m_var2instance.size() && m_var2instance[v] != UINT_MAX)
+            mark_used(m_var2instance[v]);
+    }
+
+    void qi_trace::set_visited(bool_var v, unsigned lvl) {
+        m_visited.reserve(v + 1, false);
+        m_visited[v] = true;
+        m_visited_at.reserve(lvl + 1);
+        m_visited_at[lvl].push_back(v);
+    }
+
+    void qi_trace::mark_used(unsigned inst) {
+        if (!m_used[inst]) {
+            m_used[inst] = true;
+            m_out << "{\"type\":\"used\",\"id\":" << inst << "}\n";
+        }
+    }
+
+    void qi_trace::push_scope() {
+        m_scopes.push_back(num_clauses());
+        m_units_lim.push_back(m_units.size());
+    }
+
+    void qi_trace::pop_scope(unsigned num_scopes) {
+        unsigned new_lvl = m_scopes.size() - num_scopes;
+        unsigned old_sz  = m_scopes[new_lvl];
+        // the literals of clauses created in the popped scopes may be reused.
+        for (unsigned i = num_clauses(); i-- > old_sz; )
+            m_clauses.erase(i);
+        m_clause2instance.shrink(old_sz);
+        m_lits_lim.shrink(old_sz + 1);
+        m_lits.shrink(m_lits_lim.back());
+        m_scopes.shrink(new_lvl);
+        unsigned old_units = m_units_lim[new_lvl];
+        for (unsigned i = old_units; i < m_units.size(); ++i)
+            m_var2instance[m_units[i]] = UINT_MAX;
+        m_units.shrink(old_units);
+        m_units_lim.shrink(new_lvl);
+        for (unsigned lvl = new_lvl + 1; lvl < m_visited_at.size(); ++lvl) {
+            for (unsigned v : m_visited_at[lvl])
+                m_visited[v] = false;
+        }
+        if (m_visited_at.size() > new_lvl + 1)
+            m_visited_at.shrink(new_lvl + 1);
+    }
+
+};
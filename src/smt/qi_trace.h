@@ -0,0 +1,182 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    qi_trace.h
+
+Abstract:
+
+    Machine readable trace of quantifier instantiation.
+
+    Each instance is written to a JSON-lines file together with its
+    quantifier, the pattern that produced it, the bindings, the generation
+    and the cost. An instance is reported as used when a clause created
+    for it, or a literal it assigns as a unit, takes part in conflict
+    resolution or in the final conflict of an unsatisfiable search.
+    The literals of the base level are not resolved, the instances used
+    to derive them are reported when they are first used in a conflict.
+    Instances that are only used to remove literals from a lemma in lemma
+    minimization, or literals from a clause in the simplification at the
+    base level, are not reported.
+    contrib/qitrace/qitrace.py summarizes such traces.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+    Records, one per line:
+
+    {"type":"context"}
+    {"type":"quantifier","id":0,"qid":"ax1"}
+    {"type":"pattern","id":0,"quantifier":0,"pattern":"(f x)"}
+    {"type":"instance","id":0,"quantifier":0,"pattern":0,"bindings":[12,40],"generation":1,"cost":2}
+    {"type":"used","id":0}
+
+    Bindings are the ids of the owners of the enodes. The pattern is null
+    for instances that are not produced by E-matching. Patterns have an id
+    per quantifier, a pattern shared by several quantifiers is recorded for
+    each of them. The cost is null if it is not finite.
+    The records of each context are appended to the file, after a context
+    record. Ids are local to the section of the context.
+
+--*/
+#ifndef QI_TRACE_H_
+#define QI_TRACE_H_
+
+#include<fstream>
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+#include "util/obj_pair_hashtable.h"
+#include "smt/smt_literal.h"
+#include "smt/smt_types.h"
+
+namespace smt {
+
+    class qi_trace {
+
+        /**
+           \brief Hash and equality of the clauses in m_lits (given by their index).
+           The literals of a clause are sorted, so clauses with the same literals are equal.
+        */
+        struct clause_hash {
+            qi_trace const & m_trace;
+            clause_hash(qi_trace const & t):m_trace(t) {}
+            unsigned operator()(unsigned idx) const;
+        };
+        struct clause_eq {
+            qi_trace const & m_trace;
+            clause_eq(qi_trace const & t):m_trace(t) {}
+            bool operator()(unsigned idx1, unsigned idx2) const;
+        };
+        typedef hashtable<unsigned, clause_hash, clause_eq> clause_table;
+
+        ast_manager &              m;
+        std::string                m_file_name;
+        std::ofstream              m_out;
+        obj_map<quantifier, unsigned> m_quantifier2id;
+        obj_pair_map<quantifier, app, unsigned> m_pattern2id;
+        ast_ref_vector             m_pinned;        // quantifiers and patterns that have an id.
+        unsigned                   m_num_instances;
+        unsigned                   m_curr_instance; // instance being internalized, UINT_MAX if none.
+        bool                       m_failed;        // the file could not be opened.
+        svector<bool>              m_used;
+
+        // clauses created for instances.
+        unsigned_vector            m_lits;          // sorted literal indices of the clauses.
+        unsigned_vector            m_lits_lim;      // clause i is m_lits[m_lits_lim[i], m_lits_lim[i+1]).
+        unsigned_vector            m_clause2instance;
+        clause_table               m_clauses;
+        unsigned_vector            m_scopes;
+
+        // literals assigned as units by instances.
+        unsigned_vector            m_var2instance;  // UINT_MAX if the variable is not assigned by an instance.
+        unsigned_vector            m_units;
+        unsigned_vector            m_units_lim;
+
+        // assigned literals whose antecedents were reported, by assignment level.
+        svector<bool>              m_visited;
+        vector<unsigned_vector>    m_visited_at;
+
+        unsigned num_clauses() const { return m_clause2instance.size(); }
+        bool open();
+        unsigned mk_quantifier(quantifier * q);
+        unsigned mk_pattern(quantifier * q, unsigned qid, app * pat);
+        void push_lits(unsigned num_lits, literal const * lits);
+        void display_string(char const * s);
+        void mark_used(unsigned inst);
+        void add_unit(unsigned inst, literal l);
+        void add_clause(unsigned inst, unsigned num_lits, literal const * lits);
+        unsigned find_instance(unsigned num_lits, literal const * lits);
+
+    public:
+        qi_trace(ast_manager & m, char const * file_name);
+
+        ~qi_trace();
+
+        /**
+           \brief Record an instance of q. The clauses created until end_instance()
+           is invoked belong to this instance.
+        */
+        void begin_instance(quantifier * q, app * pat, unsigned num_bindings, enode * const * bindings, unsigned generation, float cost);
+
+        void end_instance() { m_curr_instance = UINT_MAX; }
+
+        /**
+           \brief Invoked when an auxiliary clause is created, after the literals
+           assigned to false are removed. Units are recorded by their variable.
+        */
+        void mk_clause_eh(unsigned num_lits, literal const * lits);
+
+        /**
+           \brief Invoked when the literals assigned to false at the base level are
+           removed from the clause lits, new_lits are the remaining literals.
+        */
+        void simplify_clause_eh(unsigned num_lits, literal const * lits, unsigned num_new_lits, literal const * new_lits);
+
+        /**
+           \brief Invoked when the clause lits that justifies l is deleted at the base
+           level, and l becomes an axiom.
+        */
+        void axiom_eh(literal l, unsigned num_lits, literal const * lits);
+
+        /**
+           \brief Invoked for each clause that is resolved during conflict resolution.
+        */
+        void resolve_eh(unsigned num_lits, literal const * lits);
+
+        void resolve_eh(literal l1, literal l2) {
+            literal lits[2] = { l1, l2 };
+            resolve_eh(2, lits);
+        }
+
+        /**
+           \brief Invoked for a literal without a clause justification, or assigned at
+           the base level, that is used in conflict resolution.
+        */
+        void resolve_eh(literal l);
+
+        /**
+           \brief Return true if the antecedents of the literal assigned to v were already reported.
+           set_visited marks v until the scope level lvl of its assignment is popped.
+        */
+        bool is_visited(bool_var v) const { return static_cast<unsigned>(v) < m_visited.size() && m_visited[v]; }
+
+        void set_visited(bool_var v, unsigned lvl);
+
+        void push_scope();
+
+        void pop_scope(unsigned num_scopes);
+
+        /**
+           \brief Invoked at restarts and at the end of the search, so the trace
+           of a run that is interrupted is mostly complete.
+        */
+        void flush() { m_out.flush(); }
+    };
+
+};
+
+#endif /* QI_TRACE_H_ */
@@ -19,6 +19,10 @@ Notes:
 #include "cmd_context/cmd_context.h"
 #include "parsers/smt2/smt2parser.h"
 #include "smt/smt2_extra_cmds.h"
+#include "smt/smt_kernel.h"
+#include "smt/params/smt_params.h"
+#include "ast/ast_util.h"
+#include "ast/ast_smt2_pp.h"
 
 class include_cmd : public cmd {
     char const * m_filename;
@@ -42,6 +46,59 @@ public:
     virtual void finalize(cmd_context & ctx) { reset(ctx); }
 };
 
+class get_cubes_cmd : public cmd {
+    unsigned m_depth;
+public:
+    get_cubes_cmd() : cmd("get-cubes"), m_depth(0) {}
+    virtual char const * get_usage() const { return "<depth>"; }
+    virtual char const * get_descr(cmd_context & ctx) const { return "split the assertions into cubes of at most <depth> literals using the SMT core"; }
+    virtual unsigned get_arity() const { return 1; }
+    virtual cmd_arg_kind next_arg_kind(cmd_context & ctx) const { return CPK_UINT; }
+    virtual void set_next_arg(cmd_context & ctx, unsigned val) { m_depth = val; }
+    virtual void failure_cleanup(cmd_context & ctx) {}
+    virtual void execute(cmd_context & ctx) {
+        ast_manager & m = ctx.m();
+        // use the smt.* options of the command context, as check-sat does.
+        params_ref p;
+        bool proofs_enabled, models_enabled, unsat_core_enabled;
+        ctx.params().get_solver_params(m, p, proofs_enabled, models_enabled, unsat_core_enabled);
+        smt_params fp(p);
+        fp.updt_params(p);
+        fp.updt_params(ctx.params());
+        smt::kernel k(m, fp, p);
+        if (ctx.get_logic() != symbol::null) {
+            k.set_logic(ctx.get_logic());
+        }
+        ptr_vector<expr>::const_iterator it  = ctx.begin_assertions();
+        ptr_vector<expr>::const_iterator end = ctx.end_assertions();
+        for (; it != end; ++it) {
+            k.assert_expr(*it);
+        }
+        expr_ref_vector asms(m);
+        vector<expr_ref_vector> cubes;
+        lbool r = k.get_cubes(asms, m_depth, fp.m_cube_conflicts, cubes);
+        std::ostream & out = ctx.regular_stream();
+        switch (r) {
+        case l_true:  out << "sat\n"; return;
+        case l_false: out << "unsat\n"; return;
+        default: break;
+        }
+        if (cubes.empty()) {
+            out << "unknown\n";
+            return;
+        }
+        out << "(cubes";
+        for (unsigned i = 0; i < cubes.size(); ++i) {
+            out << "\n  " << mk_ismt2_pp(mk_and(cubes[i]), m, 2);
+        }
+        out << ")\n";
+    }
+    virtual void prepare(cmd_context & ctx) { reset(ctx); }
+    virtual void reset(cmd_context & ctx) { m_depth = 0; }
+    virtual void finalize(cmd_context & ctx) { reset(ctx); }
+};
+
 void install_smt2_extra_cmds(cmd_context & ctx) {
     ctx.insert(alloc(include_cmd));
+    ctx.insert(alloc(get_cubes_cmd));
 }
@@ -22,119 +22,6 @@ Revision History:
 
 namespace smt {
 
-#if 0
-    unsigned cg_table::cg_hash::operator()(enode * n) const {
-        if (n->is_commutative()) {
-            return  combine_hash(n->get_decl_id(), 
-                                 n->get_arg(0)->get_root()->hash() *
-                                 n->get_arg(1)->get_root()->hash());
-        }
-        else {
-            unsigned num = n->get_num_args();
-            switch (num) {
-            case 0: UNREACHABLE(); return 0;
-            case 1: 
-                return combine_hash(n->get_decl_id(), n->get_arg(0)->get_root()->hash());
-            case 2: {
-                unsigned a = n->get_decl_id();
-                unsigned b = n->get_arg(0)->get_root()->hash();
-                unsigned c = n->get_arg(1)->get_root()->hash();
-                mix(a,b,c);
-                return c;
-            }
-            default:
-                return get_composite_hash<enode *, cg_khasher, cg_chasher>(n, n->get_num_args(), m_khasher, m_chasher);
-            }
-        }
-    }
-
-    bool cg_table::cg_eq::operator()(enode * n1, enode * n2) const {
-#if 0
-        static unsigned counter = 0;
-        static unsigned failed  = 0;
-        bool r = congruent(n1, n2, m_commutativity);
-        if (!r) 
-            failed++;
-        counter++;
-        if (counter % 100000 == 0) 
-            std::cout << "cg_eq: " << counter << " " << failed << "\n";
-        return r;
-#else
-        return congruent(n1, n2, m_commutativity);
-#endif
-    }
-    
-    cg_table::cg_table(ast_manager & m):
-        m_manager(m),
-        m_table(DEFAULT_HASHTABLE_INITIAL_CAPACITY, cg_hash(), cg_eq(m_commutativity)) {
-    }
-    
-    void cg_table::display(std::ostream & out) const {
-        out << "congruence table:\n";
-        table::iterator it  = m_table.begin();
-        table::iterator end = m_table.end();
-        for (; it != end; ++it) {
-            enode * n = *it;
-            out << mk_pp(n->get_owner(), m_manager) << "\n";
-        }
-    }
-
-    void cg_table::display_compact(std::ostream & out) const {
-        if (!m_table.empty()) {
-            out << "congruence table:\n";
-            table::iterator it  = m_table.begin();
-            table::iterator end = m_table.end();
-            for (; it != end; ++it) {
-                enode * n = *it;
-                out << "#" << n->get_owner()->get_id() << " ";
-            }
-            out << "\n";
-        }
-    }
-
-#ifdef Z3DEBUG
-    bool cg_table::check_invariant() const {
-        table::iterator it  = m_table.begin();
-        table::iterator end = m_table.end();
-        for (; it != end; ++it) {
-            enode * n = *it;
-            CTRACE("cg_table", !contains_ptr(n), tout << "#" << n->get_owner_id() << "\n";);
-            SASSERT(contains_ptr(n));
-        }
-        return true;
-    }
-#endif
-
-#else
-    // one table per func_decl implementation
-    unsigned cg_table::cg_hash::operator()(enode * n) const {
-        SASSERT(n->get_decl()->is_flat_associative() || n->get_num_args() >= 3);
-        unsigned a, b, c;
-        a = b = 0x9e3779b9;
-        c = 11;    
-        
-        unsigned i = n->get_num_args();
-        while (i >= 3) {
-            i--;
-            a += n->get_arg(i)->get_root()->hash();
-            i--;
-            b += n->get_arg(i)->get_root()->hash();
-            i--;
-            c += n->get_arg(i)->get_root()->hash();
-            mix(a, b, c);
-        }
-        
-        switch (i) {
-        case 2:
-            b += n->get_arg(1)->get_root()->hash();
-            Z3_fallthrough;
-        case 1:
-            c += n->get_arg(0)->get_root()->hash();
-        }
-        mix(a, b, c);
-        return c;
-    }
-
     bool cg_table::cg_eq::operator()(enode * n1, enode * n2) const {
         SASSERT(n1->get_num_args() == n2->get_num_args());
         SASSERT(n1->get_decl() == n2->get_decl());
@@ -169,7 +56,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table, cg_comm_eq(m_commutativity)), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -203,6 +90,25 @@ namespace smt {
         });
         return tid;
     }
+
+    void cg_table::update_hash(enode * n, enode * r1, enode * r2) {
+        SASSERT(!contains_ptr(n));
+        table_kind k = static_cast<table_kind>(GET_TAG(get_table(n)));
+        SASSERT(n->get_cg_hash() == sig_hash(n, k));
+        unsigned num = n->get_num_args();
+        if (num == 1) {
+            SASSERT(n->get_arg(0)->get_root() == r1);
+            n->set_cg_hash(r2->hash());
+            return;
+        }
+        unsigned delta = r2->hash() - r1->hash();
+        unsigned h     = n->get_cg_hash();
+        for (unsigned i = 0; i < num; i++) {
+            if (n->get_arg(i)->get_root() == r1)
+                h += (k == BINARY_COMM ? 1 : arg_weight(i)) * delta;
+        }
+        n->set_cg_hash(h);
+    }
     
     void cg_table::reset() {
         ptr_vector<void>::iterator it  = m_tables.begin();
@@ -232,19 +138,77 @@ namespace smt {
         m_func_decl2id.reset();
     }
 
+    unsigned cg_table::size() const {
+        unsigned r = 0;
+        for (void * t : m_tables) {
+            switch (GET_TAG(t)) {
+            case UNARY:       r += UNTAG(unary_table*, t)->size(); break;
+            case BINARY:      r += UNTAG(binary_table*, t)->size(); break;
+            case BINARY_COMM: r += UNTAG(comm_table*, t)->size(); break;
+            default:          r += UNTAG(table*, t)->size(); break;
+            }
+        }
+        return r;
+    }
+
+    template<typename Proc>
+    void cg_table::for_each(Proc & proc) const {
+        for (void * t : m_tables) {
+            switch (GET_TAG(t)) {
+            case UNARY:       UNTAG(unary_table*, t)->for_each(proc); break;
+            case BINARY:      UNTAG(binary_table*, t)->for_each(proc); break;
+            case BINARY_COMM: UNTAG(comm_table*, t)->for_each(proc); break;
+            default:          UNTAG(table*, t)->for_each(proc); break;
+            }
+        }
+    }
+
+    struct cg_table::display_proc {
+        std::ostream & m_out;
+        ast_manager &  m_manager;
+        bool           m_compact;
+        display_proc(std::ostream & out, ast_manager & m, bool compact):m_out(out), m_manager(m), m_compact(compact) {}
+        void operator()(enode * n, unsigned h) {
+            if (m_compact)
+                m_out << "#" << n->get_owner_id() << " ";
+            else
+                m_out << mk_pp(n->get_owner(), m_manager) << "\n";
+        }
+    };
+
     void cg_table::display(std::ostream & out) const {
+        out << "congruence table:\n";
+        display_proc proc(out, m_manager, false);
+        for_each(proc);
     }
 
     void cg_table::display_compact(std::ostream & out) const {
+        if (size() > 0) {
+            out << "congruence table:\n";
+            display_proc proc(out, m_manager, true);
+            for_each(proc);
+            out << "\n";
+        }
     }
 
 #ifdef Z3DEBUG
+    struct cg_table::check_proc {
+        cg_table const & m_table;
+        check_proc(cg_table const & t):m_table(t) {}
+        void operator()(enode * n, unsigned h) {
+            CTRACE("cg_table", !m_table.contains_ptr(n), tout << "#" << n->get_owner_id() << "\n";);
+            SASSERT(n->get_cg_hash() == h);
+            SASSERT(m_table.contains_ptr(n));
+            SASSERT(m_table.find(n) == n);
+        }
+    };
+
     bool cg_table::check_invariant() const {
+        check_proc proc(*this);
+        for_each(proc);
         return true;
     }
 #endif
 
-#endif
-
 };
 
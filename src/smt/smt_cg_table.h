@@ -7,7 +7,7 @@ Module Name:
 
 Abstract:
 
-    <abstract>
+    Congruence table.
 
 Author:
 
@@ -15,111 +15,173 @@ Author:
 
 Revision History:
 
+    2017-10-26: one open addressed table per function symbol,
+    with signature hashes cached in the enodes.
+
 --*/
 #ifndef SMT_CG_TABLE_H_
 #define SMT_CG_TABLE_H_
 
 #include "smt/smt_enode.h"
-#include "util/hashtable.h"
-#include "util/chashtable.h"
+#include "util/hash.h"
+#include "util/obj_hashtable.h"
 
 namespace smt {
 
     typedef std::pair<enode *, bool> enode_bool_pair;
-    
-#if 0
+
     /**
        \brief Congruence table.
-    */
-    class cg_table {
-        struct cg_khasher {
-            unsigned operator()(enode const * n) const { return n->get_decl_id(); }
-        };
 
-        struct cg_chasher {
-            unsigned operator()(enode const * n, unsigned idx) const { 
-                return n->get_arg(idx)->get_root()->hash();
-            }
-        };
+       There is one table per function symbol. The signature hash of an
+       enode is a weighted sum of the hash codes of the roots of its arguments
+       (the plain sum for binary commutative symbols). It is cached in the
+       enode when the enode is inserted, so erase and contains_ptr do not
+       visit the arguments, and it is updated incrementally by update_hash when
+       the root of some of the arguments is about to be merged with another root.
 
-        struct cg_hash {
-            cg_khasher m_khasher;
-            cg_chasher m_chasher;
-        public:
-            unsigned operator()(enode * n) const;
-        };
+       Each table is an open addressed hash table with linear probing, and
+       entries that store the signature hash next to the enode. So, most
+       probes are rejected without visiting the arguments of the enode in the table.
+    */
+    class cg_table {
 
-        struct cg_eq {
-            bool & m_commutativity; 
-            cg_eq(bool & comm):m_commutativity(comm) {}
-            bool operator()(enode * n1, enode * n2) const;
+        struct entry {
+            enode *  m_node;
+            unsigned m_hash;
+            entry():m_node(0), m_hash(0) {}
         };
 
-        typedef ptr_hashtable<enode, cg_hash, cg_eq> table;
-
-        ast_manager &             m_manager;
-        bool                      m_commutativity; //!< true if the last found congruence used commutativity
-        table                     m_table;
-    public:
-        cg_table(ast_manager & m);
-
         /**
-           \brief Try to insert n into the table. If the table already
-           contains an element n' congruent to n, then do nothing and
-           return n' and a boolean indicating whether n and n' are congruence
-           modulo commutativity, otherwise insert n and return (n,false).
+           \brief Open addressed table of enodes of the same function symbol.
+           Eq decides whether two enodes with the same signature hash are congruent.
         */
-        enode_bool_pair insert(enode * n) {
-            // it doesn't make sense to insert a constant.
-            SASSERT(n->get_num_args() > 0);
-            m_commutativity = false;
-            enode * n_prime = m_table.insert_if_not_there(n); 
-            SASSERT(contains(n));
-            return enode_bool_pair(n_prime, m_commutativity);
-        }
+        template<typename Eq>
+        class sig_table {
+            Eq             m_eq;
+            svector<entry> m_entries;     // the capacity is a power of two.
+            unsigned       m_size;
+            unsigned       m_num_deleted;
+
+            static enode * deleted() { return reinterpret_cast<enode*>(1); }
+
+            void expand() {
+                unsigned capacity = m_entries.size();
+                if ((m_size + 1) * 2 > capacity)
+                    capacity *= 2;
+                svector<entry> entries;
+                entries.resize(capacity, entry());
+                unsigned mask = capacity - 1;
+                for (entry const & e : m_entries) {
+                    if (e.m_node == 0 || e.m_node == deleted())
+                        continue;
+                    unsigned idx = hash_u(e.m_hash) & mask;
+                    while (entries[idx].m_node != 0)
+                        idx = (idx + 1) & mask;
+                    entries[idx] = e;
+                }
+                m_entries.swap(entries);
+                m_num_deleted = 0;
+            }
 
-        void erase(enode * n) {
-            SASSERT(n->get_num_args() > 0);
-            m_table.erase(n);
-            SASSERT(!contains(n));
-        }
+        public:
+            sig_table(Eq const & eq = Eq()):m_eq(eq), m_size(0), m_num_deleted(0) {
+                m_entries.resize(8, entry());
+            }
 
-        bool contains(enode * n) const {
-            return m_table.contains(n);
-        }
+            /**
+               \brief Return an enode congruent to n. Insert n if there is none.
+            */
+            enode * insert_if_not_there(enode * n, unsigned h) {
+                if (4 * (m_size + m_num_deleted + 1) > 3 * m_entries.size())
+                    expand();
+                unsigned mask = m_entries.size() - 1;
+                unsigned idx  = hash_u(h) & mask;
+                unsigned del  = UINT_MAX;
+                while (true) {
+                    entry & e = m_entries[idx];
+                    if (e.m_node == 0) {
+                        if (del != UINT_MAX) {
+                            idx = del;
+                            m_num_deleted--;
+                        }
+                        m_entries[idx].m_node = n;
+                        m_entries[idx].m_hash = h;
+                        m_size++;
+                        return n;
+                    }
+                    if (e.m_node == deleted()) {
+                        if (del == UINT_MAX)
+                            del = idx;
+                    }
+                    else if (e.m_hash == h && m_eq(e.m_node, n)) {
+                        return e.m_node;
+                    }
+                    idx = (idx + 1) & mask;
+                }
+            }
 
-        enode * find(enode * n) const {
-            enode * r = 0;
-            return m_table.find(n, r) ? r : 0;
-        }
+            enode * find(enode * n, unsigned h) const {
+                unsigned mask = m_entries.size() - 1;
+                unsigned idx  = hash_u(h) & mask;
+                while (true) {
+                    entry const & e = m_entries[idx];
+                    if (e.m_node == 0)
+                        return 0;
+                    if (e.m_node != deleted() && e.m_hash == h && m_eq(e.m_node, n))
+                        return e.m_node;
+                    idx = (idx + 1) & mask;
+                }
+            }
 
-        bool contains_ptr(enode * n) const {
-            enode * n_prime;
-            return m_table.find(n, n_prime) && n == n_prime;
-        }
+            /**
+               \brief Return true if the table contains n itself. h is the signature hash
+               used to insert n.
+            */
+            bool contains_ptr(enode * n, unsigned h) const {
+                unsigned mask = m_entries.size() - 1;
+                unsigned idx  = hash_u(h) & mask;
+                while (true) {
+                    entry const & e = m_entries[idx];
+                    if (e.m_node == 0)
+                        return false;
+                    if (e.m_node == n)
+                        return true;
+                    idx = (idx + 1) & mask;
+                }
+            }
 
-        void reset() {
-            m_table.reset();
-        }
+            void erase(enode * n, unsigned h) {
+                unsigned mask = m_entries.size() - 1;
+                unsigned idx  = hash_u(h) & mask;
+                while (true) {
+                    entry & e = m_entries[idx];
+                    if (e.m_node == 0)
+                        return;
+                    if (e.m_node == n) {
+                        if (m_entries[(idx + 1) & mask].m_node == 0) {
+                            e.m_node = 0;
+                        }
+                        else {
+                            e.m_node = deleted();
+                            m_num_deleted++;
+                        }
+                        m_size--;
+                        return;
+                    }
+                    idx = (idx + 1) & mask;
+                }
+            }
 
-        void display(std::ostream & out) const;
+            unsigned size() const { return m_size; }
 
-        void display_compact(std::ostream & out) const;
-#ifdef Z3DEBUG
-        bool check_invariant() const;
-#endif
-    };
-#else 
-    // one table per function symbol
+            unsigned capacity() const { return m_entries.size(); }
 
-    /**
-       \brief Congruence table.
-    */
-    class cg_table {
-        struct cg_unary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 1);
-                return n->get_arg(0)->get_root()->hash();
+            template<typename Proc>
+            void for_each(Proc & proc) const {
+                for (entry const & e : m_entries)
+                    if (e.m_node != 0 && e.m_node != deleted())
+                        proc(e.m_node, e.m_hash);
             }
         };
 
@@ -132,56 +194,17 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
-        
-        struct cg_binary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                // too many collisions
-                // unsigned r = 17 + n->get_arg(0)->get_root()->hash();
-                // return r * 31 + n->get_arg(1)->get_root()->hash();
-                return combine_hash(n->get_arg(0)->get_root()->hash(), n->get_arg(1)->get_root()->hash());
-            }
-        };
-
         struct cg_binary_eq {
             bool operator()(enode * n1, enode * n2) const {
                 SASSERT(n1->get_num_args() == 2);
                 SASSERT(n2->get_num_args() == 2);
                 SASSERT(n1->get_decl() == n2->get_decl());
-#if 1
-                return 
+                return
                     n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
                     n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-#else
-                bool r = 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-                static unsigned counter = 0;
-                static unsigned failed  = 0;
-                if (!r) 
-                    failed++;
-                counter++;
-                if (counter % 100000 == 0) 
-                    std::cerr << "[cg_eq] " << counter << " " << failed << "\n";
-                return r;
-#endif
             }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
-        
-        struct cg_comm_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                unsigned h1 = n->get_arg(0)->get_root()->hash();
-                unsigned h2 = n->get_arg(1)->get_root()->hash();
-                if (h1 > h2)
-                    std::swap(h1, h2);
-                return hash_u((h1 << 16) | (h2 & 0xFFFF));
-            }
-        };
-        
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
@@ -204,17 +227,14 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
-
-        struct cg_hash {
-            unsigned operator()(enode * n) const;
-        };
-
         struct cg_eq {
             bool operator()(enode * n1, enode * n2) const;
         };
 
-        typedef chashtable<enode*, cg_hash, cg_eq> table;
+        typedef sig_table<cg_unary_eq>  unary_table;
+        typedef sig_table<cg_binary_eq> binary_table;
+        typedef sig_table<cg_comm_eq>   comm_table;
+        typedef sig_table<cg_eq>        table;
 
         ast_manager &                 m_manager;
         bool                          m_commutativity; //!< true if the last found congruence used commutativity
@@ -230,7 +250,7 @@ namespace smt {
 
         void * mk_table_for(func_decl * d);
         unsigned set_func_decl_id(enode * n);
-        
+
         void * get_table(enode * n) {
             unsigned tid = n->get_func_decl_id();
             if (tid == UINT_MAX)
@@ -239,106 +259,152 @@ namespace smt {
             return m_tables[tid];
         }
 
-    public:
-        cg_table(ast_manager & m);
-        ~cg_table();
+        static unsigned arg_weight(unsigned i) {
+            return 2 * i * 0x9e3779b9 + 1;
+        }
 
         /**
-           \brief Try to insert n into the table. If the table already
-           contains an element n' congruent to n, then do nothing and
-           return n' and a boolean indicating whether n and n' are congruence
-           modulo commutativity, otherwise insert n and return (n,false).
+           \brief Return the signature hash of n using the current roots of its arguments.
         */
-        enode_bool_pair insert(enode * n) {
-            // it doesn't make sense to insert a constant.
-            SASSERT(n->get_num_args() > 0);
+        static unsigned sig_hash(enode * n, table_kind k) {
+            if (k == BINARY_COMM)
+                return n->get_arg(0)->get_root()->hash() + n->get_arg(1)->get_root()->hash();
+            unsigned num = n->get_num_args();
+            unsigned h   = n->get_arg(0)->get_root()->hash();
+            for (unsigned i = 1; i < num; i++)
+                h += arg_weight(i) * n->get_arg(i)->get_root()->hash();
+            return h;
+        }
+
+        template<typename Proc>
+        void for_each(Proc & proc) const;
+
+        struct display_proc;
+#ifdef Z3DEBUG
+        struct check_proc;
+#endif
+
+        enode_bool_pair insert(enode * n, void * t, unsigned h) {
             enode * n_prime;
-            void * t = get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n, h);
                 return enode_bool_pair(n_prime, false);
             case BINARY:
-                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n, h);
                 return enode_bool_pair(n_prime, false);
             case BINARY_COMM:
                 m_commutativity = false;
-                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n, h);
                 return enode_bool_pair(n_prime, m_commutativity);
             default:
-                n_prime = UNTAG(table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(table*, t)->insert_if_not_there(n, h);
                 return enode_bool_pair(n_prime, false);
             }
         }
 
+    public:
+        cg_table(ast_manager & m);
+        ~cg_table();
+
+        /**
+           \brief Try to insert n into the table. If the table already
+           contains an element n' congruent to n, then do nothing and
+           return n' and a boolean indicating whether n and n' are congruence
+           modulo commutativity, otherwise insert n and return (n,false).
+        */
+        enode_bool_pair insert(enode * n) {
+            // it doesn't make sense to insert a constant.
+            SASSERT(n->get_num_args() > 0);
+            void * t   = get_table(n);
+            unsigned h = sig_hash(n, static_cast<table_kind>(GET_TAG(t)));
+            n->set_cg_hash(h);
+            return insert(n, t, h);
+        }
+
+        /**
+           \brief Similar to insert, but use the signature hash cached in n.
+           It must have been updated using update_hash after n was erased.
+        */
+        enode_bool_pair reinsert(enode * n) {
+            SASSERT(n->get_num_args() > 0);
+            void * t = get_table(n);
+            SASSERT(n->get_cg_hash() == sig_hash(n, static_cast<table_kind>(GET_TAG(t))));
+            return insert(n, t, n->get_cg_hash());
+        }
+
+        /**
+           \brief Update the signature hash cached in n, which is not in the table,
+           for merging the root r1 of some of its arguments with the root r2.
+           The arguments of n must not have been merged yet.
+        */
+        void update_hash(enode * n, enode * r1, enode * r2);
+
         void erase(enode * n) {
             SASSERT(n->get_num_args() > 0);
-            void * t = get_table(n); 
+            void * t   = get_table(n);
+            unsigned h = n->get_cg_hash();
+            SASSERT(h == sig_hash(n, static_cast<table_kind>(GET_TAG(t))));
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                UNTAG(unary_table*, t)->erase(n);
+                UNTAG(unary_table*, t)->erase(n, h);
                 break;
             case BINARY:
-                UNTAG(binary_table*, t)->erase(n);
+                UNTAG(binary_table*, t)->erase(n, h);
                 break;
             case BINARY_COMM:
-                UNTAG(comm_table*, t)->erase(n);
+                UNTAG(comm_table*, t)->erase(n, h);
                 break;
             default:
-                UNTAG(table*, t)->erase(n);
+                UNTAG(table*, t)->erase(n, h);
                 break;
             }
         }
 
         bool contains(enode * n) const {
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
-            case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
-            default:
-                return UNTAG(table*, t)->contains(n);
-            }
+            return find(n) != 0;
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = 0;
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
+            void * t   = const_cast<cg_table*>(this)->get_table(n);
+            unsigned h = sig_hash(n, static_cast<table_kind>(GET_TAG(t)));
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(unary_table*, t)->find(n, h);
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(binary_table*, t)->find(n, h);
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(comm_table*, t)->find(n, h);
             default:
-                return UNTAG(table*, t)->find(n, r) ? r : 0;
+                return UNTAG(table*, t)->find(n, h);
             }
         }
 
+        /**
+           \brief Return true if n itself is in the table.
+           If n is in the table, then the signature hash cached in n is the one used to insert it.
+        */
         bool contains_ptr(enode * n) const {
-            enode * r;
             SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
+            void * t   = const_cast<cg_table*>(this)->get_table(n);
+            unsigned h = n->get_cg_hash();
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
+                return UNTAG(unary_table*, t)->contains_ptr(n, h);
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
+                return UNTAG(binary_table*, t)->contains_ptr(n, h);
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
+                return UNTAG(comm_table*, t)->contains_ptr(n, h);
             default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
+                return UNTAG(table*, t)->contains_ptr(n, h);
             }
         }
 
         void reset();
 
+        unsigned size() const;
+
         void display(std::ostream & out) const;
 
         void display_compact(std::ostream & out) const;
@@ -347,8 +413,6 @@ namespace smt {
 #endif
     };
 
-#endif 
 };
 
 #endif /* SMT_CG_TABLE_H_ */
-
@@ -26,11 +26,11 @@ namespace smt {
        bool_var2expr_map is a mapping from bool_var -> expr, it is only used if save_atoms == true.
     */
     clause * clause::mk(ast_manager & m, unsigned num_lits, literal * lits, clause_kind k, justification * js, 
-                        clause_del_eh * del_eh, bool save_atoms, expr * const * bool_var2expr_map) {
+                        clause_del_eh * del_eh, bool save_atoms, expr * const * bool_var2expr_map, lemma_store * store) {
         SASSERT(k == CLS_AUX || js == 0 || !js->in_region());
         SASSERT(num_lits >= 2);
         unsigned sz                = get_obj_size(num_lits, k, save_atoms, del_eh != 0, js != 0);
-        void * mem                 = m.get_allocator().allocate(sz);
+        void * mem                 = k != CLS_AUX && store ? store->allocate(sz) : m.get_allocator().allocate(sz);
         clause * cls               = new (mem) clause();
         cls->m_num_literals        = num_lits;
         cls->m_capacity            = num_lits;
@@ -43,8 +43,10 @@ namespace smt {
         cls->m_deleted             = false;
         SASSERT(!m.proofs_enabled() || js != 0);
         memcpy(cls->m_lits, lits, sizeof(literal) * num_lits);
-        if (cls->is_lemma())
+        if (cls->is_lemma()) {
             cls->set_activity(1);
+            cls->set_glue(num_lits);
+        }
         if (del_eh)
             *(const_cast<clause_del_eh **>(cls->get_del_eh_addr())) = del_eh;
         if (js)
@@ -68,7 +70,7 @@ namespace smt {
         return cls;
     }
     
-    void clause::deallocate(ast_manager & m) {
+    void clause::deallocate(ast_manager & m, lemma_store * store) {
         clause_del_eh * del_eh = get_del_eh();
         if (del_eh)
             (*del_eh)(m, this);
@@ -85,7 +87,106 @@ namespace smt {
             SASSERT(m_reinit || get_atom(i) == 0);
             m.dec_ref(get_atom(i));
         }
-        m.get_allocator().deallocate(get_obj_size(m_capacity, get_kind(), m_has_atoms, m_has_del_eh, m_has_justification), this);
+        unsigned sz = get_obj_size(m_capacity, get_kind(), m_has_atoms, m_has_del_eh, m_has_justification);
+        if (is_lemma() && store)
+            store->deallocate(this, sz);
+        else
+            m.get_allocator().deallocate(sz, this);
+    }
+
+    clause * clause::relocate(lemma_store & store) {
+        SASSERT(is_lemma());
+        SASSERT(!m_reinit);
+        unsigned sz = get_obj_size(m_capacity, get_kind(), m_has_atoms, m_has_del_eh, m_has_justification);
+        void * mem  = store.allocate(sz);
+        // the layout of a clause does not depend on its address.
+        memcpy(mem, this, sz);
+        store.deallocate(this, sz);
+        return static_cast<clause *>(mem);
+    }
+
+    lemma_store::~lemma_store() {
+        for (unsigned i = 0; i < m_pages.size(); ++i) {
+            dealloc_svect(m_pages[i].m_data);
+        }
+    }
+
+    /**
+       \brief return the index of the page containing p.
+    */
+    unsigned lemma_store::find(void const * p) const {
+        char const * c = static_cast<char const *>(p);
+        unsigned lo = 0, hi = m_pages.size();
+        while (hi - lo > 1) {
+            unsigned mid = (lo + hi) / 2;
+            if (m_pages[mid].m_data <= c)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        SASSERT(m_pages[lo].m_data <= c && c < m_pages[lo].m_data + m_pages[lo].m_capacity);
+        return lo;
+    }
+
+    void * lemma_store::allocate(size_t sz) {
+        sz = (sz + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+        if (m_curr) {
+            page & p = m_pages[find(m_curr)];
+            if (p.m_used + sz <= p.m_capacity) {
+                void * r = p.m_data + p.m_used;
+                p.m_used += sz;
+                p.m_live += sz;
+                m_live   += sz;
+                return r;
+            }
+            m_curr = 0;
+            if (p.m_live == 0)
+                del_page(find(p.m_data));
+        }
+        page p;
+        p.m_capacity = std::max(PAGE_SIZE, sz);
+        p.m_data     = alloc_svect(char, p.m_capacity);
+        p.m_used     = sz;
+        p.m_live     = sz;
+        m_capacity  += p.m_capacity;
+        m_live      += sz;
+        m_curr       = p.m_data;
+        unsigned i   = m_pages.size();
+        m_pages.push_back(p);
+        for (; i > 0 && m_pages[i - 1].m_data > p.m_data; --i) {
+            m_pages[i] = m_pages[i - 1];
+        }
+        m_pages[i] = p;
+        return p.m_data;
+    }
+
+    void lemma_store::deallocate(void * ptr, size_t sz) {
+        sz = (sz + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+        unsigned i = find(ptr);
+        page & p = m_pages[i];
+        SASSERT(p.m_live >= sz);
+        p.m_live -= sz;
+        m_live   -= sz;
+        if (p.m_live > 0)
+            return;
+        if (p.m_data == m_curr)
+            p.m_used = 0;
+        else
+            del_page(i);
+    }
+
+    void lemma_store::del_page(unsigned i) {
+        m_capacity -= m_pages[i].m_capacity;
+        dealloc_svect(m_pages[i].m_data);
+        for (; i + 1 < m_pages.size(); ++i) {
+            m_pages[i] = m_pages[i + 1];
+        }
+        m_pages.pop_back();
+    }
+
+    bool lemma_store::is_sparse(void const * ptr) const {
+        page const & p = m_pages[find(ptr)];
+        return p.m_data != m_curr && 2 * p.m_live < p.m_used;
     }
 
     void clause::release_atoms(ast_manager & m) {
@@ -29,6 +29,46 @@ namespace smt {
 
     class clause;
 
+    /**
+       \brief Memory for lemmas.
+
+       Lemmas are allocated consecutively in pages, and a page is released
+       when all lemmas allocated in it are deleted. The memory of a deleted
+       lemma is not reused, instead the context moves the lemmas of sparsely
+       used pages (see context::compact_lemmas), so that these pages become
+       empty.
+    */
+    class lemma_store {
+        struct page {
+            char *   m_data;
+            size_t   m_capacity;
+            size_t   m_used;
+            size_t   m_live;
+        };
+        static const size_t PAGE_SIZE = 64 * 1024;
+        svector<page>   m_pages;     // sorted by address
+        char *          m_curr;      // page used for allocation
+        size_t          m_capacity;
+        size_t          m_live;
+        unsigned find(void const * p) const;
+        void del_page(unsigned i);
+    public:
+        lemma_store(): m_curr(0), m_capacity(0), m_live(0) {}
+        ~lemma_store();
+        void * allocate(size_t sz);
+        void deallocate(void * p, size_t sz);
+        /**
+           \brief return true if less than half of the page containing p is in use.
+        */
+        bool is_sparse(void const * p) const;
+        /**
+           \brief return true if less than half of the memory of the store is in use.
+        */
+        bool is_fragmented() const { return m_capacity > 2 * m_live + PAGE_SIZE; }
+        size_t capacity() const { return m_capacity; }
+        size_t live() const { return m_live; }
+    };
+
     /**
        \brief Abstract functor: clause deletion event handler.
     */
@@ -64,7 +104,7 @@ namespace smt {
         static unsigned get_obj_size(unsigned num_lits, clause_kind k, bool has_atoms, bool has_del_eh, bool has_justification) {
             unsigned r = sizeof(clause) + sizeof(literal) * num_lits;
             if (k != CLS_AUX)
-                r += sizeof(unsigned);
+                r += 2 * sizeof(unsigned); // activity and glue
             /* dvitek: Fix alignment issues on 64-bit platforms.  The
              * 'if' statement below probably isn't worthwhile since
              * I'm guessing the allocator is probably going to round
@@ -92,7 +132,7 @@ namespace smt {
         clause_del_eh * const * get_del_eh_addr() const {
             unsigned const * addr = get_activity_addr();
             if (is_lemma())
-                addr ++;
+                addr += 2;
             /* dvitek: It would be better to use uintptr_t than
              * size_t, but we need to wait until c++11 support is
              * really available.
@@ -149,10 +189,20 @@ namespace smt {
         void release_atoms(ast_manager & m);
         
     public:
+        /**
+           \brief Create a new clause. Lemmas are allocated in store if it is not 0.
+        */
         static clause * mk(ast_manager & m, unsigned num_lits, literal * lits, clause_kind k, justification * js = 0, 
-                           clause_del_eh * del_eh = 0, bool save_atoms = false, expr * const * bool_var2expr_map = 0);
+                           clause_del_eh * del_eh = 0, bool save_atoms = false, expr * const * bool_var2expr_map = 0,
+                           lemma_store * store = 0);
         
-        void deallocate(ast_manager & m);
+        void deallocate(ast_manager & m, lemma_store * store = 0);
+
+        /**
+           \brief Move a lemma allocated in store to fresh memory of the store.
+           The old copy is released.
+        */
+        clause * relocate(lemma_store & store);
         
         clause_kind get_kind() const {
             return static_cast<clause_kind>(m_kind);
@@ -239,6 +289,19 @@ namespace smt {
             set_activity(get_activity() + 1);
         }
 
+        /**
+           \brief number of distinct decision levels of the literals of a lemma (LBD).
+        */
+        unsigned get_glue() const {
+            SASSERT(is_lemma());
+            return get_activity_addr()[1];
+        }
+
+        void set_glue(unsigned glue) {
+            SASSERT(is_lemma());
+            get_activity_addr()[1] = glue;
+        }
+
         void display(std::ostream & out, ast_manager & m, expr * const * bool_var2expr_map) const;
 
         void display_compact(std::ostream & out, ast_manager & m, expr * const * bool_var2expr_map) const;
@@ -342,6 +342,10 @@ namespace smt {
                 m_lemma_atoms.push_back(m_ctx.bool_var2expr(var));
             }
         }
+        else if (lvl <= m_ctx.get_base_level() && m_ctx.get_qi_trace()) {
+            // literals of the base level are not resolved, their instances are reported by trace_qi_antecedents.
+            m_qi_todo.push_back(antecedent);
+        }
     }
 
     void conflict_resolution::process_justification(justification * js, unsigned & num_marks) {
@@ -409,6 +413,8 @@ namespace smt {
                 mk_conflict_proof(conflict, not_l);
             if (m_ctx.tracking_assumptions())
                 mk_unsat_core(conflict, not_l);
+            if (m_ctx.get_qi_trace())
+                trace_qi_refutation(conflict, not_l);
             return false;
         }
 
@@ -522,8 +528,13 @@ namespace smt {
             switch (js.get_kind()) {
             case b_justification::CLAUSE: {
                 clause * cls = js.get_clause();
-                if (cls->is_lemma())
+                if (cls->is_lemma()) {
                     cls->inc_clause_activity();
+                    m_ctx.update_glue(cls);
+                }
+                else if (qi_trace * t = m_ctx.get_qi_trace()) {
+                    t->resolve_eh(cls->get_num_literals(), cls->begin_literals());
+                }
                 unsigned num_lits = cls->get_num_literals();
                 unsigned i        = 0;
                 if (consequent != false_literal) {
@@ -550,11 +561,17 @@ namespace smt {
             }
             case b_justification::BIN_CLAUSE:
                 SASSERT(consequent.var() != js.get_literal().var());
+                if (qi_trace * t = m_ctx.get_qi_trace())
+                    t->resolve_eh(consequent, ~js.get_literal());
                 process_antecedent(js.get_literal(), num_marks);
                 break;
             case b_justification::AXIOM:
+                if (qi_trace * t = m_ctx.get_qi_trace())
+                    t->resolve_eh(consequent);
                 break;
             case b_justification::JUSTIFICATION:
+                if (qi_trace * t = m_ctx.get_qi_trace())
+                    t->resolve_eh(consequent);
                 process_justification(js.get_justification(), num_marks);
                 break;
             default:
@@ -597,6 +614,9 @@ namespace smt {
 
         finalize_resolve(conflict, not_l);
 
+        if (!m_qi_todo.empty())
+            trace_qi_antecedents();
+
         return true;
     }
 
@@ -1470,6 +1490,73 @@ namespace smt {
         reset_unmark_and_justifications(0, 0);
     }
 
+    /**
+       \brief Report the instances of the clause or unit that justifies consequent,
+       and add its antecedents to m_qi_todo.
+    */
+    void conflict_resolution::trace_qi_justification(literal consequent, b_justification js) {
+        qi_trace * t = m_ctx.get_qi_trace();
+        switch (js.get_kind()) {
+        case b_justification::CLAUSE: {
+            clause * cls = js.get_clause();
+            if (!cls->is_lemma())
+                t->resolve_eh(cls->get_num_literals(), cls->begin_literals());
+            unsigned num_lits = cls->get_num_literals();
+            for (unsigned i = 0; i < num_lits; i++) {
+                literal l = cls->get_literal(i);
+                if (l != consequent)
+                    m_qi_todo.push_back(~l);
+            }
+            if (cls->get_justification())
+                justification2literals(cls->get_justification(), m_qi_todo);
+            break;
+        }
+        case b_justification::BIN_CLAUSE:
+            t->resolve_eh(consequent, ~js.get_literal());
+            m_qi_todo.push_back(js.get_literal());
+            break;
+        case b_justification::AXIOM:
+            t->resolve_eh(consequent);
+            break;
+        case b_justification::JUSTIFICATION:
+            t->resolve_eh(consequent);
+            justification2literals(js.get_justification(), m_qi_todo);
+            break;
+        default:
+            UNREACHABLE();
+        }
+    }
+
+    /**
+       \brief Report the instances used to derive the literals in m_qi_todo.
+       These are literals that are not resolved: literals of the base level,
+       and the literals of a conflict at the search level. A literal is traversed
+       once while it is assigned.
+    */
+    void conflict_resolution::trace_qi_antecedents() {
+        qi_trace * t = m_ctx.get_qi_trace();
+        while (!m_qi_todo.empty()) {
+            literal l = m_qi_todo.back();
+            m_qi_todo.pop_back();
+            bool_var v = l.var();
+            if (v == true_bool_var || t->is_visited(v))
+                continue;
+            t->set_visited(v, m_ctx.get_assign_level(v));
+            trace_qi_justification(l, m_ctx.get_justification(v));
+        }
+    }
+
+    void conflict_resolution::trace_qi_refutation(b_justification conflict, literal not_l) {
+        SASSERT(m_qi_todo.empty());
+        literal consequent = false_literal;
+        if (not_l != null_literal) {
+            consequent = ~not_l;
+            m_qi_todo.push_back(not_l);
+        }
+        trace_qi_justification(consequent, conflict);
+        trace_qi_antecedents();
+    }
+
     conflict_resolution * mk_conflict_resolution(ast_manager & m,
                                                  context & ctx,
                                                  dyn_ack_manager & dack_manager,
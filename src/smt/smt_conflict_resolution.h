@@ -196,6 +196,11 @@ namespace smt {
         void process_justification_for_unsat_core(justification * js);
         void mk_unsat_core(b_justification conflict, literal not_l);
 
+        literal_vector m_qi_todo; // literals whose antecedents are reported to the quantifier instantiation trace.
+        void trace_qi_justification(literal consequent, b_justification js);
+        void trace_qi_antecedents();
+        void trace_qi_refutation(b_justification conflict, literal not_l);
+
         bool initialize_resolve(b_justification conflict, literal not_l, b_justification & js, literal & consequent);
         void finalize_resolve(b_justification conflict, literal not_l);
       
@@ -34,6 +34,7 @@ Revision History:
 #include "smt/smt_model_generator.h"
 #include "smt/smt_model_checker.h"
 #include "smt/smt_model_finder.h"
+#include "smt/smt_parallel.h"
 #include "model/model_pp.h"
 #include "ast/ast_smt2_pp.h"
 #include "ast/ast_translation.h"
@@ -53,6 +54,8 @@ namespace smt {
         m_flushing(false),
         m_progress_callback(0),
         m_next_progress_sample(0),
+        m_par(0),
+        m_par_id(0),
         m_fingerprints(m_region),
         m_b_internalized_stack(m),
         m_e_internalized_stack(m),
@@ -60,6 +63,7 @@ namespace smt {
         m_cg_table(m),
         m_dyn_ack_manager(*this, p),
         m_is_diseq_tmp(0),
+        m_glue_stamp(0),
         m_units_to_reassert(m_manager),
         m_qhead(0),
         m_simp_qhead(0),
@@ -68,6 +72,10 @@ namespace smt {
         m_phase_cache_on(true),
         m_phase_counter(0),
         m_phase_default(false),
+        m_target_trail_size(0),
+        m_best_trail_size(0),
+        m_rephase_count(0),
+        m_next_rephase(0),
         m_conflict(null_b_justification),
         m_not_l(null_literal),
         m_conflict_resolution(mk_conflict_resolution(m, *this, m_dyn_ack_manager, p, m_assigned_literals, m_watches)),
@@ -91,6 +99,9 @@ namespace smt {
 
         m_case_split_queue = mk_case_split_queue(*this, p);
 
+        if (!p.m_qi_trace_file.empty())
+            m_qi_trace = alloc(qi_trace, m, p.m_qi_trace_file.c_str());
+
         init();
 
         if (!relevancy())
@@ -133,15 +144,15 @@ namespace smt {
     }
 
 
-    void context::copy(context& src_ctx, context& dst_ctx) {
+    void context::copy(context& src_ctx, context& dst_ctx, bool override_base) {
         ast_manager& dst_m = dst_ctx.get_manager();
         ast_manager& src_m = src_ctx.get_manager();
         src_ctx.pop_to_base_lvl();
 
-        if (src_ctx.m_base_lvl > 0) {
+        if (!override_base && src_ctx.m_base_lvl > 0) {
             throw default_exception("Cloning contexts within a user-scope is not allowed");
         }
-        SASSERT(src_ctx.m_base_lvl == 0);
+        SASSERT(override_base || src_ctx.m_base_lvl == 0);
 
         ast_translation tr(src_m, dst_m, false);
 
@@ -480,27 +491,11 @@ namespace smt {
         m_th_diseq_propagation_queue.push_back(new_th_eq(th, lhs, rhs));
     }
 
-    class add_eq_trail : public trail<context> {
-        enode * m_r1;
-        enode * m_n1;
-        unsigned m_r2_num_parents;
-    public:
-        add_eq_trail(enode * r1, enode * n1, unsigned r2_num_parents):
-            m_r1(r1),
-            m_n1(n1),
-            m_r2_num_parents(r2_num_parents) {
-        }
-
-        virtual void undo(context & ctx) {
-            ctx.undo_add_eq(m_r1, m_n1, m_r2_num_parents);
-        }
-    };
-
     /**
        \brief Add the equality n1 = n2 with justification js into the logical context.
     */
     void context::add_eq(enode * n1, enode * n2, eq_justification js) {
-        unsigned old_trail_size = m_trail_stack.size();
+        unsigned old_trail_size = m_trail_kinds.size();
 
         try {
             TRACE("add_eq", tout << "assigning: #" << n1->get_owner_id() << " = #" << n2->get_owner_id() << "\n";);
@@ -555,7 +550,7 @@ namespace smt {
                 mark_as_relevant(r1);
             }
 
-            push_trail(add_eq_trail(r1, n1, r2->get_num_parents()));
+            push_eq_trail(r1, n1, r2->get_num_parents());
 
             m_qmanager->add_eq_eh(r1, r2);
 
@@ -591,7 +586,7 @@ namespace smt {
 #endif
 
 
-            remove_parents_from_cg_table(r1);
+            remove_parents_from_cg_table(r1, r2);
 
             enode * curr = r1;
             do {
@@ -617,8 +612,8 @@ namespace smt {
         }
         catch (...) {
             // Restore trail size since procedure was interrupted in the middle.
-            // If the add_eq_trail remains on the trail stack, then Z3 may crash when the destructor is invoked.
-            m_trail_stack.shrink(old_trail_size);
+            // If the merge remains on the trail, then Z3 may crash when the destructor is invoked.
+            discard_trail(old_trail_size);
             throw;
         }
     }
@@ -626,8 +621,9 @@ namespace smt {
     /**
        \brief When merging to equivalence classes, the parents of the smallest one (that are congruence roots),
        must be removed from the congruence table since their hash code will change.
+       The hash code cached in the parents is updated for the merge of r1 into r2.
     */
-    void context::remove_parents_from_cg_table(enode * r1) {
+    void context::remove_parents_from_cg_table(enode * r1, enode * r2) {
         // Remove parents from the congruence table
         enode_vector::iterator it  = r1->begin_parents();
         enode_vector::iterator end = r1->end_parents();
@@ -657,6 +653,7 @@ namespace smt {
                 if (parent->is_cgc_enabled()) {
                     m_cg_table.erase(parent);
                     SASSERT(!m_cg_table.contains_ptr(parent));
+                    m_cg_table.update_hash(parent, r1, r2);
                 }
             }
         }
@@ -705,7 +702,7 @@ namespace smt {
                 }
             }
             if (parent->is_cgc_enabled()) {
-                enode_bool_pair pair = m_cg_table.insert(parent);
+                enode_bool_pair pair = m_cg_table.reinsert(parent);
                 enode * parent_prime = pair.first;
                 if (parent_prime == parent) {
                     TRACE("add_eq_parents", tout << "add_eq reinserting: #" << parent->get_owner_id() << "\n";);
@@ -1120,7 +1117,6 @@ namespace smt {
               );
 
 #ifdef Z3DEBUG
-        push_trail(push_back_trail<context, enode_pair, false>(m_diseq_vector));
         m_diseq_vector.push_back(enode_pair(n1, n2));
 #endif
 
@@ -1716,7 +1712,6 @@ namespace smt {
             SASSERT(th);
             th->new_eq_eh(curr.m_lhs, curr.m_rhs);
 #ifdef Z3DEBUG
-            push_trail(push_back_trail<context, new_th_eq, false>(m_propagated_th_eqs));
             m_propagated_th_eqs.push_back(curr);
 #endif
         }
@@ -1730,7 +1725,6 @@ namespace smt {
             SASSERT(th);
             th->new_diseq_eh(curr.m_lhs, curr.m_rhs);
 #ifdef Z3DEBUG
-            push_trail(push_back_trail<context, new_th_eq, false>(m_propagated_th_diseqs));
             m_propagated_th_diseqs.push_back(curr);
 #endif
         }
@@ -1887,7 +1881,11 @@ namespace smt {
                 case PS_CACHING:
                 case PS_CACHING_CONSERVATIVE:
                 case PS_CACHING_CONSERVATIVE2:
-                    if (m_phase_cache_on && d.m_phase_available) {
+                    if (m_fparams.m_phase_target && static_cast<unsigned>(var) < m_target_phase.size() && m_target_phase[var] != l_undef) {
+                        TRACE("phase_selection", tout << "using target phase: " << m_target_phase[var] << ", var: p" << var << "\n";);
+                        is_pos = m_target_phase[var] == l_true;
+                    }
+                    else if (m_phase_cache_on && d.m_phase_available) {
                         TRACE("phase_selection", tout << "using cached value, is_pos: " << m_bdata[var].m_phase << ", var: p" << var << "\n";);
                         is_pos = m_bdata[var].m_phase;
                     }
@@ -1962,12 +1960,19 @@ namespace smt {
 
         m_relevancy_propagator->push();
         s.m_assigned_literals_lim    = m_assigned_literals.size();
-        s.m_trail_stack_lim          = m_trail_stack.size();
+        s.m_trail_stack_lim          = m_trail_kinds.size();
         s.m_aux_clauses_lim          = m_aux_clauses.size();
         s.m_justifications_lim       = m_justifications.size();
         s.m_units_to_reassert_lim    = m_units_to_reassert.size();
+#ifdef Z3DEBUG
+        s.m_propagated_th_eqs_lim    = m_propagated_th_eqs.size();
+        s.m_propagated_th_diseqs_lim = m_propagated_th_diseqs.size();
+        s.m_diseq_vector_lim         = m_diseq_vector.size();
+#endif
 
         m_qmanager->push();
+        if (m_qi_trace)
+            m_qi_trace->push_scope();
 
         m_fingerprints.push_scope();
         m_case_split_queue->push_scope();
@@ -1984,7 +1989,81 @@ namespace smt {
        \brief Execute generic undo-objects.
     */
     void context::undo_trail_stack(unsigned old_size) {
-        ::undo_trail_stack(*this, m_trail_stack, old_size);
+        SASSERT(old_size <= m_trail_kinds.size());
+        unsigned i = m_trail_kinds.size();
+        while (i > old_size) {
+            --i;
+            switch (m_trail_kinds[i]) {
+            case GENERIC_TRAIL:
+                m_trail_stack.back()->undo(*this);
+                m_trail_stack.pop_back();
+                break;
+            case EQ_TRAIL:
+                undo_add_eq(m_eq_trail_r1.back(), m_eq_trail_n1.back(), m_eq_trail_r2_num_parents.back());
+                m_eq_trail_r1.pop_back();
+                m_eq_trail_n1.pop_back();
+                m_eq_trail_r2_num_parents.pop_back();
+                break;
+            case UNSIGNED_TRAIL: {
+                // restore a run of values of the same kind in one sweep.
+                unsigned j = m_unsigned_trail_ptrs.size();
+                for (;;) {
+                    --j;
+                    *m_unsigned_trail_ptrs[j] = m_unsigned_trail_values[j];
+                    if (i == old_size || m_trail_kinds[i - 1] != UNSIGNED_TRAIL)
+                        break;
+                    --i;
+                }
+                m_unsigned_trail_ptrs.shrink(j);
+                m_unsigned_trail_values.shrink(j);
+                break;
+            }
+            case BOOL_TRAIL: {
+                unsigned j = m_bool_trail_ptrs.size();
+                for (;;) {
+                    --j;
+                    *m_bool_trail_ptrs[j] = m_bool_trail_values[j];
+                    if (i == old_size || m_trail_kinds[i - 1] != BOOL_TRAIL)
+                        break;
+                    --i;
+                }
+                m_bool_trail_ptrs.shrink(j);
+                m_bool_trail_values.shrink(j);
+                break;
+            }
+            default:
+                UNREACHABLE();
+            }
+        }
+        m_trail_kinds.shrink(old_size);
+    }
+
+    /**
+       \brief Drop trail entries without undoing them.
+    */
+    void context::discard_trail(unsigned old_size) {
+        SASSERT(old_size <= m_trail_kinds.size());
+        for (unsigned i = old_size; i < m_trail_kinds.size(); ++i) {
+            switch (m_trail_kinds[i]) {
+            case GENERIC_TRAIL:
+                m_trail_stack.pop_back();
+                break;
+            case EQ_TRAIL:
+                m_eq_trail_r1.pop_back();
+                m_eq_trail_n1.pop_back();
+                m_eq_trail_r2_num_parents.pop_back();
+                break;
+            case UNSIGNED_TRAIL:
+                m_unsigned_trail_ptrs.pop_back();
+                m_unsigned_trail_values.pop_back();
+                break;
+            case BOOL_TRAIL:
+                m_bool_trail_ptrs.pop_back();
+                m_bool_trail_values.pop_back();
+                break;
+            }
+        }
+        m_trail_kinds.shrink(old_size);
     }
 
     /**
@@ -2023,7 +2102,7 @@ namespace smt {
         SASSERT(m_flushing || !cls->in_reinit_stack());
         if (!cls->deleted())
             remove_cls_occs(cls);
-        cls->deallocate(m_manager);
+        cls->deallocate(m_manager, &m_lemma_store);
         m_stats.m_num_del_clause++;
     }
 
@@ -2417,6 +2496,8 @@ namespace smt {
 
             cache_generation(new_lvl);
             m_qmanager->pop(num_scopes);
+            if (m_qi_trace)
+                m_qi_trace->pop_scope(num_scopes);
             m_case_split_queue->pop_scope(num_scopes);
 
             TRACE("pop_scope", tout << "backtracking: " << num_scopes << ", new_lvl: " << new_lvl << "\n";);
@@ -2447,6 +2528,11 @@ namespace smt {
             m_fingerprints.pop_scope(num_scopes);
             unassign_vars(s.m_assigned_literals_lim);
             undo_trail_stack(s.m_trail_stack_lim);
+#ifdef Z3DEBUG
+            m_propagated_th_eqs.shrink(s.m_propagated_th_eqs_lim);
+            m_propagated_th_diseqs.shrink(s.m_propagated_th_diseqs_lim);
+            m_diseq_vector.shrink(s.m_diseq_vector_lim);
+#endif
 
             for (theory* th : m_theory_set) {
                 th->pop_scope_eh(num_scopes);
@@ -2472,6 +2558,7 @@ namespace smt {
 
             unsigned num_bool_vars = get_num_bool_vars();
             // any variable >= num_bool_vars was deleted during backtracking.
+            shrink_saved_phases(num_bool_vars);
             reinit_clauses(num_scopes, num_bool_vars);
             reassert_units(units_to_reassert_lim);
             TRACE("pop_scope_detail", tout << "end of pop_scope: \n"; display(tout););
@@ -2575,10 +2662,14 @@ namespace smt {
         clause_vector::iterator end = clauses.end();
         it += starting_at;
         clause_vector::iterator it2 = it;
+        literal_buffer old_lits; // literals of the clause before simplification, for the quantifier instantiation trace.
         for(; it != end; ++it) {
             clause * cls = *it;
             SASSERT(!cls->in_reinit_stack());
             TRACE("simplify_clauses_bug", display_clause(tout, cls); tout << "\n";);
+            old_lits.reset();
+            if (m_qi_trace && !cls->is_lemma())
+                old_lits.append(cls->get_num_literals(), cls->begin_literals());
             if (cls->deleted()) {
                 del_clause(cls);
                 num_del_clauses++;
@@ -2625,12 +2716,16 @@ namespace smt {
                         }
                         else
                             m_bdata[v0].set_axiom();
+                        if (!old_lits.empty())
+                            m_qi_trace->axiom_eh(l0, old_lits.size(), old_lits.c_ptr());
                     }
                 }
                 del_clause(cls);
                 num_del_clauses++;
             }
             else {
+                if (old_lits.size() > cls->get_num_literals())
+                    m_qi_trace->simplify_clause_eh(old_lits.size(), old_lits.c_ptr(), cls->get_num_literals(), cls->begin_literals());
                 *it2 = *it;
                 ++it2;
                 m_simp_counter += cls->get_num_literals();
@@ -2715,6 +2810,7 @@ namespace smt {
             del_inactive_lemmas1();
         else
             del_inactive_lemmas2();
+        compact_lemmas();
 
         m_num_conflicts_since_lemma_gc = 0;
         if (m_fparams.m_lemma_gc_strategy == LGC_GEOMETRIC)
@@ -2743,7 +2839,7 @@ namespace smt {
               << ", start_del_at: " << start_del_at << "\n";);
         for (; i < end_at; i++) {
             clause * cls = m_lemmas[i];
-            if (can_delete(cls)) {
+            if (can_delete(cls) && !is_glue_lemma(cls)) {
                 TRACE("del_inactive_lemmas", tout << "deleting: "; display_clause(tout, cls); tout << ", activity: " <<
                       cls->get_activity() << "\n";);
                 del_clause(cls);
@@ -2807,9 +2903,10 @@ namespace smt {
                 }
                 // A clause is deleted if it has low activity and the number of unknowns is greater than a threshold.
                 // The activity threshold depends on how old the clause is.
+                // Lemmas with low glue are kept.
                 unsigned act_threshold = m_fparams.m_old_clause_activity -
                     (m_fparams.m_old_clause_activity - m_fparams.m_new_clause_activity) * ((i - start_at) / real_sz);
-                if (cls->get_activity() < act_threshold) {
+                if (cls->get_activity() < act_threshold && !is_glue_lemma(cls)) {
                     unsigned rel_threshold = (i >= new_first_idx ? m_fparams.m_new_clause_relevancy : m_fparams.m_old_clause_relevancy);
                     if (more_than_k_unassigned_literals(cls, rel_threshold)) {
                         del_clause(cls);
@@ -2827,6 +2924,42 @@ namespace smt {
         IF_VERBOSE(2, verbose_stream() << " :num-deleted-clauses " << num_del_cls << ")" << std::endl;);
     }
 
+    /**
+       \brief Move the lemmas allocated in sparsely used pages of the lemma store,
+       so that these pages are released. Lemmas that are referenced from outside
+       of the watch lists, m_lemmas and the literal occurrences cannot be moved.
+    */
+    void context::compact_lemmas() {
+        if (!m_fparams.m_lemma_gc_compact || inconsistent() || !m_lemma_store.is_fragmented())
+            return;
+        IF_VERBOSE(2, verbose_stream() << "(smt.compact-lemmas :capacity " << m_lemma_store.capacity()
+                   << " :live " << m_lemma_store.live(); verbose_stream().flush(););
+        unsigned num_moved = 0;
+        for (unsigned i = 0; i < m_lemmas.size(); i++) {
+            clause * cls = m_lemmas[i];
+            if (!m_lemma_store.is_sparse(cls) || !can_move(cls))
+                continue;
+            bool occs = lit_occs_enabled();
+            if (occs)
+                remove_lit_occs(cls);
+            literal l1 = cls->get_literal(0);
+            literal l2 = cls->get_literal(1);
+            clause * new_cls = cls->relocate(m_lemma_store);
+            watch_list::clause_iterator it1 = m_watches[(~l1).index()].find_clause(cls);
+            watch_list::clause_iterator it2 = m_watches[(~l2).index()].find_clause(cls);
+            SASSERT(it1 != m_watches[(~l1).index()].end_clause());
+            SASSERT(it2 != m_watches[(~l2).index()].end_clause());
+            *it1 = new_cls;
+            *it2 = new_cls;
+            if (occs)
+                add_lit_occs(new_cls);
+            m_lemmas[i] = new_cls;
+            num_moved++;
+        }
+        m_stats.m_num_moved_lemmas += num_moved;
+        IF_VERBOSE(2, verbose_stream() << " :moved " << num_moved << " :new-capacity " << m_lemma_store.capacity() << ")" << std::endl;);
+    }
+
     /**
        \brief Return true if "cls" has more than (or equal to) k unassigned literals.
     */
@@ -3445,6 +3578,12 @@ namespace smt {
         m_dyn_ack_manager              .init_search_eh();
         m_final_check_idx              = 0;
         m_phase_default                = false;
+        m_target_phase                 .reset();
+        m_target_trail_size            = 0;
+        m_best_phase                   .reset();
+        m_best_trail_size              = 0;
+        m_rephase_count                = 0;
+        m_next_rephase                 = m_fparams.m_rephase_base;
         m_case_split_queue             ->init_search_eh();
         m_next_progress_sample         = 0;
         TRACE("literal_occ", display_literal_num_occs(tout););
@@ -3453,6 +3592,8 @@ namespace smt {
 
     void context::end_search() {
         m_case_split_queue ->end_search_eh();
+        if (m_qi_trace)
+            m_qi_trace->flush();
     }
 
     void context::inc_limits() {
@@ -3580,6 +3721,8 @@ namespace smt {
                 pop_scope(m_scope_lvl - curr_lvl);
                 SASSERT(at_search_level());
             }
+            if (should_rephase())
+                rephase();
             ptr_vector<theory>::iterator it  = m_theory_set.begin();
             ptr_vector<theory>::iterator end = m_theory_set.end();
             for (; it != end && !inconsistent(); ++it)
@@ -3588,6 +3731,14 @@ namespace smt {
             if (!inconsistent()) {
                 m_qmanager->restart_eh();
             }
+            if (m_qi_trace)
+                m_qi_trace->flush();
+            if (!inconsistent() && m_par && !m_par->exchange(*this)) {
+                // another worker of the portfolio solved the problem.
+                m_last_search_failure = CANCELED;
+                status = l_undef;
+                return false;
+            }
             if (inconsistent()) {
                 VERIFY(!resolve_conflict());
                 status = l_false;
@@ -3704,6 +3855,11 @@ namespace smt {
             if (m_last_search_failure != OK)
                 return true;
 
+            if (m_par && m_par->done()) {
+                m_last_search_failure = CANCELED;
+                return true;
+            }
+
             if (m_timer.ms_timeout(m_fparams.m_timeout)) {
                 m_last_search_failure = TIMEOUT;
                 return true;
@@ -3836,6 +3992,8 @@ namespace smt {
         default:
             break;
         }
+        if (m_fparams.m_phase_target || m_fparams.m_rephase != RP_NONE)
+            update_target_phase();
         if (m_fparams.m_phase_selection == PS_CACHING_CONSERVATIVE || m_fparams.m_phase_selection == PS_CACHING_CONSERVATIVE2)
             forget_phase_of_vars_in_current_level();
         m_atom_propagation_queue.reset();
@@ -3999,6 +4157,9 @@ namespace smt {
                 }
             }
 #endif
+            if (m_par) {
+                m_par->share_clause(*this, num_lits, lits);
+            }
             mk_clause(num_lits, lits, js, CLS_LEARNED);
             if (delay_forced_restart) {
                 SASSERT(num_lits == 1);
@@ -43,6 +43,7 @@ Revision History:
 #include "smt/watch_list.h"
 #include "util/trail.h"
 #include "smt/fingerprints.h"
+#include "smt/qi_trace.h"
 #include "util/ref.h"
 #include "smt/proto_model/proto_model.h"
 #include "model/model.h"
@@ -63,9 +64,13 @@ Revision History:
 namespace smt {
 
     class model_generator;
+    class parallel;
+    class cube_and_conquer;
 
     class context {
         friend class model_generator;
+        friend class parallel;
+        friend class cube_and_conquer;
     public:
         statistics                  m_stats;
 
@@ -83,12 +88,15 @@ namespace smt {
         timer                       m_timer;
         asserted_formulas           m_asserted_formulas;
         scoped_ptr<quantifier_manager>   m_qmanager;
+        scoped_ptr<qi_trace>             m_qi_trace;
         scoped_ptr<model_generator>      m_model_generator;
         scoped_ptr<relevancy_propagator> m_relevancy_propagator;
         random_gen                  m_random;
         bool                        m_flushing; // (debug support) true when flushing
         progress_callback *         m_progress_callback;
         unsigned                    m_next_progress_sample;
+        parallel *                  m_par;          // portfolio this context is a worker of, if any.
+        unsigned                    m_par_id;
 
         region                      m_region;
 
@@ -164,7 +172,10 @@ namespace smt {
         svector<double>             m_activity;
         clause_vector               m_aux_clauses;
         clause_vector               m_lemmas;
+        lemma_store                 m_lemma_store;
         vector<clause_vector>       m_clauses_to_reinit;
+        unsigned_vector             m_glue_marks;  //!< scope level -> m_glue_stamp, used to compute the glue of lemmas
+        unsigned                    m_glue_stamp;
         expr_ref_vector             m_units_to_reassert;
         svector<char>               m_units_to_reassert_sign;
         literal_vector              m_assigned_literals;
@@ -176,6 +187,12 @@ namespace smt {
         bool                        m_phase_cache_on;
         unsigned                    m_phase_counter; //!< auxiliary variable used to decide when to turn on/off phase caching
         bool                        m_phase_default; //!< default phase when using phase caching
+        svector<lbool>              m_target_phase; //!< phases of the longest conflict-free trail since the last rephase
+        unsigned                    m_target_trail_size;
+        svector<lbool>              m_best_phase;   //!< phases of the longest conflict-free trail since the last best rephase
+        unsigned                    m_best_trail_size;
+        unsigned                    m_rephase_count;
+        unsigned                    m_next_rephase; //!< number of conflicts for the next rephase
 
         // A conflict is usually a single justification. That is, a justification
         // for false. If m_not_l is not null_literal, then m_conflict is a
@@ -257,6 +274,10 @@ namespace smt {
             return m_params;
         }
 
+        qi_trace * get_qi_trace() const {
+            return m_qi_trace.get();
+        }
+
         bool get_cancel_flag();
 
         region & get_region() {
@@ -560,23 +581,70 @@ namespace smt {
         //
         // -----------------------------------
     protected:
+        /**
+           \brief The trail is a log of entry kinds. Generic entries are
+           trail objects allocated in m_region and undone by a virtual call.
+           Enode merges and the values of unsigned and Boolean fields are kept
+           in typed buffers (one array per field) and undone in place.
+        */
+        enum trail_kind {
+            GENERIC_TRAIL,
+            EQ_TRAIL,
+            UNSIGNED_TRAIL,
+            BOOL_TRAIL
+        };
         typedef ptr_vector<trail<context> >   trail_stack;
+        svector<unsigned char>                m_trail_kinds;
         trail_stack                           m_trail_stack;
+        ptr_vector<enode>                     m_eq_trail_r1;
+        ptr_vector<enode>                     m_eq_trail_n1;
+        unsigned_vector                       m_eq_trail_r2_num_parents;
+        ptr_vector<unsigned>                  m_unsigned_trail_ptrs;
+        unsigned_vector                       m_unsigned_trail_values;
+        ptr_vector<bool>                      m_bool_trail_ptrs;
+        svector<bool>                         m_bool_trail_values;
 #ifdef Z3DEBUG
         bool                                  m_trail_enabled;
 #endif
 
+        void push_eq_trail(enode * r1, enode * n1, unsigned r2_num_parents) {
+            m_trail_kinds.push_back(EQ_TRAIL);
+            m_eq_trail_r1.push_back(r1);
+            m_eq_trail_n1.push_back(n1);
+            m_eq_trail_r2_num_parents.push_back(r2_num_parents);
+        }
+
     public:
         template<typename TrailObject>
         void push_trail(const TrailObject & obj) {
             SASSERT(m_trail_enabled);
+            m_trail_kinds.push_back(GENERIC_TRAIL);
             m_trail_stack.push_back(new (m_region) TrailObject(obj));
         }
 
         void push_trail_ptr(trail<context> * ptr) {
+            m_trail_kinds.push_back(GENERIC_TRAIL);
             m_trail_stack.push_back(ptr);
         }
 
+        /**
+           \brief Restore the current value of \c v on backtracking.
+           Cheaper than push_trail(value_trail<context, unsigned>(v)).
+        */
+        void push_value_trail(unsigned & v) {
+            SASSERT(m_trail_enabled);
+            m_trail_kinds.push_back(UNSIGNED_TRAIL);
+            m_unsigned_trail_ptrs.push_back(&v);
+            m_unsigned_trail_values.push_back(v);
+        }
+
+        void push_value_trail(bool & v) {
+            SASSERT(m_trail_enabled);
+            m_trail_kinds.push_back(BOOL_TRAIL);
+            m_bool_trail_ptrs.push_back(&v);
+            m_bool_trail_values.push_back(v);
+        }
+
     protected:
 
         unsigned                    m_scope_lvl;
@@ -588,6 +656,11 @@ namespace smt {
             unsigned                m_aux_clauses_lim;
             unsigned                m_justifications_lim;
             unsigned                m_units_to_reassert_lim;
+#ifdef Z3DEBUG
+            unsigned                m_propagated_th_eqs_lim;
+            unsigned                m_propagated_th_diseqs_lim;
+            unsigned                m_diseq_vector_lim;
+#endif
         };
         struct base_scope {
             unsigned                m_lemmas_lim;
@@ -606,6 +679,8 @@ namespace smt {
 
         void undo_trail_stack(unsigned old_size);
 
+        void discard_trail(unsigned old_size);
+
         void unassign_vars(unsigned old_lim);
 
         void remove_watch_literal(clause * cls, unsigned idx);
@@ -812,7 +887,15 @@ namespace smt {
         bool lit_occs_enabled() const { return m_fparams.m_phase_selection==PS_OCCURRENCE; }
 
         void add_lit_occs(clause * cls);
+
+        unsigned compute_glue(unsigned num_lits, literal const * lits);
     public:
+        /**
+           \brief decrease the glue of a lemma used in conflict resolution,
+           if its literals are now assigned at fewer levels.
+        */
+        void update_glue(clause * cls);
+
         void internalize(expr * n, bool gate_ctx);
 
         void internalize(expr * n, bool gate_ctx, unsigned generation);
@@ -956,11 +1039,9 @@ namespace smt {
 
         void push_new_th_diseq(theory_id th, theory_var lhs, theory_var rhs);
 
-        friend class add_eq_trail;
-
         void add_eq(enode * n1, enode * n2, eq_justification js);
 
-        void remove_parents_from_cg_table(enode * r1);
+        void remove_parents_from_cg_table(enode * r1, enode * r2);
 
         void reinsert_parents_into_cg_table(enode * r1, enode * r2, enode * n1, enode * n2, eq_justification js);
 
@@ -1028,6 +1109,18 @@ namespace smt {
 
         void update_phase_cache_counter();
 
+        void update_target_phase();
+
+        void shrink_saved_phases(unsigned num_bool_vars);
+
+        bool should_rephase() const {
+            return m_fparams.m_rephase != RP_NONE && m_num_conflicts >= m_next_rephase;
+        }
+
+        void rephase();
+
+        void walk_phase();
+
 #define ACTIVITY_LIMIT 1e100
 #define INV_ACTIVITY_LIMIT 1e-100
 
@@ -1074,12 +1167,22 @@ namespace smt {
             return !is_justifying(cls);
         }
 
+        bool is_glue_lemma(clause * cls) const {
+            return cls->get_glue() <= m_fparams.m_lemma_gc_glue;
+        }
+
+        bool can_move(clause * cls) const {
+            return !cls->deleted() && !cls->get_del_eh() && can_delete(cls);
+        }
+
         void del_inactive_lemmas();
 
         void del_inactive_lemmas1();
 
         void del_inactive_lemmas2();
 
+        void compact_lemmas();
+
         bool more_than_k_unassigned_literals(clause * cls, unsigned k);
 
         void internalize_assertions();
@@ -1438,6 +1541,13 @@ namespace smt {
 
         void extract_cores(expr_ref_vector const& asms, vector<expr_ref_vector>& cores, unsigned& min_core_size);
 
+        //
+        // cubes
+        //
+        bool_var select_cube_var();
+
+        bool split_cube(unsigned depth, expr_ref_vector& cube, vector<expr_ref_vector>& cubes);
+
         void preferred_sat(literal_vector& literals);
 
         void display_partial_assignment(std::ostream& out, expr_ref_vector const& asms, unsigned min_core_size);
@@ -1457,7 +1567,14 @@ namespace smt {
         */
         context * mk_fresh(symbol const * l = 0,  smt_params * p = 0);
 
-        static void copy(context& src, context& dst);
+        /**
+           \brief Copy the assertions of src into dst.
+           If override_base is true, assertions in user scopes of src are
+           copied to the base level of dst.
+        */
+        static void copy(context& src, context& dst, bool override_base = false);
+
+        void set_par(parallel* p, unsigned id) { m_par = p; m_par_id = id; }
 
         /**
            \brief Translate context to use new manager m.
@@ -1485,6 +1602,17 @@ namespace smt {
 
         lbool find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes);
 
+        /**
+           \brief check the assumptions spending at most max_conflicts conflicts.
+           If the check is inconclusive, split the search space below the
+           assumptions into cubes of at most depth literals. The cubes cover
+           every model of the assertions and the assumptions.
+           Return l_false (with an unsat core) if the assumptions are
+           inconsistent, including the case where every cube is refuted
+           while splitting.
+        */
+        lbool get_cubes(expr_ref_vector const& assumptions, unsigned depth, unsigned max_conflicts, vector<expr_ref_vector>& cubes);
+
         lbool preferred_sat(expr_ref_vector const& asms, vector<expr_ref_vector>& cores);
 
         lbool setup_and_check(bool reset_cancel = true);
@@ -389,6 +389,19 @@ namespace smt {
         st.update("max generation", m_stats.m_max_generation);
         st.update("minimized lits", m_stats.m_num_minimized_lits);
         st.update("num checks", m_stats.m_num_checks);
+        if (m_stats.m_num_par_shared > 0 || m_stats.m_num_par_imported > 0) {
+            st.update("parallel shared lemmas", m_stats.m_num_par_shared);
+            st.update("parallel imported lemmas", m_stats.m_num_par_imported);
+        }
+        if (m_stats.m_num_cubes > 0) {
+            st.update("cubes", m_stats.m_num_cubes);
+            st.update("refuted cubes", m_stats.m_num_refuted_cubes);
+            st.update("pruned cubes", m_stats.m_num_pruned_cubes);
+        }
+        if (m_stats.m_num_moved_lemmas > 0)
+            st.update("moved lemmas", m_stats.m_num_moved_lemmas);
+        if (m_stats.m_num_rephases > 0)
+            st.update("rephases", m_stats.m_num_rephases);
         st.update("mk bool var", m_stats.m_num_mk_bool_var);
 
 #if 0
@@ -0,0 +1,589 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_cube.cpp
+
+Abstract:
+
+    Cube and conquer for smt::context.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include <thread>
+#include "smt/smt_cube.h"
+#include "smt/smt_context.h"
+#include "ast/ast_translation.h"
+#include "ast/ast_pp.h"
+#include "ast/for_each_expr.h"
+#include "util/z3_omp.h"
+
+namespace smt {
+
+    /**
+       \brief select an unassigned relevant atom with maximal activity.
+       The activity of theory atoms is scaled by m_cube_theory_weight.
+       Atoms that contain skolem functions are not selected, their
+       meaning is local to the context.
+    */
+    bool_var context::select_cube_var() {
+        bool_var best = null_bool_var;
+        double best_score = 0;
+        bool_var num_vars = get_num_bool_vars();
+        for (bool_var v = 0; v < num_vars; ++v) {
+            if (get_assignment(v) != l_undef) {
+                continue;
+            }
+            expr * e = bool_var2expr(v);
+            if (!e || !is_relevant(e)) {
+                continue;
+            }
+            double score = 1.0 + m_activity[v];
+            if (get_var_theory(v) != null_theory_id) {
+                score *= m_fparams.m_cube_theory_weight;
+            }
+            if (best != null_bool_var && score <= best_score) {
+                continue;
+            }
+            if (!is_ground(e) || has_skolem_functions(e)) {
+                continue;
+            }
+            best = v;
+            best_score = score;
+        }
+        return best;
+    }
+
+    /**
+       \brief extend cube by up to depth literals.
+       Return false if every extension of cube is refuted by propagation.
+    */
+    bool context::split_cube(unsigned depth, expr_ref_vector & cube, vector<expr_ref_vector> & cubes) {
+        bool_var v = depth == 0 || get_cancel_flag() ? null_bool_var : select_cube_var();
+        if (v == null_bool_var) {
+            m_stats.m_num_cubes++;
+            cubes.push_back(cube);
+            return true;
+        }
+        bool found = false;
+        expr_ref e(m_manager);
+        for (unsigned i = 0; i < 2; ++i) {
+            literal l(v, i == 1);
+            push_scope();
+            assign(l, b_justification::mk_axiom(), true);
+            if (propagate()) {
+                literal2expr(l, e);
+                cube.push_back(e);
+                if (split_cube(depth - 1, cube, cubes)) {
+                    found = true;
+                }
+                cube.pop_back();
+            }
+            else {
+                TRACE("smt_cube", tout << "refuted: " << cube << " " << l << "\n";);
+                m_stats.m_num_refuted_cubes++;
+            }
+            pop_scope(1);
+        }
+        return found;
+    }
+
+    lbool context::get_cubes(expr_ref_vector const & assumptions, unsigned depth, unsigned max_conflicts, vector<expr_ref_vector> & cubes) {
+        cubes.reset();
+        lbool r = l_undef;
+        {
+            flet<unsigned> _max_conflicts(m_fparams.m_max_conflicts, max_conflicts);
+            r = check(assumptions.size(), assumptions.c_ptr());
+        }
+        if (r != l_undef) {
+            return r;
+        }
+        // only split when the conflict budget ran out; other failures
+        // (resource limits, incomplete theories or quantifiers) are final.
+        if (m_last_search_failure != NUM_CONFLICTS) {
+            return l_undef;
+        }
+        if (get_cancel_flag()) {
+            return l_undef;
+        }
+        pop_to_search_lvl();
+        if (inconsistent()) {
+            return l_undef;
+        }
+        expr_ref_vector cube(m_manager);
+        if (!split_cube(depth, cube, cubes)) {
+            TRACE("smt_cube", tout << "all cubes are refuted\n";);
+            m_unsat_core.reset();
+            m_unsat_core.append(assumptions);
+            m_last_search_failure = OK;
+            return l_false;
+        }
+        return l_undef;
+    }
+
+    enum cube_exception_kind {
+        DEFAULT_EX,
+        ERROR_EX
+    };
+
+    cube_and_conquer::worker::worker(context & ctx, unsigned num_asms, expr * const * asms):
+        m_ctx(ctx),
+        m_asms(ctx.get_manager(), num_asms, asms),
+        m_pinned(ctx.get_manager()) {
+        for (unsigned i = 0; i < num_asms; ++i) {
+            m_asm2idx.insert(asms[i], i);
+        }
+    }
+
+    cube_and_conquer::cube_and_conquer(context & ctx):
+        m_ctx(ctx),
+        m_num_threads(std::max(1u, ctx.get_fparams().m_threads)),
+        m_depth(ctx.get_fparams().m_cube_depth),
+        m_budget(std::max(1u, ctx.get_fparams().m_cube_conflicts)),
+        m_qhead(0),
+        m_num_active(0),
+        m_undef(false),
+        m_undef_reason(OK),
+        m_sat_worker(UINT_MAX),
+        m_done(false),
+        m_num_cubes(0),
+        m_num_refuted(0),
+        m_num_pruned(0) {
+    }
+
+    cube_and_conquer::~cube_and_conquer() {
+        m_model = 0;
+        m_workers.reset();
+        m_contexts.reset();
+        m_lits = 0;
+    }
+
+    bool cube_and_conquer::is_sequential() const {
+        ast_manager & m = m_ctx.get_manager();
+        return omp_in_parallel() || m.proofs_enabled() || m.has_trace_stream() || m_ctx.inconsistent();
+    }
+
+    lbool cube_and_conquer::setup_and_check() {
+        if (is_sequential()) {
+            return m_ctx.setup_and_check();
+        }
+        // configure the context using the static features of the assertions
+        // before the workers are copied from it.
+        m_ctx.setup_context(m_ctx.get_fparams().m_auto_config);
+        return (*this)(0, 0);
+    }
+
+    lbool cube_and_conquer::operator()(unsigned num_asms, expr * const * asms) {
+        ast_manager & m = m_ctx.get_manager();
+        if (is_sequential()) {
+            return m_ctx.check(num_asms, asms);
+        }
+        expr_ref_vector _asms(m, num_asms, asms);
+        vector<expr_ref_vector> cubes;
+        lbool r = m_ctx.get_cubes(_asms, m_depth, m_budget, cubes);
+        if (r == l_undef && (cubes.empty() || cubes[0].empty()) &&
+            m_ctx.get_last_search_failure() == NUM_CONFLICTS && !m_ctx.get_cancel_flag()) {
+            // the budget ran out, but there is nothing to split on.
+            IF_VERBOSE(1, verbose_stream() << "(smt.cube :no-split)\n";);
+            return m_ctx.check(num_asms, asms);
+        }
+        if (r != l_undef || cubes.empty() || cubes[0].empty()) {
+            return r;
+        }
+        init_tree(num_asms, cubes);
+        init_workers(num_asms, asms);
+        conquer();
+        r = get_result(num_asms, asms);
+        for (unsigned i = 0; i < m_contexts.size(); ++i) {
+            m_ctx.m_stats.m_num_cubes += m_contexts[i]->m_stats.m_num_cubes;
+            m_ctx.m_stats.m_num_refuted_cubes += m_contexts[i]->m_stats.m_num_refuted_cubes;
+        }
+        m_ctx.m_stats.m_num_refuted_cubes += m_num_refuted;
+        m_ctx.m_stats.m_num_pruned_cubes += m_num_pruned;
+        IF_VERBOSE(1, verbose_stream() << "(smt.cube :solved " << m_num_cubes << " :refuted " << m_num_refuted
+                   << " :pruned " << m_num_pruned << " :result " << r << ")\n";);
+        return r;
+    }
+
+    void cube_and_conquer::init_tree(unsigned num_asms, vector<expr_ref_vector> const & cubes) {
+        ast_manager & m = m_ctx.get_manager();
+        m_tree_manager = alloc(ast_manager, m, true);
+        m_lits = alloc(expr_ref_vector, *m_tree_manager);
+        ast_translation tr(m, *m_tree_manager, false);
+        m_nodes.push_back(node(UINT_MAX, 0, 0, m_budget));
+        for (unsigned i = 0; i < cubes.size(); ++i) {
+            unsigned n = 0;
+            for (unsigned j = 0; j < cubes[i].size(); ++j) {
+                n = insert_child(n, tr(cubes[i][j]));
+            }
+        }
+        for (unsigned i = 0; i < m_nodes.size(); ++i) {
+            unsigned num_children = m_nodes[i].m_children.size();
+            if (num_children == 0) {
+                m_queue.push_back(i);
+            }
+            else if (num_children == 1) {
+                // the other branch was refuted using the assumptions.
+                for (unsigned j = 0; j < num_asms; ++j) {
+                    m_core.insert(j);
+                }
+            }
+        }
+    }
+
+    void cube_and_conquer::init_workers(unsigned num_asms, expr * const * asms) {
+        ast_manager & m = m_ctx.get_manager();
+        m_ctx.pop_to_base_lvl();
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            ast_manager * new_m = alloc(ast_manager, m, true);
+            m_managers.push_back(new_m);
+            smt_params * p = alloc(smt_params, m_ctx.get_fparams());
+            m_params.push_back(p);
+            p->m_threads = 1;
+            p->m_cube_depth = 0;
+            p->m_qi_trace_file.clear(); // only the main context writes the trace.
+            p->m_random_seed = m_ctx.get_fparams().m_random_seed + i;
+            context * ctx = alloc(context, *new_m, *p, m_ctx.get_params());
+            m_contexts.push_back(ctx);
+            context::copy(m_ctx, *ctx, true);
+            ctx->setup_context(false);
+
+            ast_translation tr(m, *new_m, false);
+            expr_ref_vector as(*new_m);
+            for (unsigned j = 0; j < num_asms; ++j) {
+                as.push_back(tr(asms[j]));
+            }
+            m_workers.push_back(alloc(worker, *ctx, as.size(), as.c_ptr()));
+        }
+    }
+
+    unsigned cube_and_conquer::insert_child(unsigned parent, expr * lit) {
+        unsigned_vector const & children = m_nodes[parent].m_children;
+        for (unsigned i = 0; i < children.size(); ++i) {
+            if (m_nodes[children[i]].m_lit == lit) {
+                return children[i];
+            }
+        }
+        unsigned depth  = m_nodes[parent].m_depth + 1;
+        unsigned budget = m_nodes[parent].m_budget + m_nodes[parent].m_budget / 2;
+        unsigned id = m_nodes.size();
+        m_lits->push_back(lit);
+        m_nodes.push_back(node(parent, lit, depth, budget));
+        m_nodes[parent].m_children.push_back(id);
+        return id;
+    }
+
+    bool cube_and_conquer::is_closed(unsigned id) const {
+        for (; id != UINT_MAX; id = m_nodes[id].m_parent) {
+            if (m_nodes[id].m_closed) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned cube_and_conquer::next_cube() {
+        while (m_qhead < m_queue.size()) {
+            unsigned id = m_queue[m_qhead++];
+            if (!is_closed(id)) {
+                return id;
+            }
+            ++m_num_pruned;
+        }
+        return UINT_MAX;
+    }
+
+    void cube_and_conquer::get_path(worker & w, unsigned id, expr_ref_vector & lits, unsigned_vector & depths) {
+        ast_translation tr(*m_tree_manager, w.m_ctx.get_manager(), false);
+        for (; id != 0; id = m_nodes[id].m_parent) {
+            lits.push_back(tr(m_nodes[id].m_lit));
+            depths.push_back(m_nodes[id].m_depth);
+        }
+    }
+
+    /**
+       \brief cube literals are not valid assumptions in general.
+       They are assumed through a proxy p with the definition p = atom.
+    */
+    expr * cube_and_conquer::mk_proxy(worker & w, expr * lit) {
+        ast_manager & m = w.m_ctx.get_manager();
+        expr * atom = lit;
+        bool sign = m.is_not(lit, atom);
+        expr * p = 0;
+        if (!w.m_proxies.find(atom, p)) {
+            p = m.mk_fresh_const("cube", m.mk_bool_sort());
+            w.m_pinned.push_back(atom);
+            w.m_pinned.push_back(p);
+            w.m_proxies.insert(atom, p);
+            w.m_ctx.assert_expr(m.mk_eq(p, atom));
+        }
+        if (sign) {
+            p = m.mk_not(p);
+            w.m_pinned.push_back(p);
+        }
+        return p;
+    }
+
+    void cube_and_conquer::solve_cube(unsigned wid, unsigned id) {
+        worker & w = *m_workers[wid];
+        ast_manager & m = w.m_ctx.get_manager();
+        expr_ref_vector lits(m);
+        unsigned_vector depths;
+        unsigned budget = 0;
+        #pragma omp critical (smt_cube)
+        {
+            get_path(w, id, lits, depths);
+            budget = m_nodes[id].m_budget;
+            ++m_num_cubes;
+        }
+        expr_ref_vector asms(w.m_asms);
+        obj_map<expr, unsigned> depth;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            asms.push_back(mk_proxy(w, lits.get(i)));
+            depth.insert(asms.back(), depths[i]);
+        }
+        vector<expr_ref_vector> cubes;
+        lbool r = w.m_ctx.get_cubes(asms, 1, budget, cubes);
+        TRACE("smt_cube", tout << "cube " << id << " " << lits << " budget: " << budget << " " << r << "\n";);
+        bool first = false;
+        #pragma omp critical (smt_cube)
+        {
+            switch (r) {
+            case l_true:
+                if (!m_done) {
+                    m_done = true;
+                    m_sat_worker = wid;
+                    w.m_ctx.get_model(m_model);
+                    first = true;
+                }
+                break;
+            case l_false:
+                ++m_num_refuted;
+                collect_core(w, id, depth);
+                break;
+            case l_undef:
+                if (m_done) {
+                    break;
+                }
+                if (!cubes.empty() && !cubes[0].empty()) {
+                    split(w, id, cubes);
+                }
+                else if (w.m_ctx.get_last_search_failure() == NUM_CONFLICTS && !w.m_ctx.get_cancel_flag()) {
+                    // nothing to split on: solve the cube again with twice the budget.
+                    m_nodes[id].m_budget = budget > UINT_MAX / 2 ? UINT_MAX : 2 * budget;
+                    m_queue.push_back(id);
+                }
+                else {
+                    set_undef(w);
+                }
+                break;
+            }
+        }
+        if (first) {
+            cancel_others(wid);
+        }
+    }
+
+    void cube_and_conquer::split(worker & w, unsigned id, vector<expr_ref_vector> const & cubes) {
+        ast_translation tr(w.m_ctx.get_manager(), *m_tree_manager, false);
+        if (cubes.size() == 1) {
+            // the other branch was refuted using the assumptions.
+            for (unsigned j = 0; j < w.m_asms.size(); ++j) {
+                m_core.insert(j);
+            }
+        }
+        for (unsigned i = 0; i < cubes.size(); ++i) {
+            SASSERT(cubes[i].size() == 1);
+            m_queue.push_back(insert_child(id, tr(cubes[i][0])));
+        }
+    }
+
+    void cube_and_conquer::set_undef(worker & w) {
+        context & ctx = w.m_ctx;
+        m_undef = true;
+        m_undef_reason = ctx.get_last_search_failure();
+        m_undef_theories.reset();
+        for (unsigned i = 0; i < ctx.m_incomplete_theories.size(); ++i) {
+            m_undef_theories.push_back(ctx.m_incomplete_theories[i]->get_id());
+        }
+        switch (m_undef_reason) {
+        case TIMEOUT:
+        case MEMOUT:
+        case CANCELED:
+        case RESOURCE_LIMIT:
+            m_done = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    /**
+       \brief close the deepest node on the path of id that contains the unsat core.
+    */
+    void cube_and_conquer::collect_core(worker & w, unsigned id, obj_map<expr, unsigned> const & depth) {
+        context & ctx = w.m_ctx;
+        unsigned lvl = 0;
+        for (unsigned i = 0; i < ctx.get_unsat_core_size(); ++i) {
+            expr * e = ctx.get_unsat_core_expr(i);
+            unsigned d = 0, idx = 0;
+            if (depth.find(e, d)) {
+                lvl = std::max(lvl, d);
+            }
+            else if (w.m_asm2idx.find(e, idx)) {
+                m_core.insert(idx);
+            }
+        }
+        while (m_nodes[id].m_depth > lvl) {
+            id = m_nodes[id].m_parent;
+        }
+        close(id);
+    }
+
+    void cube_and_conquer::close(unsigned id) {
+        while (true) {
+            m_nodes[id].m_closed = true;
+            if (id == 0) {
+                m_done = true;
+                return;
+            }
+            id = m_nodes[id].m_parent;
+            unsigned_vector const & children = m_nodes[id].m_children;
+            for (unsigned i = 0; i < children.size(); ++i) {
+                if (!m_nodes[children[i]].m_closed) {
+                    return;
+                }
+            }
+        }
+    }
+
+    void cube_and_conquer::cancel_others(unsigned wid) {
+        for (unsigned j = 0; j < m_managers.size(); ++j) {
+            if (j != wid) {
+                m_managers[j]->limit().cancel();
+            }
+        }
+    }
+
+    void cube_and_conquer::conquer() {
+        ast_manager & m = m_ctx.get_manager();
+        scoped_limits scoped_rlimit(m.limit());
+        for (unsigned i = 0; i < m_managers.size(); ++i) {
+            scoped_rlimit.push_child(&m_managers[i]->limit());
+        }
+        int num_threads = static_cast<int>(m_num_threads);
+        std::string         ex_msg;
+        cube_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        bool has_ex = false;
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                while (!m_done) {
+                    unsigned id = UINT_MAX;
+                    bool wait = false;
+                    #pragma omp critical (smt_cube)
+                    {
+                        id = next_cube();
+                        if (id != UINT_MAX) {
+                            ++m_num_active;
+                        }
+                        else {
+                            wait = m_num_active > 0;
+                        }
+                    }
+                    if (id == UINT_MAX) {
+                        if (!wait) {
+                            break;
+                        }
+                        // another worker may split its cube.
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    solve_cube(i, id);
+                    #pragma omp critical (smt_cube)
+                    {
+                        --m_num_active;
+                    }
+                }
+            }
+            catch (z3_error & err) {
+                #pragma omp critical (smt_cube)
+                {
+                    if (!has_ex) {
+                        error_code = err.error_code();
+                        ex_kind = ERROR_EX;
+                        has_ex = true;
+                    }
+                    m_done = true;
+                }
+                cancel_others(i);
+            }
+            catch (z3_exception & ex) {
+                #pragma omp critical (smt_cube)
+                {
+                    if (!has_ex) {
+                        ex_msg = ex.msg();
+                        ex_kind = DEFAULT_EX;
+                        has_ex = true;
+                    }
+                    m_done = true;
+                }
+                cancel_others(i);
+            }
+        }
+        if (has_ex && m_sat_worker == UINT_MAX && !m_nodes[0].m_closed) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(ex_msg.c_str());
+            }
+        }
+    }
+
+    /**
+       \brief transfer the result of the cubes to the main context.
+    */
+    lbool cube_and_conquer::get_result(unsigned num_asms, expr * const * asms) {
+        ast_manager & m = m_ctx.get_manager();
+        m_ctx.m_unsat_core.reset();
+        if (m_sat_worker != UINT_MAX) {
+            worker & w = *m_workers[m_sat_worker];
+            m_ctx.m_last_search_failure = OK;
+            m_ctx.m_model = 0;
+            if (m_model) {
+                obj_map<expr, expr*>::iterator it = w.m_proxies.begin(), end = w.m_proxies.end();
+                for (; it != end; ++it) {
+                    m_model->unregister_decl(to_app(it->m_value)->get_decl());
+                }
+                ast_translation tr(w.m_ctx.get_manager(), m, false);
+                m_ctx.m_model = m_model->translate(tr);
+            }
+            return l_true;
+        }
+        if (m_nodes[0].m_closed) {
+            m_ctx.m_last_search_failure = OK;
+            for (unsigned i = 0; i < num_asms; ++i) {
+                if (m_core.contains(i)) {
+                    m_ctx.m_unsat_core.push_back(asms[i]);
+                }
+            }
+            return l_false;
+        }
+        m_ctx.m_last_search_failure = m_undef ? m_undef_reason : CANCELED;
+        m_ctx.m_incomplete_theories.reset();
+        for (unsigned i = 0; i < m_undef_theories.size(); ++i) {
+            theory * th = m_ctx.get_theory(m_undef_theories[i]);
+            if (th) {
+                m_ctx.m_incomplete_theories.push_back(th);
+            }
+        }
+        return l_undef;
+    }
+
+};
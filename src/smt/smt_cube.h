@@ -0,0 +1,140 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_cube.h
+
+Abstract:
+
+    Cube and conquer for smt::context.
+
+    The context is checked with a conflict budget. If the check is
+    inconclusive, the search space is split into a tree of cubes
+    (context::get_cubes). The cubes are solved by copies of the context,
+    each in its own ast_manager, using a conflict budget that grows with
+    the depth of the cube. A cube that exhausts its budget is split again,
+    or solved again with twice the budget if it has no literal to split on.
+    A refuted cube closes the deepest node of the tree whose path contains
+    the unsat core of the cube. Closing a node prunes the cubes below it,
+    and a node is closed when all of its children are closed.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+    Cube literals are ground and do not contain skolem functions, so they
+    have the same meaning in all copies. The copies assume cube literals
+    through fresh propositional proxies.
+
+--*/
+#ifndef SMT_CUBE_H_
+#define SMT_CUBE_H_
+
+#include <atomic>
+#include "ast/ast.h"
+#include "util/lbool.h"
+#include "util/obj_hashtable.h"
+#include "util/uint_set.h"
+#include "util/scoped_ptr_vector.h"
+#include "model/model.h"
+#include "smt/smt_failure.h"
+
+struct smt_params;
+
+namespace smt {
+
+    class context;
+
+    class cube_and_conquer {
+
+        struct node {
+            unsigned        m_parent;
+            expr *          m_lit;      // literal added to the cube of the parent, 0 for the root.
+            unsigned        m_depth;
+            unsigned        m_budget;   // conflict budget of the cube.
+            bool            m_closed;
+            unsigned_vector m_children;
+            node(unsigned parent, expr * lit, unsigned depth, unsigned budget):
+                m_parent(parent), m_lit(lit), m_depth(depth), m_budget(budget), m_closed(false) {}
+        };
+
+        struct worker {
+            context &            m_ctx;
+            expr_ref_vector      m_asms;     // assumptions of the check, over the worker's manager.
+            obj_map<expr, unsigned> m_asm2idx;
+            obj_map<expr, expr*> m_proxies;  // cube atom -> propositional proxy.
+            expr_ref_vector      m_pinned;
+            worker(context & ctx, unsigned num_asms, expr * const * asms);
+        };
+
+        context &                       m_ctx;
+        unsigned                        m_num_threads;
+        unsigned                        m_depth;
+        unsigned                        m_budget;
+        scoped_ptr_vector<ast_manager>  m_managers;
+        scoped_ptr_vector<smt_params>   m_params;
+        scoped_ptr_vector<context>      m_contexts;
+        scoped_ptr_vector<worker>       m_workers;
+
+        // the cube tree, over m_tree_manager.
+        scoped_ptr<ast_manager>         m_tree_manager;
+        scoped_ptr<expr_ref_vector>     m_lits;
+        vector<node>                    m_nodes;
+        unsigned_vector                 m_queue;        // open leaves.
+        unsigned                        m_qhead;
+        unsigned                        m_num_active;   // cubes that are being solved.
+
+        // indices of the assumptions used to close nodes.
+        uint_set                        m_core;
+        bool                            m_undef;        // some cube could neither be decided nor split.
+        failure                         m_undef_reason;
+        svector<family_id>              m_undef_theories;
+        unsigned                        m_sat_worker;
+        model_ref                       m_model;        // model of m_sat_worker.
+        std::atomic<bool>               m_done;
+
+        unsigned                        m_num_cubes;
+        unsigned                        m_num_refuted;
+        unsigned                        m_num_pruned;
+
+        bool is_sequential() const;
+        void init_workers(unsigned num_asms, expr * const * asms);
+        void init_tree(unsigned num_asms, vector<expr_ref_vector> const & cubes);
+        unsigned insert_child(unsigned parent, expr * lit);
+        bool is_closed(unsigned id) const;
+        unsigned next_cube();
+        void get_path(worker & w, unsigned id, expr_ref_vector & lits, unsigned_vector & depths);
+        expr * mk_proxy(worker & w, expr * lit);
+        void solve_cube(unsigned wid, unsigned id);
+        void split(worker & w, unsigned id, vector<expr_ref_vector> const & cubes);
+        void set_undef(worker & w);
+        void collect_core(worker & w, unsigned id, obj_map<expr, unsigned> const & depth);
+        void close(unsigned id);
+        void cancel_others(unsigned wid);
+        void conquer();
+        lbool get_result(unsigned num_asms, expr * const * asms);
+
+    public:
+        cube_and_conquer(context & ctx);
+
+        ~cube_and_conquer();
+
+        /**
+           \brief check satisfiability of the context using cube and conquer.
+           The result (model, unsat core, reason unknown) is stored in the context.
+        */
+        lbool operator()(unsigned num_asms, expr * const * asms);
+
+        /**
+           \brief configure the context using its static features and check it
+           using cube and conquer.
+        */
+        lbool setup_and_check();
+    };
+
+};
+
+#endif
@@ -46,6 +46,7 @@ namespace smt {
         n->m_merge_tf         = merge_tf;
         n->m_cgc_enabled      = cgc_enabled;
         n->m_iscope_lvl       = iscope_lvl;
+        n->m_cg_hash          = 0;
         n->m_lbl_hash         = -1;
         unsigned num_args     = n->get_num_args();
         for (unsigned i = 0; i < num_args; i++) {
@@ -206,7 +207,7 @@ namespace smt {
     void enode::set_generation(context & ctx, unsigned generation) {
         if (m_generation == generation)
             return;
-        ctx.push_trail(value_trail<context, unsigned>(m_generation));
+        ctx.push_value_trail(m_generation);
         m_generation = generation;
     }
 
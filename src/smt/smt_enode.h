@@ -87,6 +87,7 @@ namespace smt {
         unsigned            m_merge_tf:1;       //!< True if the enode should be merged with true/false when the associated boolean variable is assigned.
         unsigned            m_cgc_enabled:1;    //!< True if congruence closure is enabled for this enode.
         unsigned            m_iscope_lvl;       //!< When the enode was internalized
+        unsigned            m_cg_hash;          //!< Signature hash cached by the congruence table.
         /*
           The following property is valid for m_parents
           
@@ -164,6 +165,14 @@ namespace smt {
             m_func_decl_id = id;
         }
 
+        unsigned get_cg_hash() const {
+            return m_cg_hash;
+        }
+
+        void set_cg_hash(unsigned h) {
+            m_cg_hash = h;
+        }
+
         void mark_as_interpreted() {
             SASSERT(!m_interpreted);
             SASSERT(m_owner->get_num_args() == 0);
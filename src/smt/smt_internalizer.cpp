@@ -853,7 +853,7 @@ namespace smt {
             m_activity[v]      = 0.0;
         m_case_split_queue->mk_var_eh(v);
         m_b_internalized_stack.push_back(n);
-        m_trail_stack.push_back(&m_mk_bool_var_trail);
+        push_trail_ptr(&m_mk_bool_var_trail);
         m_stats.m_num_mk_bool_var++;
         SASSERT(check_bool_var_vector_sizes());
         return v;
@@ -902,7 +902,7 @@ namespace smt {
         TRACE("generation", tout << "mk_enode: " << id << " " << generation << "\n";);
         m_app2enode.setx(id, e, 0);
         m_e_internalized_stack.push_back(n);
-        m_trail_stack.push_back(&m_mk_enode_trail);
+        push_trail_ptr(&m_mk_enode_trail);
         m_enodes.push_back(e);
         if (e->get_num_args() > 0) {
             if (e->is_true_eq()) {
@@ -1293,6 +1293,8 @@ namespace smt {
             break;
         }
         TRACE("mk_clause", tout << "after simplification:\n"; display_literals(tout, num_lits, lits); tout << "\n";);
+        if (m_qi_trace && k == CLS_AUX)
+            m_qi_trace->mk_clause_eh(num_lits, lits);
         unsigned activity = 0;
         if (activity == 0)
             activity = 1;
@@ -1312,7 +1314,9 @@ namespace smt {
             assign(lits[0], j);
             return 0;
         case 2:
-            if (use_binary_clause_opt(lits[0], lits[1], lemma)) {
+            // binary clauses do not keep the justification, the quantifier instantiation
+            // trace needs it to find the instances used to simplify the clause.
+            if (use_binary_clause_opt(lits[0], lits[1], lemma) && (j == 0 || !m_qi_trace)) {
                 literal l1 = lits[0];
                 literal l2 = lits[1];
                 m_watches[(~l1).index()].insert_literal(l2);
@@ -1330,9 +1334,10 @@ namespace smt {
             bool save_atoms     = lemma && iscope_lvl > m_base_lvl;
             bool reinit         = save_atoms;
             SASSERT(!lemma || j == 0 || !j->in_region());
-            clause * cls = clause::mk(m_manager, num_lits, lits, k, j, del_eh, save_atoms, m_bool_var2expr.c_ptr());
+            clause * cls = clause::mk(m_manager, num_lits, lits, k, j, del_eh, save_atoms, m_bool_var2expr.c_ptr(), &m_lemma_store);
             if (lemma) {
                 cls->set_activity(activity);
+                cls->set_glue(compute_glue(num_lits, lits));
                 if (k == CLS_LEARNED) {
                     int w2_idx  = select_learned_watch_lit(cls);
                     cls->swap_lits(1, w2_idx);
@@ -1385,6 +1390,41 @@ namespace smt {
         }} 
     }
 
+    /**
+       \brief Return the number of distinct scope levels of the assigned literals
+       plus the number of unassigned literals.
+    */
+    unsigned context::compute_glue(unsigned num_lits, literal const * lits) {
+        if (++m_glue_stamp == 0) {
+            m_glue_marks.reset();
+            m_glue_stamp = 1;
+        }
+        m_glue_marks.reserve(m_scope_lvl + 1, 0);
+        unsigned glue = 0;
+        for (unsigned i = 0; i < num_lits; i++) {
+            literal l = lits[i];
+            if (get_assignment(l) == l_undef) {
+                glue++;
+                continue;
+            }
+            unsigned lvl = get_assign_level(l);
+            if (m_glue_marks[lvl] != m_glue_stamp) {
+                m_glue_marks[lvl] = m_glue_stamp;
+                glue++;
+            }
+        }
+        return glue;
+    }
+
+    void context::update_glue(clause * cls) {
+        unsigned glue = cls->get_glue();
+        if (glue <= m_fparams.m_lemma_gc_glue)
+            return;
+        unsigned new_glue = compute_glue(cls->get_num_literals(), cls->begin_literals());
+        if (new_glue < glue)
+            cls->set_glue(new_glue);
+    }
+
     void context::add_lit_occs(clause * cls) {
         unsigned num_lits = cls->get_num_literals();
         for (unsigned i = 0; i < num_lits; i++) {
@@ -18,6 +18,8 @@ Revision History:
 --*/
 #include "smt/smt_kernel.h"
 #include "smt/smt_context.h"
+#include "smt/smt_parallel.h"
+#include "smt/smt_cube.h"
 #include "ast/ast_smt2_pp.h"
 #include "smt/params/smt_params_helper.hpp"
 
@@ -100,6 +102,14 @@ namespace smt {
         }
 
         lbool setup_and_check() {
+            if (fparams().m_cube_depth > 0) {
+                cube_and_conquer cc(m_kernel);
+                return cc.setup_and_check();
+            }
+            if (fparams().m_threads > 1) {
+                parallel p(m_kernel);
+                return p.setup_and_check();
+            }
             return m_kernel.setup_and_check();
         }
 
@@ -108,6 +118,14 @@ namespace smt {
         }
         
         lbool check(unsigned num_assumptions, expr * const * assumptions) {
+            if (fparams().m_cube_depth > 0) {
+                cube_and_conquer cc(m_kernel);
+                return cc(num_assumptions, assumptions);
+            }
+            if (fparams().m_threads > 1) {
+                parallel p(m_kernel);
+                return p(num_assumptions, assumptions);
+            }
             return m_kernel.check(num_assumptions, assumptions);
         }
 
@@ -123,6 +141,10 @@ namespace smt {
         lbool find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes) {
             return m_kernel.find_mutexes(vars, mutexes);
         }
+
+        lbool get_cubes(expr_ref_vector const& assumptions, unsigned depth, unsigned max_conflicts, vector<expr_ref_vector>& cubes) {
+            return m_kernel.get_cubes(assumptions, depth, max_conflicts, cubes);
+        }
         
         void get_model(model_ref & m) const {
             m_kernel.get_model(m);
@@ -295,6 +317,10 @@ namespace smt {
         return m_imp->find_mutexes(vars, mutexes);
     }
 
+    lbool kernel::get_cubes(expr_ref_vector const& assumptions, unsigned depth, unsigned max_conflicts, vector<expr_ref_vector>& cubes) {
+        return m_imp->get_cubes(assumptions, depth, max_conflicts, cubes);
+    }
+
     void kernel::get_model(model_ref & m) const {
         m_imp->get_model(m);
     }
@@ -138,6 +138,12 @@ namespace smt {
          */
         lbool find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes);
 
+        /**
+           \brief check the assumptions with a conflict budget. If the check is
+           inconclusive, split the search space into cubes of at most depth literals.
+        */
+        lbool get_cubes(expr_ref_vector const& assumptions, unsigned depth, unsigned max_conflicts, vector<expr_ref_vector>& cubes);
+
         /**
            \brief Preferential SAT. 
         */
@@ -39,6 +39,7 @@ namespace smt {
         m_max_cexs(1),
         m_iteration_idx(0),
         m_curr_model(0),
+        m_satisfied_qs(m),
         m_pinned_exprs(m) {
     }
 
@@ -101,11 +102,7 @@ namespace smt {
        The variables are replaced by skolem constants. These constants are stored in sks.
     */
 
-    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
-        expr_ref tmp(m);
-        if (!m_curr_model->eval(q->get_expr(), tmp, true)) {
-            return;
-        }
+    void model_checker::assert_neg_q_m(quantifier * q, expr * tmp, expr_ref_vector & sks) {
         TRACE("model_checker", tout << "q after applying interpretation:\n" << mk_ismt2_pp(tmp, m) << "\n";);
         ptr_buffer<expr> subst_args;
         unsigned num_decls = q->get_num_decls();
@@ -249,19 +246,76 @@ namespace smt {
         return true;
     }
 
+    /**
+       \brief Return true if the body of q under m_curr_model is the body of a previous
+       round in which q was satisfied, and the universes of the variables did not change.
+    */
+    bool model_checker::is_satisfied(quantifier * q, expr * body) {
+        satisfied_entry * e = 0;
+        if (!m_satisfied.find(q, e) || e->m_body != body)
+            return false;
+        unsigned j = 0;
+        for (unsigned i = 0; i < q->get_num_decls(); i++) {
+            sort * s = q->get_decl_sort(i);
+            if (!m_curr_model->is_finite(s))
+                continue;
+            obj_hashtable<expr> const & universe = m_curr_model->get_known_universe(s);
+            unsigned begin = j == 0 ? 0 : e->m_universe_lim[j - 1];
+            unsigned end   = e->m_universe_lim[j];
+            ++j;
+            if (universe.size() != end - begin)
+                return false;
+            for (unsigned k = begin; k < end; ++k)
+                if (!universe.contains(e->m_universe.get(k)))
+                    return false;
+        }
+        return true;
+    }
+
+    void model_checker::set_satisfied(quantifier * q, expr * body) {
+        satisfied_entry * e = 0;
+        if (!m_satisfied.find(q, e)) {
+            e = alloc(satisfied_entry, m);
+            m_satisfied_entries.push_back(e);
+            m_satisfied_qs.push_back(q);
+            m_satisfied.insert(q, e);
+        }
+        e->m_body = body;
+        e->m_universe.reset();
+        e->m_universe_lim.reset();
+        for (unsigned i = 0; i < q->get_num_decls(); i++) {
+            sort * s = q->get_decl_sort(i);
+            if (!m_curr_model->is_finite(s))
+                continue;
+            for (expr * v : m_curr_model->get_known_universe(s))
+                e->m_universe.push_back(v);
+            e->m_universe_lim.push_back(e->m_universe.size());
+        }
+    }
+
     /**
        \brief Return true if q is satisfied by m_curr_model.
     */
     bool model_checker::check(quantifier * q) {
         SASSERT(!m_aux_context->relevancy());
-        m_aux_context->push();
-
         quantifier * flat_q = get_flat_quantifier(q);
         TRACE("model_checker", tout << "model checking:\n" << mk_ismt2_pp(q->get_expr(), m) << "\n" <<
               mk_ismt2_pp(flat_q->get_expr(), m) << "\n";);
+
+        expr_ref body(m);
+        bool has_body = m_curr_model->eval(flat_q->get_expr(), body, true);
+        if (has_body && is_satisfied(flat_q, body)) {
+            TRACE("model_checker", tout << "satisfied in a previous round\n";);
+            m_stats.m_num_cached_checks++;
+            return true;
+        }
+        m_stats.m_num_checks++;
+
+        m_aux_context->push();
         expr_ref_vector sks(m);
 
-        assert_neg_q_m(flat_q, sks);
+        if (has_body)
+            assert_neg_q_m(flat_q, body, sks);
         TRACE("model_checker", tout << "skolems:\n";
               for (expr* sk : sks) {
                   tout << mk_ismt2_pp(sk, m) << " " << mk_pp(m.get_sort(sk), m) << "\n";
@@ -271,6 +325,8 @@ namespace smt {
         TRACE("model_checker", tout << "[complete] model-checker result: " << to_sat_str(r) << "\n";);
         if (r != l_true) {
             m_aux_context->pop(1);
+            if (r == l_false && has_body)
+                set_satisfied(flat_q, body);
             return r == l_false; // quantifier is satisfied by m_curr_model
         }
 
@@ -350,6 +406,7 @@ namespace smt {
             m_fparams = alloc(smt_params, m_context->get_fparams());
             m_fparams->m_relevancy_lvl = 0; // no relevancy since the model checking problems are quantifier free
             m_fparams->m_case_split_strategy = CS_ACTIVITY; // avoid warning messages about smt.case_split >= 3.
+            m_fparams->m_qi_trace_file.clear(); // the instances of the auxiliary context are not traced.
         }
         if (!m_aux_context) {
             symbol logic;
@@ -470,6 +527,14 @@ namespace smt {
 
     void model_checker::reset() {
         reset_new_instances();
+        m_satisfied.reset();
+        m_satisfied_entries.reset();
+        m_satisfied_qs.reset();
+    }
+
+    void model_checker::collect_statistics(::statistics & st) const {
+        st.update("mbqi checks", m_stats.m_num_checks);
+        st.update("mbqi cached checks", m_stats.m_num_cached_checks);
     }
 
     void model_checker::assert_new_instances() {
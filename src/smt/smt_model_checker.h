@@ -26,6 +26,8 @@ Revision History:
 #include "smt/params/qi_params.h"
 #include "smt/params/smt_params.h"
 #include "util/region.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/statistics.h"
 
 class proto_model;
 class model;
@@ -53,10 +55,37 @@ namespace smt {
         obj_map<expr, expr *>                       m_value2expr;
         friend class instantiation_set;
 
+        /**
+           \brief A quantifier that was satisfied by the model of a previous round.
+           m_body is the body of the quantifier under that model, and m_universe contains
+           the universes of the finite sorts of its variables. The check of the quantifier only
+           depends on them, so it is not repeated in a round that produces the same body.
+        */
+        struct satisfied_entry {
+            expr_ref        m_body;
+            expr_ref_vector m_universe;
+            unsigned_vector m_universe_lim;
+            satisfied_entry(ast_manager & m):m_body(m), m_universe(m) {}
+        };
+        obj_map<quantifier, satisfied_entry *>      m_satisfied;
+        scoped_ptr_vector<satisfied_entry>          m_satisfied_entries;
+        expr_ref_vector                             m_satisfied_qs;  // keys of m_satisfied.
+
+        struct stats {
+            unsigned m_num_checks;
+            unsigned m_num_cached_checks;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+        stats                                       m_stats;
+
+        bool is_satisfied(quantifier * q, expr * body);
+        void set_satisfied(quantifier * q, expr * body);
+
         void init_aux_context();
         expr * get_term_from_ctx(expr * val);
         void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
-        void assert_neg_q_m(quantifier * q, expr_ref_vector & sks);
+        void assert_neg_q_m(quantifier * q, expr * body, expr_ref_vector & sks);
         bool add_blocking_clause(model * cex, expr_ref_vector & sks);
         bool check(quantifier * q);
         bool check_rec_fun(quantifier* q, bool strict_rec_fun);
@@ -102,6 +131,8 @@ namespace smt {
 
         void operator()(expr* e);
 
+        void collect_statistics(::statistics & st) const;
+
     };
 };
 
@@ -0,0 +1,451 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Parallel portfolio for smt::context.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include "smt/smt_parallel.h"
+#include "smt/smt_context.h"
+#include "ast/ast_translation.h"
+#include "ast/ast_util.h"
+#include "ast/ast_pp.h"
+#include "util/z3_omp.h"
+
+namespace smt {
+
+    enum par_exception_kind {
+        DEFAULT_EX,
+        ERROR_EX
+    };
+
+    parallel::worker::worker(context & ctx, unsigned id):
+        m_ctx(ctx),
+        m_id(id),
+        m_out(ctx.get_manager()),
+        m_num_units(ctx.m_assigned_literals.size()),
+        m_pool_head(0),
+        m_pinned(ctx.get_manager()) {
+    }
+
+    parallel::parallel(context & ctx):
+        m_ctx(ctx),
+        m_num_threads(ctx.get_fparams().m_threads),
+        m_max_clause_size(ctx.get_fparams().m_threads_max_clause_size),
+        m_pool_capacity(1 << 14),
+        m_pool_size(0),
+        m_done(false) {
+    }
+
+    parallel::~parallel() {
+        m_ctx.set_par(0, 0);
+        m_workers.reset();
+        m_contexts.reset();
+    }
+
+    bool parallel::is_sequential() const {
+        ast_manager & m = m_ctx.get_manager();
+        return m_num_threads <= 1 || omp_in_parallel() || m.proofs_enabled() || m.has_trace_stream() || m_ctx.inconsistent();
+    }
+
+    lbool parallel::setup_and_check() {
+        if (is_sequential()) {
+            return m_ctx.setup_and_check();
+        }
+        // configure the context using the static features of the assertions
+        // before the workers are copied from it.
+        m_ctx.setup_context(m_ctx.get_fparams().m_auto_config);
+        return (*this)(0, 0);
+    }
+
+    lbool parallel::operator()(unsigned num_asms, expr * const * asms) {
+        ast_manager & m = m_ctx.get_manager();
+        if (is_sequential()) {
+            return m_ctx.check(num_asms, asms);
+        }
+
+        vector<expr_ref_vector> worker_asms;
+        init_workers(num_asms, asms, worker_asms);
+        scoped_limits scoped_rlimit(m.limit());
+        for (unsigned i = 0; i < m_managers.size(); ++i) {
+            scoped_rlimit.push_child(&m_managers[i]->limit());
+        }
+
+        int num_threads = static_cast<int>(m_num_threads);
+        int finished_id = -1;
+        lbool result = l_undef;
+        std::string        ex_msg;
+        par_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        int ex_id = -1;
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                lbool r;
+                if (i == 0) {
+                    r = m_ctx.check(num_asms, asms);
+                }
+                else {
+                    expr_ref_vector const & as = worker_asms[i - 1];
+                    r = m_contexts[i - 1]->check(as.size(), as.c_ptr());
+                }
+                bool first = false;
+                if (r != l_undef) {
+                    #pragma omp critical (smt_parallel)
+                    {
+                        if (finished_id == -1) {
+                            finished_id = i;
+                            result = r;
+                            m_done = true;
+                            first = true;
+                        }
+                    }
+                }
+                if (first) {
+                    cancel_others(i);
+                }
+            }
+            catch (z3_error & err) {
+                bool first = false;
+                #pragma omp critical (smt_parallel)
+                {
+                    if (ex_id == -1 && finished_id == -1) {
+                        ex_id = i;
+                        error_code = err.error_code();
+                        ex_kind = ERROR_EX;
+                        first = true;
+                    }
+                }
+                if (first && i == 0) {
+                    m_done = true;
+                    cancel_others(i);
+                }
+            }
+            catch (z3_exception & ex) {
+                bool first = false;
+                #pragma omp critical (smt_parallel)
+                {
+                    if (ex_id == -1 && finished_id == -1) {
+                        ex_id = i;
+                        ex_msg = ex.msg();
+                        ex_kind = DEFAULT_EX;
+                        first = true;
+                    }
+                }
+                if (first && i == 0) {
+                    m_done = true;
+                    cancel_others(i);
+                }
+            }
+        }
+
+        // the first exception thrown before any thread had a result is
+        // reported if it came from the main context, or if no thread found
+        // a result afterwards.
+        if (ex_id == 0 || (ex_id > 0 && finished_id == -1)) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(ex_msg.c_str());
+            }
+        }
+
+        if (finished_id > 0) {
+            // transfer the result of the worker to the main context.
+            context & w = *m_contexts[finished_id - 1];
+            ast_translation tr(w.get_manager(), m, false);
+            m_ctx.m_last_search_failure = OK;
+            m_ctx.m_unsat_core.reset();
+            if (result == l_true) {
+                model_ref mdl;
+                w.get_model(mdl);
+                m_ctx.m_model = mdl ? mdl->translate(tr) : 0;
+            }
+            else {
+                for (unsigned i = 0; i < w.get_unsat_core_size(); ++i) {
+                    m_ctx.m_unsat_core.push_back(tr(w.get_unsat_core_expr(i)));
+                }
+            }
+        }
+        IF_VERBOSE(2, verbose_stream() << "(smt.parallel :winner " << finished_id << " :result " << result << ")\n";);
+        return result;
+    }
+
+    void parallel::init_workers(unsigned num_asms, expr * const * asms, vector<expr_ref_vector> & worker_asms) {
+        ast_manager & m = m_ctx.get_manager();
+        m_pool_manager = alloc(ast_manager, m, true);
+        m_pool = alloc(expr_ref_vector, *m_pool_manager);
+        m_pool->resize(m_pool_capacity);
+        m_pool_owner.resize(m_pool_capacity, UINT_MAX);
+
+        m_ctx.pop_to_base_lvl();
+        m_ctx.set_par(this, 0);
+        m_workers.push_back(alloc(worker, m_ctx, 0));
+        for (unsigned i = 1; i < m_num_threads; ++i) {
+            ast_manager * new_m = alloc(ast_manager, m, true);
+            m_managers.push_back(new_m);
+            smt_params * p = alloc(smt_params, m_ctx.get_fparams());
+            m_params.push_back(p);
+            p->m_threads = 1;
+            p->m_qi_trace_file.clear(); // only the main context writes the trace.
+            p->m_random_seed = m_ctx.get_fparams().m_random_seed + i;
+            p->m_random_initial_activity = IA_RANDOM;
+            if (p->m_case_split_strategy == CS_ACTIVITY ||
+                p->m_case_split_strategy == CS_ACTIVITY_DELAY_NEW ||
+                p->m_case_split_strategy == CS_ACTIVITY_WITH_CACHE) {
+                switch (i % 3) {
+                case 1: p->m_case_split_strategy = CS_ACTIVITY; break;
+                case 2: p->m_case_split_strategy = CS_ACTIVITY_WITH_CACHE; break;
+                default: break;
+                }
+            }
+            context * ctx = alloc(context, *new_m, *p, m_ctx.get_params());
+            m_contexts.push_back(ctx);
+            context::copy(m_ctx, *ctx, true);
+            ctx->setup_context(false);
+            diversify(*ctx, i);
+            ctx->set_par(this, i);
+            m_workers.push_back(alloc(worker, *ctx, i));
+
+            ast_translation tr(m, *new_m, false);
+            worker_asms.push_back(expr_ref_vector(*new_m));
+            for (unsigned j = 0; j < num_asms; ++j) {
+                worker_asms.back().push_back(tr(asms[j]));
+            }
+        }
+    }
+
+    /**
+       \brief the logic specific configuration selects a phase selection
+       strategy, so phases are diversified after the context is configured.
+    */
+    void parallel::diversify(context & ctx, unsigned id) {
+        smt_params & p = ctx.get_fparams();
+        switch (id % 4) {
+        case 1: p.m_phase_selection = PS_CACHING; break;
+        case 2: p.m_phase_selection = PS_ALWAYS_FALSE; break;
+        case 3: p.m_phase_selection = PS_RANDOM; break;
+        default: break;
+        }
+    }
+
+    void parallel::cancel_others(unsigned id) {
+        for (unsigned j = 0; j < m_managers.size(); ++j) {
+            if (j + 1 != id) {
+                m_managers[j]->limit().cancel();
+            }
+        }
+    }
+
+    bool parallel::is_shared(worker & w, expr * e) {
+        ptr_buffer<expr> todo;
+        todo.push_back(e);
+        while (!todo.empty()) {
+            expr * t = todo.back();
+            if (w.m_shared.is_marked(t)) {
+                todo.pop_back();
+                continue;
+            }
+            if (w.m_unshared.is_marked(t)) {
+                return false;
+            }
+            if (!is_app(t) || to_app(t)->get_decl()->is_skolem()) {
+                w.m_unshared.mark(t, true);
+                w.m_pinned.push_back(t);
+                return false;
+            }
+            app * a = to_app(t);
+            bool visited = true;
+            for (unsigned i = 0; i < a->get_num_args(); ++i) {
+                expr * arg = a->get_arg(i);
+                if (w.m_unshared.is_marked(arg)) {
+                    w.m_unshared.mark(t, true);
+                    w.m_pinned.push_back(t);
+                    return false;
+                }
+                if (!w.m_shared.is_marked(arg)) {
+                    todo.push_back(arg);
+                    visited = false;
+                }
+            }
+            if (visited) {
+                w.m_shared.mark(t, true);
+                w.m_pinned.push_back(t);
+                todo.pop_back();
+            }
+        }
+        return true;
+    }
+
+    bool parallel::is_shared(worker & w, literal l) {
+        if (l == true_literal || l == false_literal) {
+            return false;
+        }
+        return is_shared(w, w.m_ctx.bool_var2expr(l.var()));
+    }
+
+    void parallel::share_clause(context & ctx, unsigned num_lits, literal const * lits) {
+        if (num_lits > m_max_clause_size || m_done) {
+            return;
+        }
+        worker & w = *m_workers[ctx.m_par_id];
+        for (unsigned i = 0; i < num_lits; ++i) {
+            if (!is_shared(w, lits[i])) {
+                return;
+            }
+        }
+        ast_manager & m = ctx.get_manager();
+        expr_ref_vector lemma(m);
+        expr_ref e(m);
+        for (unsigned i = 0; i < num_lits; ++i) {
+            ctx.literal2expr(lits[i], e);
+            lemma.push_back(e);
+        }
+        w.m_out.push_back(mk_or(m, lemma.size(), lemma.c_ptr()));
+    }
+
+    /**
+       \brief collect literals assigned at base level since the last exchange.
+    */
+    void parallel::collect_units(worker & w) {
+        context & ctx = w.m_ctx;
+        literal_vector const & trail = ctx.m_assigned_literals;
+        if (w.m_num_units > trail.size()) {
+            w.m_num_units = trail.size();
+        }
+        expr_ref e(ctx.get_manager());
+        for (; w.m_num_units < trail.size(); ++w.m_num_units) {
+            literal l = trail[w.m_num_units];
+            if (ctx.get_assign_level(l) > ctx.m_base_lvl) {
+                break;
+            }
+            if (is_shared(w, l)) {
+                ctx.literal2expr(l, e);
+                w.m_out.push_back(e);
+            }
+        }
+    }
+
+    /**
+       \brief collect equalities between shared terms.
+       \pre the context is at base level, so the equalities do not depend on decisions.
+    */
+    void parallel::collect_eqs(worker & w) {
+        context & ctx = w.m_ctx;
+        ast_manager & m = ctx.get_manager();
+        ptr_vector<enode>::const_iterator it  = ctx.m_enodes.begin();
+        ptr_vector<enode>::const_iterator end = ctx.m_enodes.end();
+        for (; it != end; ++it) {
+            enode * n = *it;
+            enode * r = n->get_root();
+            if (n == r) {
+                continue;
+            }
+            expr * a = n->get_owner();
+            expr * b = r->get_owner();
+            if (m.is_bool(a) || w.m_eqs.contains(std::make_pair(a, b))) {
+                continue;
+            }
+            if ((m.is_value(a) && m.is_value(b)) || !is_shared(w, a) || !is_shared(w, b)) {
+                continue;
+            }
+            // a and b are pinned by is_shared.
+            w.m_eqs.insert(std::make_pair(a, b));
+            w.m_out.push_back(m.mk_eq(a, b));
+        }
+    }
+
+    void parallel::publish(worker & w) {
+        ast_translation tr(w.m_ctx.get_manager(), *m_pool_manager, false);
+        for (unsigned i = 0; i < w.m_out.size(); ++i) {
+            expr_ref lemma(tr(w.m_out.get(i)), *m_pool_manager);
+            if (m_pool_set.contains(lemma)) {
+                continue;
+            }
+            unsigned idx = m_pool_size % m_pool_capacity;
+            expr * old = m_pool->get(idx);
+            if (old) {
+                m_pool_set.remove(old);
+            }
+            m_pool_set.insert(lemma);
+            m_pool->set(idx, lemma);
+            m_pool_owner[idx] = w.m_id;
+            ++m_pool_size;
+        }
+        w.m_ctx.m_stats.m_num_par_shared += w.m_out.size();
+        w.m_out.reset();
+    }
+
+    void parallel::import(worker & w, expr_ref_vector & lemmas) {
+        if (m_pool_size > w.m_pool_head + m_pool_capacity) {
+            // lemmas that were overwritten are lost.
+            w.m_pool_head = m_pool_size - m_pool_capacity;
+        }
+        ast_translation tr(*m_pool_manager, w.m_ctx.get_manager(), false);
+        for (; w.m_pool_head < m_pool_size; ++w.m_pool_head) {
+            unsigned idx = w.m_pool_head % m_pool_capacity;
+            if (m_pool_owner[idx] != w.m_id) {
+                lemmas.push_back(tr(m_pool->get(idx)));
+            }
+        }
+    }
+
+    void parallel::assert_lemma(context & ctx, expr * lemma) {
+        ast_manager & m = ctx.get_manager();
+        unsigned num_lits = 1;
+        expr * const * args = &lemma;
+        if (m.is_or(lemma)) {
+            num_lits = to_app(lemma)->get_num_args();
+            args = to_app(lemma)->get_args();
+        }
+        literal_buffer lits;
+        for (unsigned i = 0; i < num_lits; ++i) {
+            expr * atom = args[i];
+            bool sign = m.is_not(atom, atom);
+            ctx.internalize(atom, true);
+            literal l = ctx.get_literal(atom);
+            if (sign) {
+                l.neg();
+            }
+            if (ctx.relevancy()) {
+                ctx.mark_as_relevant(l);
+            }
+            lits.push_back(l);
+        }
+        TRACE("smt_parallel", tout << "import: " << mk_pp(lemma, m) << "\n";);
+        ctx.mk_clause(lits.size(), lits.c_ptr(), 0, CLS_AUX_LEMMA);
+    }
+
+    bool parallel::exchange(context & ctx) {
+        if (m_done) {
+            return false;
+        }
+        worker & w = *m_workers[ctx.m_par_id];
+        collect_units(w);
+        if (ctx.m_scope_lvl == ctx.m_base_lvl) {
+            collect_eqs(w);
+        }
+        expr_ref_vector lemmas(ctx.get_manager());
+        #pragma omp critical (smt_parallel)
+        {
+            publish(w);
+            import(w, lemmas);
+        }
+        ctx.m_stats.m_num_par_imported += lemmas.size();
+        for (unsigned i = 0; i < lemmas.size() && !ctx.inconsistent(); ++i) {
+            assert_lemma(ctx, lemmas.get(i));
+        }
+        return !m_done;
+    }
+
+};
@@ -0,0 +1,125 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.h
+
+Abstract:
+
+    Parallel portfolio for smt::context.
+
+    The context and diversified copies of it (different random seeds,
+    phase selection and case split strategies) search in parallel.
+    Each copy lives in its own ast_manager. The copies exchange
+    base level units, short learned clauses and equalities between
+    shared terms through a pool of formulas that is accessed using
+    ast_translation.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+    A term is shared if it is ground and does not contain skolem
+    functions. Skolem functions are created independently by each
+    copy, so a name does not have the same meaning in all copies.
+
+--*/
+#ifndef SMT_PARALLEL_H_
+#define SMT_PARALLEL_H_
+
+#include <atomic>
+#include "ast/ast.h"
+#include "util/lbool.h"
+#include "util/obj_pair_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "smt/smt_literal.h"
+
+struct smt_params;
+
+namespace smt {
+
+    class context;
+
+    class parallel {
+
+        struct worker {
+            context &                      m_ctx;
+            unsigned                       m_id;
+            expr_ref_vector                m_out;       // lemmas to publish, over the worker's manager.
+            unsigned                       m_num_units; // base level literals already published.
+            unsigned                       m_pool_head; // pool entries already imported.
+            obj_pair_hashtable<expr, expr> m_eqs;       // equalities already published.
+            expr_mark                      m_shared;
+            expr_mark                      m_unshared;
+            expr_ref_vector                m_pinned;    // marked expressions must not be recycled.
+            worker(context & ctx, unsigned id);
+        };
+
+        context &                       m_ctx;
+        unsigned                        m_num_threads;
+        unsigned                        m_max_clause_size;
+        unsigned                        m_pool_capacity;
+        scoped_ptr_vector<ast_manager>  m_managers;
+        scoped_ptr_vector<smt_params>   m_params;
+        scoped_ptr_vector<context>      m_contexts;
+        scoped_ptr_vector<worker>       m_workers;   // m_workers[0] belongs to m_ctx.
+
+        // pool of exchanged lemmas, used as a ring buffer.
+        scoped_ptr<ast_manager>         m_pool_manager;
+        scoped_ptr<expr_ref_vector>     m_pool;
+        unsigned_vector                 m_pool_owner;
+        unsigned                        m_pool_size;   // number of lemmas ever published.
+        obj_hashtable<expr>             m_pool_set;    // lemmas currently in the pool.
+        std::atomic<bool>               m_done;
+
+        bool is_sequential() const;
+        void init_workers(unsigned num_asms, expr * const * asms, vector<expr_ref_vector> & worker_asms);
+        void diversify(context & ctx, unsigned id);
+        bool is_shared(worker & w, expr * e);
+        bool is_shared(worker & w, literal l);
+        void collect_units(worker & w);
+        void collect_eqs(worker & w);
+        void publish(worker & w);
+        void import(worker & w, expr_ref_vector & lemmas);
+        void assert_lemma(context & ctx, expr * lemma);
+        void cancel_others(unsigned id);
+
+    public:
+        parallel(context & ctx);
+
+        ~parallel();
+
+        /**
+           \brief check satisfiability of the context using m_num_threads threads.
+           The result (model, unsat core, reason unknown) is stored in the context.
+        */
+        lbool operator()(unsigned num_asms, expr * const * asms);
+
+        /**
+           \brief configure the context using its static features and check it
+           using m_num_threads threads.
+        */
+        lbool setup_and_check();
+
+        /**
+           \brief called by the context that owns a worker when it learns a clause.
+        */
+        void share_clause(context & ctx, unsigned num_lits, literal const * lits);
+
+        /**
+           \brief called by the context that owns a worker when it restarts.
+           Publish the lemmas collected since the last exchange and add the
+           lemmas published by other workers.
+           Return false if another worker has solved the problem.
+        */
+        bool exchange(context & ctx);
+
+        bool done() const { return m_done; }
+    };
+
+};
+
+#endif
@@ -380,6 +380,7 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
@@ -549,6 +550,11 @@ namespace smt {
             return m_mam->has_work();
         }
 
+        virtual void collect_statistics(::statistics & st) const {
+            m_mam->collect_statistics(st);
+            m_model_checker->collect_statistics(st);
+        }
+
         virtual void restart_eh() {
             if (m_fparams->m_mbqi) {
                 m_model_finder->restart_eh();
@@ -574,7 +580,7 @@ namespace smt {
                 ptr_vector<enode>::const_iterator end = m_context->end_enodes();
                 unsigned sz = static_cast<unsigned>(end - it);
                 if (sz > m_new_enode_qhead) {
-                    m_context->push_trail(value_trail<context, unsigned>(m_new_enode_qhead));
+                    m_context->push_value_trail(m_new_enode_qhead);
                     it += m_new_enode_qhead;
                     while (m_new_enode_qhead < sz) {
                         enode * e = *it;
@@ -619,7 +625,7 @@ namespace smt {
             if (use_ematching()) {
                 if (m_lazy_matching_idx < m_fparams->m_qi_max_lazy_multipattern_matching) {
                     m_lazy_mam->rematch();
-                    m_context->push_trail(value_trail<context, unsigned>(m_lazy_matching_idx));
+                    m_context->push_value_trail(m_lazy_matching_idx);
                     m_lazy_matching_idx++;
                 }
             }
@@ -0,0 +1,264 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_rephase.cpp
+
+Abstract:
+
+    Target phases and rephasing for smt::context.
+
+    The target phases are the phases of the longest conflict-free trail
+    since the last rephase. The best phases are the phases of the longest
+    conflict-free trail since the last rephase to the best phases.
+    Rephasing periodically overwrites the saved phases; with
+    smt.phase.rephase=walk the new phases are the best assignment found by
+    a ProbSAT style local search over the Boolean skeleton. Theory atoms
+    are treated as Boolean variables by the local search.
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+Notes:
+
+--*/
+#include <cmath>
+#include "smt/smt_context.h"
+
+namespace smt {
+
+    /**
+       \brief Invoked on a conflict. The literals assigned before the conflict
+       level form a conflict-free trail. Save their phases if the trail is
+       longer than the current target (best) trail.
+    */
+    void context::update_target_phase() {
+        if (m_scope_lvl == 0)
+            return;
+        unsigned sz = m_scopes[m_scope_lvl - 1].m_assigned_literals_lim;
+        if (sz > m_target_trail_size) {
+            m_target_trail_size = sz;
+            m_target_phase.reset();
+            m_target_phase.resize(get_num_bool_vars(), l_undef);
+            for (unsigned i = 0; i < sz; ++i) {
+                literal l = m_assigned_literals[i];
+                m_target_phase[l.var()] = l.sign() ? l_false : l_true;
+            }
+        }
+        if (sz > m_best_trail_size) {
+            m_best_trail_size = sz;
+            m_best_phase.reset();
+            m_best_phase.resize(get_num_bool_vars(), l_undef);
+            for (unsigned i = 0; i < sz; ++i) {
+                literal l = m_assigned_literals[i];
+                m_best_phase[l.var()] = l.sign() ? l_false : l_true;
+            }
+        }
+    }
+
+    /**
+       \brief Boolean variables >= num_bool_vars were deleted during backtracking.
+       Their ids may be reused by new atoms.
+    */
+    void context::shrink_saved_phases(unsigned num_bool_vars) {
+        if (m_target_phase.size() > num_bool_vars)
+            m_target_phase.shrink(num_bool_vars);
+        if (m_best_phase.size() > num_bool_vars)
+            m_best_phase.shrink(num_bool_vars);
+    }
+
+    void context::rephase() {
+        static rephase_strategy const cycle[8] = {
+            RP_BEST, RP_WALK, RP_BEST, RP_FLIPPED, RP_BEST, RP_ORIGINAL, RP_BEST, RP_RANDOM
+        };
+        rephase_strategy st = m_fparams.m_rephase;
+        if (st == RP_CYCLE)
+            st = cycle[m_rephase_count % 8];
+        m_stats.m_num_rephases++;
+        unsigned num_vars = get_num_bool_vars();
+        switch (st) {
+        case RP_BEST:
+            for (bool_var v = 0; v < static_cast<bool_var>(m_best_phase.size()); ++v) {
+                if (m_best_phase[v] != l_undef) {
+                    bool_var_data & d = m_bdata[v];
+                    d.m_phase_available = true;
+                    d.m_phase           = m_best_phase[v] == l_true;
+                }
+            }
+            m_best_phase.reset();
+            m_best_trail_size = 0;
+            break;
+        case RP_FLIPPED:
+            for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+                bool_var_data & d = m_bdata[v];
+                if (d.m_phase_available)
+                    d.m_phase = !d.m_phase;
+            }
+            break;
+        case RP_ORIGINAL:
+            for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v)
+                m_bdata[v].m_phase_available = false;
+            break;
+        case RP_RANDOM:
+            for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+                bool_var_data & d = m_bdata[v];
+                d.m_phase_available = true;
+                d.m_phase           = m_random() % 2 == 0;
+            }
+            break;
+        case RP_WALK:
+            walk_phase();
+            break;
+        default:
+            UNREACHABLE();
+        }
+        IF_VERBOSE(2, verbose_stream() << "(smt.rephase " << st << " :conflicts " << m_stats.m_num_conflicts << ")\n";);
+        m_target_phase.reset();
+        m_target_trail_size = 0;
+        m_rephase_count++;
+        m_next_rephase = m_num_conflicts + m_fparams.m_rephase_base * (m_rephase_count + 1);
+    }
+
+    /**
+       \brief Local search over the clauses of the context, starting from the
+       saved phases. Literals assigned at the search level are fixed. The
+       phases of the assignment with the fewest falsified clauses are saved.
+    */
+    void context::walk_phase() {
+        unsigned num_vars = get_num_bool_vars();
+        literal_vector  lits;     // literals of the clauses, without the fixed false literals.
+        unsigned_vector begin;    // begin[i] .. begin[i+1] are the literals of clause i.
+        auto add_clause = [&](unsigned n, literal const * ls) {
+            unsigned sz = lits.size();
+            for (unsigned i = 0; i < n; ++i) {
+                switch (get_assignment(ls[i])) {
+                case l_true:
+                    lits.shrink(sz);
+                    return;
+                case l_false:
+                    break;
+                default:
+                    lits.push_back(ls[i]);
+                }
+            }
+            if (lits.size() == sz)
+                return;
+            begin.push_back(sz);
+        };
+        for (clause * cls : m_aux_clauses)
+            if (!cls->deleted())
+                add_clause(cls->get_num_literals(), cls->begin_literals());
+        for (clause * cls : m_lemmas)
+            if (!cls->deleted())
+                add_clause(cls->get_num_literals(), cls->begin_literals());
+        literal bin[2];
+        for (unsigned l_idx = 0; l_idx < m_watches.size(); ++l_idx) {
+            literal l1 = to_literal(l_idx);
+            watch_list const & wl = m_watches[l_idx];
+            literal const * it  = wl.begin_literals();
+            literal const * end = wl.end_literals();
+            for (; it != end; ++it) {
+                // l1 occurs negated in the binary clause (~l1 or l2).
+                if (l1.index() < it->index()) {
+                    bin[0] = ~l1;
+                    bin[1] = *it;
+                    add_clause(2, bin);
+                }
+            }
+        }
+        unsigned num_clauses = begin.size();
+        begin.push_back(lits.size());
+        if (num_clauses == 0)
+            return;
+
+        vector<unsigned_vector> occs;
+        occs.resize(2 * num_vars);
+        for (unsigned c = 0; c < num_clauses; ++c)
+            for (unsigned i = begin[c]; i < begin[c + 1]; ++i)
+                occs[lits[i].index()].push_back(c);
+
+        svector<bool> value(num_vars, false);
+        for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+            bool_var_data const & d = m_bdata[v];
+            value[v] = d.m_phase_available ? d.m_phase : m_phase_default;
+        }
+        auto is_true = [&](literal l) { return value[l.var()] != l.sign(); };
+
+        unsigned_vector num_true(num_clauses, 0u);
+        unsigned_vector unsat, unsat_pos(num_clauses, UINT_MAX);
+        for (unsigned c = 0; c < num_clauses; ++c) {
+            for (unsigned i = begin[c]; i < begin[c + 1]; ++i)
+                if (is_true(lits[i]))
+                    num_true[c]++;
+            if (num_true[c] == 0) {
+                unsat_pos[c] = unsat.size();
+                unsat.push_back(c);
+            }
+        }
+
+        // ProbSAT break-only scoring: a literal is selected with probability
+        // proportional to cb^-break.
+        double const cb = 2.5;
+        double prob_break[16];
+        for (unsigned i = 0; i < 16; ++i)
+            prob_break[i] = std::pow(cb, -static_cast<double>(i));
+
+        svector<bool> best_value(value);
+        unsigned best_unsat = unsat.size();
+        svector<double> probs;
+        unsigned flips = 0;
+        while (!unsat.empty() && flips < m_fparams.m_rephase_walk_flips && !get_cancel_flag()) {
+            unsigned c = unsat[m_random() % unsat.size()];
+            probs.reset();
+            double sum = 0;
+            for (unsigned i = begin[c]; i < begin[c + 1]; ++i) {
+                // clauses broken by flipping lits[i]: ~lits[i] is their only true literal.
+                unsigned br = 0;
+                for (unsigned d : occs[(~lits[i]).index()])
+                    if (num_true[d] == 1)
+                        ++br;
+                double p = prob_break[std::min(br, 15u)];
+                probs.push_back(p);
+                sum += p;
+            }
+            double lim = sum * (static_cast<double>(m_random()) / (static_cast<double>(random_gen::max_value()) + 1.0));
+            unsigned k = 0;
+            for (; k + 1 < probs.size() && lim >= probs[k]; ++k)
+                lim -= probs[k];
+            literal l = lits[begin[c] + k];
+            ++flips;
+            value[l.var()] = !value[l.var()];
+            for (unsigned d : occs[l.index()]) {
+                if (num_true[d]++ == 0) {
+                    unsigned pos = unsat_pos[d];
+                    unsigned last = unsat.back();
+                    unsat[pos] = last;
+                    unsat_pos[last] = pos;
+                    unsat.pop_back();
+                    unsat_pos[d] = UINT_MAX;
+                }
+            }
+            for (unsigned d : occs[(~l).index()]) {
+                if (--num_true[d] == 0) {
+                    unsat_pos[d] = unsat.size();
+                    unsat.push_back(d);
+                }
+            }
+            if (unsat.size() < best_unsat) {
+                best_unsat = unsat.size();
+                best_value = value;
+            }
+        }
+        TRACE("rephase", tout << "walk flips: " << flips << " unsat: " << best_unsat << " of " << num_clauses << "\n";);
+        for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+            if (get_assignment(v) != l_undef)
+                continue;
+            bool_var_data & d = m_bdata[v];
+            d.m_phase_available = true;
+            d.m_phase           = best_value[v];
+        }
+    }
+
+};
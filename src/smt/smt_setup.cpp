@@ -721,7 +721,12 @@ namespace smt {
     }
 
     void setup::setup_i_arith() {
-        m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));        
+        if (m_params.m_arith_mode == AS_LRA) {
+            m_context.register_plugin(alloc(smt::theory_lra, m_manager, m_params));
+        }
+        else {
+            m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));
+        }
     }
 
     void setup::setup_r_arith() {
@@ -790,6 +795,9 @@ namespace smt {
         case AS_OPTINF:
             m_context.register_plugin(alloc(smt::theory_inf_arith, m_manager, m_params));            
             break;
+        case AS_LRA:
+            m_context.register_plugin(alloc(smt::theory_lra, m_manager, m_params));
+            break;
         default:
             if (m_params.m_arith_int_only && int_only)
                 m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));
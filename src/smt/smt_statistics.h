@@ -46,6 +46,13 @@ namespace smt {
         unsigned m_max_generation;
         unsigned m_num_minimized_lits;
         unsigned m_num_checks;
+        unsigned m_num_par_shared;
+        unsigned m_num_par_imported;
+        unsigned m_num_cubes;
+        unsigned m_num_refuted_cubes;
+        unsigned m_num_pruned_cubes;
+        unsigned m_num_moved_lemmas;
+        unsigned m_num_rephases;
         statistics() {
             reset();
         }
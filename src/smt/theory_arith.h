@@ -45,6 +45,8 @@ namespace smt {
         unsigned m_conflicts, m_add_rows, m_pivots, m_diseq_cs, m_gomory_cuts, m_branches, m_gcd_tests;
         unsigned m_assert_lower, m_assert_upper, m_assert_diseq, m_core2th_eqs, m_core2th_diseqs;
         unsigned m_th2core_eqs, m_th2core_diseqs, m_bound_props, m_offset_eqs, m_fixed_eqs, m_offline_eqs;
+        unsigned m_bound_prop_rows, m_bound_prop_rows_skipped, m_bound_props_useful;
+        unsigned m_mir_cuts, m_cover_cuts, m_cut_pool_duplicates;
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
@@ -267,7 +269,7 @@ namespace smt {
             std::ostream& display(std::ostream& out) const { return a.display(th, out); }
         };
 
-        class gomory_cut_justification;
+        class cut_justification;
 
         class bound { 
         protected:
@@ -304,6 +306,7 @@ namespace smt {
             inf_numeral m_k;
             unsigned    m_atom_kind:2;   // atom kind
             unsigned    m_is_true:1;     // cache: true if the atom was assigned to true.
+            unsigned    m_propagated:1;  // true if the atom was assigned by bound propagation and was not resolved in a conflict yet.
         public:
             atom(bool_var bv, theory_var v, inf_numeral const & k, atom_kind kind);
             atom_kind get_atom_kind() const { return static_cast<atom_kind>(m_atom_kind); }
@@ -311,6 +314,8 @@ namespace smt {
             inline inf_numeral const & get_k() const { return m_k; }
             bool_var get_bool_var() const { return m_bvar; }
             bool is_true() const { return m_is_true; }
+            bool is_propagated() const { return m_propagated; }
+            void set_propagated(bool f) { m_propagated = f; }
             void assign_eh(bool is_true, inf_numeral const & epsilon);
             virtual bool has_justification() const { return true; }
             virtual void push_justification(antecedents& a, numeral const& coeff, bool proofs_enabled) { 
@@ -462,6 +467,11 @@ namespace smt {
 
         svector<unsigned>       m_to_check;    // rows that should be checked for theory propagation
         nat_set                 m_in_to_check; // set of rows in m_to_check. 
+        svector<unsigned>       m_row_fresh_bounds;   // number of bounds asserted on the variables of a row since it was last checked.
+        unsigned                m_bound_prop_budget;  // number of row entries a propagation round may visit.
+        unsigned                m_bound_props_at_update;       // m_stats.m_bound_props when the budget was last updated.
+        unsigned                m_bound_props_useful_at_update;
+        ptr_vector<atom>        m_propagated_atoms;   // atoms marked by assign_bound_literal
         
         inf_numeral             m_tmp;
         random_gen              m_random;
@@ -485,6 +495,7 @@ namespace smt {
             unsigned      m_bounds_to_delete_lim;
             unsigned      m_nl_monomials_lim;
             unsigned      m_nl_propagated_lim;
+            unsigned      m_propagated_atoms_lim;
         };
 
         svector<scope>          m_scopes;
@@ -529,6 +540,7 @@ namespace smt {
         int random_upper() const { return m_params.m_arith_random_upper; }
         unsigned blands_rule_threshold() const { return m_params.m_arith_blands_rule_threshold; }
         bound_prop_mode propagation_mode() const { return m_num_conflicts < m_params.m_arith_propagation_threshold ? m_params.m_arith_bound_prop : BP_NONE; }
+        unsigned bound_prop_budget() const { return m_params.m_arith_bound_prop_budget; }
         bool adaptive() const { return m_params.m_arith_adaptive; }
         double adaptive_assertion_threshold() const { return m_params.m_arith_adaptive_assertion_threshold; }
         unsigned max_lemma_size() const { return m_params.m_arith_max_lemma_size; }
@@ -654,6 +666,7 @@ namespace smt {
         
         virtual void restart_eh();
         virtual void init_search_eh();
+        virtual void conflict_resolution_eh(app * n, bool_var v);
         /**
            \brief True if the assignment may be changed during final
            check.  assume_eqs, check_int_feasibility,
@@ -791,6 +804,8 @@ namespace smt {
         void mk_implied_bound(row const & r, unsigned idx, bool lower, theory_var v, bound_kind kind, inf_numeral const & k);
         void assign_bound_literal(literal l, row const & r, unsigned idx, bool lower, inf_numeral & delta);
         void propagate_bounds();
+        void update_bound_prop_budget();
+        void restore_propagated_atoms(unsigned old_trail_size);
 
         // -----------------------------------
         //
@@ -835,6 +850,34 @@ namespace smt {
         bool constrain_free_vars(row const & r);
         bool is_gomory_cut_target(row const & r);
         bool mk_gomory_cut(row const & r);
+
+        enum cut_kind { MIR_CUT, COVER_CUT };
+
+        /**
+           \brief A cut  m_pol >= m_k  derived at scope level m_scope_lvl from the
+           literals and equalities in m_lits and m_eqs.
+        */
+        struct int_cut {
+            cut_kind          m_kind;
+            vector<row_entry> m_pol;
+            numeral           m_k;
+            literal_vector    m_lits;
+            eq_vector         m_eqs;
+            vector<numeral>   m_lit_coeffs;
+            vector<numeral>   m_eq_coeffs;
+            unsigned          m_scope_lvl;
+            double            m_efficacy;
+        };
+        vector<int_cut>         m_cut_pool;
+        bool cut_var_bound(theory_var v, bool & use_lower, numeral & b) const;
+        bool mk_mir_cut(row const & r, bool negate);
+        bool mk_cover_cut(row const & r);
+        void add_cut_to_pool(cut_kind kind, buffer<row_entry> & pol, numeral const & k, antecedents & ante);
+        numeral cut_slack(int_cut const & c) const;
+        void generate_int_cuts();
+        bool assert_cuts_from_pool();
+        void assert_int_cut(int_cut const & c);
+        void restore_cut_pool(unsigned scope_lvl);
         bool gcd_test(row const & r);
         bool ext_gcd_test(row const & r, numeral const & least_coeff, numeral const & lcm_den, numeral const & consts);
         bool gcd_test();
@@ -388,7 +388,8 @@ namespace smt {
         m_bvar(bv),
         m_k(k),
         m_atom_kind(kind),
-        m_is_true(false) {
+        m_is_true(false),
+        m_propagated(false) {
     }
 
     template<typename Ext>
@@ -2229,7 +2230,7 @@ namespace smt {
         if (m_assume_eq_head == m_assume_eq_candidates.size())
             return false;
 
-        get_context().push_trail(value_trail<context, unsigned>(m_assume_eq_head));
+        get_context().push_value_trail(m_assume_eq_head);
         while (m_assume_eq_head < m_assume_eq_candidates.size()) {
             std::pair<theory_var, theory_var> const & p = m_assume_eq_candidates[m_assume_eq_head];
             theory_var v1 = p.first;
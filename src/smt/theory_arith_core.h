@@ -32,7 +32,7 @@ namespace smt {
     void theory_arith<Ext>::found_unsupported_op(app * n) {
         if (!m_found_unsupported_op) {
             TRACE("arith", tout << "found non supported expression:\n" << mk_pp(n, get_manager()) << "\n";);
-            get_context().push_trail(value_trail<context, bool>(m_found_unsupported_op));
+            get_context().push_value_trail(m_found_unsupported_op);
             m_found_unsupported_op = true;
         }
     }
@@ -41,7 +41,7 @@ namespace smt {
     void theory_arith<Ext>::found_underspecified_op(app * n) {
         if (!m_found_underspecified_op) {
             TRACE("arith", tout << "found underspecificed expression:\n" << mk_pp(n, get_manager()) << "\n";);
-            get_context().push_trail(value_trail<context, bool>(m_found_underspecified_op));
+            get_context().push_value_trail(m_found_underspecified_op);
             m_found_underspecified_op = true;
         }
     }
@@ -1470,7 +1470,7 @@ namespace smt {
             return FC_CONTINUE; 
         if (delayed_assume_eqs())
             return FC_CONTINUE;
-        get_context().push_trail(value_trail<context, unsigned>(m_final_check_idx));
+        get_context().push_value_trail(m_final_check_idx);
         m_liberal_final_check = true;
         m_changed_assignment  = false;
         final_check_status result = final_check_core();
@@ -1582,6 +1582,12 @@ namespace smt {
         m_in_update_trail_stack  .reset();
         m_to_check               .reset();
         m_in_to_check            .reset();
+        m_row_fresh_bounds       .reset();
+        m_bound_prop_budget      = m_params.m_arith_bound_prop_budget;
+        m_bound_props_at_update  = 0;
+        m_bound_props_useful_at_update = 0;
+        m_propagated_atoms       .reset();
+        m_cut_pool               .reset();
         m_num_conflicts          = 0;
         m_bound_trail            .reset();
         m_unassigned_atoms_trail .reset();
@@ -1671,6 +1677,9 @@ namespace smt {
         m_row_vars_top(0),
         m_to_patch(1024),
         m_blands_rule(false),
+        m_bound_prop_budget(params.m_arith_bound_prop_budget),
+        m_bound_props_at_update(0),
+        m_bound_props_useful_at_update(0),
         m_random(params.m_arith_random_seed),
         m_num_conflicts(0),
         m_branch_cut_counter(0),
@@ -2534,13 +2543,21 @@ namespace smt {
     // -----------------------------------
     
     /**
-       \brief Mark the row r1 for bound propagation.
+       \brief Mark the row r1 for bound propagation, and count the fresh
+       bounds of r1 to prioritize the rows in propagate_bounds.
     */
     template<typename Ext>
     void theory_arith<Ext>::mark_row_for_bound_prop(unsigned r1) {
-        if (!m_in_to_check.contains(r1) && m_rows[r1].m_base_var != null_theory_var) {
+        if (m_rows[r1].m_base_var == null_theory_var)
+            return;
+        m_row_fresh_bounds.reserve(r1 + 1, 0);
+        if (!m_in_to_check.contains(r1)) {
             m_in_to_check.insert(r1);
             m_to_check.push_back(r1);
+            m_row_fresh_bounds[r1] = 1;
+        }
+        else {
+            m_row_fresh_bounds[r1]++;
         }
     }
 
@@ -2955,6 +2972,11 @@ namespace smt {
     template<typename Ext>
     void theory_arith<Ext>::assign_bound_literal(literal l, row const & r, unsigned idx, bool is_lower, inf_numeral & delta) {
         m_stats.m_bound_props++;
+        atom * a = get_bv2a(l.var());
+        if (a && !a->is_propagated()) {
+            a->set_propagated(true);
+            m_propagated_atoms.push_back(a);
+        }
         context & ctx = get_context();
         antecedents ante(*this);
         explain_bound(r, idx, is_lower, delta, ante);
@@ -2992,16 +3014,30 @@ namespace smt {
     /**
        \brief Traverse rows in m_to_check and try do derive improved bounds for
        the variables occurring in them.
+
+       Rows with more fresh bounds are visited first. A round stops after
+       visiting m_bound_prop_budget row entries, the remaining rows are
+       dropped until one of their variables gets a new bound.
     */
     template<typename Ext>
     void theory_arith<Ext>::propagate_bounds() {
         TRACE("propagate_bounds_detail", display(tout););
+        context & ctx = get_context();
+        std::stable_sort(m_to_check.begin(), m_to_check.end(), 
+                         [&](unsigned r1, unsigned r2) { return m_row_fresh_bounds[r1] > m_row_fresh_bounds[r2]; });
+        unsigned work = 0;
         typename svector<unsigned>::iterator it  = m_to_check.begin();
         typename svector<unsigned>::iterator end = m_to_check.end();
-        for (; it != end; ++it) {
+        for (; it != end && !ctx.inconsistent(); ++it) {
+            if (m_bound_prop_budget > 0 && work >= m_bound_prop_budget) {
+                m_stats.m_bound_prop_rows_skipped += static_cast<unsigned>(end - it);
+                break;
+            }
             row & r = m_rows[*it];
             if (r.get_base_var() != null_theory_var) {
                 if (r.size() < max_lemma_size()) { // Ignore big rows.
+                    work += r.size();
+                    m_stats.m_bound_prop_rows++;
                     int lower_idx;
                     int upper_idx;
                     is_row_useful_for_bound_prop(r, lower_idx, upper_idx);
@@ -3036,6 +3072,45 @@ namespace smt {
         }
         m_to_check.reset();
         m_in_to_check.reset();
+        update_bound_prop_budget();
+    }
+
+    /**
+       \brief A propagated bound is useful when the core resolves it in a conflict,
+       which may be a clause conflict or the conflict of another theory.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::conflict_resolution_eh(app * n, bool_var v) {
+        atom * a = get_bv2a(v);
+        if (a && a->is_propagated()) {
+            a->set_propagated(false);
+            m_stats.m_bound_props_useful++;
+        }
+    }
+
+    /**
+       \brief Double the budget of bound propagation when at least 10% of the
+       recently propagated bounds were used in conflicts, halve it otherwise.
+       The budget stays within 1/16 and 16 times arith.propagation_budget.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::update_bound_prop_budget() {
+        unsigned base = bound_prop_budget();
+        if (base == 0)
+            return;
+        unsigned props = m_stats.m_bound_props - m_bound_props_at_update;
+        if (props < 256)
+            return;
+        unsigned useful = m_stats.m_bound_props_useful - m_bound_props_useful_at_update;
+        unsigned max_budget = base > UINT_MAX / 16 ? UINT_MAX : 16 * base;
+        unsigned min_budget = std::max(base / 16, 1u);
+        if (10 * static_cast<uint64>(useful) >= props)
+            m_bound_prop_budget = m_bound_prop_budget > max_budget / 2 ? max_budget : 2 * m_bound_prop_budget;
+        else
+            m_bound_prop_budget = std::max(m_bound_prop_budget / 2, min_budget);
+        m_bound_props_at_update        = m_stats.m_bound_props;
+        m_bound_props_useful_at_update = m_stats.m_bound_props_useful;
+        TRACE("propagate_bounds", tout << "useful: " << useful << " of " << props << ", budget: " << m_bound_prop_budget << "\n";);
     }
 
     // -----------------------------------
@@ -3315,6 +3390,7 @@ namespace smt {
         s.m_bounds_to_delete_lim       = m_bounds_to_delete.size();
         s.m_nl_monomials_lim           = m_nl_monomials.size();
         s.m_nl_propagated_lim          = m_nl_propagated.size();
+        s.m_propagated_atoms_lim       = m_propagated_atoms.size();
         CASSERT("arith", wf_rows());
         CASSERT("arith", wf_columns());
         CASSERT("arith", valid_row_assignment());
@@ -3344,6 +3420,8 @@ namespace smt {
         m_asserted_qhead = s.m_asserted_qhead_old;
         TRACE("arith_pop_scope_bug", tout << "num_vars: " << get_num_vars() << ", num_old_vars: " << get_old_num_vars(num_scopes) << "\n";);
         restore_nl_propagated_flag(s.m_nl_propagated_lim);
+        restore_propagated_atoms(s.m_propagated_atoms_lim);
+        restore_cut_pool(new_lvl);
         m_nl_monomials.shrink(s.m_nl_monomials_lim);
         del_atoms(s.m_atoms_lim);
         del_bounds(s.m_bounds_to_delete_lim);
@@ -3373,6 +3451,13 @@ namespace smt {
         m_nl_propagated.shrink(old_trail_size);
     }
 
+    template<typename Ext>
+    void theory_arith<Ext>::restore_propagated_atoms(unsigned old_trail_size) {
+        for (unsigned i = old_trail_size; i < m_propagated_atoms.size(); ++i)
+            m_propagated_atoms[i]->set_propagated(false);
+        m_propagated_atoms.shrink(old_trail_size);
+    }
+
     template<typename Ext>
     void theory_arith<Ext>::restore_bounds(unsigned old_trail_size) {
         CASSERT("arith", wf_rows());
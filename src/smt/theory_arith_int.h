@@ -463,15 +463,15 @@ namespace smt {
     }
 
     template<typename Ext>
-    class theory_arith<Ext>::gomory_cut_justification : public ext_theory_propagation_justification {
+    class theory_arith<Ext>::cut_justification : public ext_theory_propagation_justification {
     public:
-         gomory_cut_justification(family_id fid, region & r, 
-                                 unsigned num_lits, literal const * lits, 
-                                 unsigned num_eqs, enode_pair const * eqs,
-                                 antecedents& bounds, 
-                                 literal consequent):
+        cut_justification(family_id fid, region & r, 
+                          unsigned num_lits, literal const * lits, 
+                          unsigned num_eqs, enode_pair const * eqs,
+                          antecedents& bounds, 
+                          literal consequent, char const * proof_rule):
         ext_theory_propagation_justification(fid, r, num_lits, lits, num_eqs, eqs, consequent,
-                                             bounds.num_params(), bounds.params("gomory-cut")) {
+                                             bounds.num_params(), bounds.params(proof_rule)) {
         }
         // Remark: the assignment must be propagated back to arith
         virtual theory_id get_from_theory() const { return null_theory_id; } 
@@ -649,12 +649,518 @@ namespace smt {
         ctx.mark_as_relevant(l);
         dump_lemmas(l, ante);
         ctx.assign(l, ctx.mk_justification(
-                       gomory_cut_justification(
+                       cut_justification(
                            get_id(), ctx.get_region(), 
                            ante.lits().size(), ante.lits().c_ptr(), 
-                           ante.eqs().size(), ante.eqs().c_ptr(), ante, l)));
+                           ante.eqs().size(), ante.eqs().c_ptr(), ante, l, "gomory-cut")));
         return true;
     }
+
+    // -----------------------------------
+    //
+    // MIR and cover cuts
+    //
+    // -----------------------------------
+
+    /**
+       \brief Select the bound used to complement v in a cut: the bound closest
+       to the value of v. Return false if v has no bound with a rational value,
+       or no integral bound if v is an integer variable.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::cut_var_bound(theory_var v, bool & use_lower, numeral & b) const {
+        bound * l = lower(v);
+        bound * u = upper(v);
+        bool has_l = l != 0 && l->get_value().is_rational() && (is_real(v) || l->get_value().get_rational().is_int());
+        bool has_u = u != 0 && u->get_value().is_rational() && (is_real(v) || u->get_value().get_rational().is_int());
+        if (!has_l && !has_u)
+            return false;
+        if (has_l && has_u) {
+            numeral const & val = get_value(v).get_rational();
+            use_lower = val - l->get_value().get_rational() <= u->get_value().get_rational() - val;
+        }
+        else {
+            use_lower = has_l;
+        }
+        b = use_lower ? l->get_value().get_rational() : u->get_value().get_rational();
+        return true;
+    }
+
+    /**
+       \brief Create a mixed-integer rounding cut for the row  sum c_j x_j = 0.
+
+       Every bounded variable is complemented by its closest bound,
+       x_j = l_j + y_j or x_j = u_j - y_j where y_j >= 0, and integer
+       variables without bounds are kept as they are. This gives 
+       sum a_j y_j = beta, or its negation if negate is true. 
+       For a scaling factor d, alpha_j = a_j/d and f = frac(beta/d) > 0:
+
+       sum_{j int} F(alpha_j) y_j + sum_{j real, alpha_j < 0} alpha_j/(1-f) y_j <= floor(beta/d)
+
+       where F(alpha) = floor(alpha) + max(0, frac(alpha) - f)/(1-f).
+       The scaling factors are 1 and the coefficients of the integer 
+       variables that are not at a bound. The most violated cut is added 
+       to the cut pool.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::mk_mir_cut(row const & r, bool negate) {
+        svector<theory_var> vars;
+        vector<numeral>     as;      // a_j
+        vector<numeral>     ys;      // values of y_j
+        vector<numeral>     bs;      // bounds used to complement the variables
+        svector<char>       kinds;   // 'l': lower, 'u': upper, 'f': free integer variable
+        vector<numeral>     deltas;
+        numeral beta(0);
+        deltas.push_back(numeral(1));
+        typename vector<row_entry>::const_iterator it  = r.begin_entries();
+        typename vector<row_entry>::const_iterator end = r.end_entries();
+        for (; it != end; ++it) {
+            if (it->is_dead())
+                continue;
+            theory_var v = it->m_var;
+            numeral c = negate ? -it->m_coeff : it->m_coeff;
+            numeral const & val = get_value(v).get_rational();
+            bool use_lower;
+            numeral b;
+            vars.push_back(v);
+            if (!cut_var_bound(v, use_lower, b)) {
+                if (is_real(v))
+                    return false;
+                kinds.push_back('f');
+                as.push_back(c);
+                ys.push_back(val);
+                bs.push_back(numeral(0));
+            }
+            else {
+                kinds.push_back(use_lower ? 'l' : 'u');
+                beta -= c * b;
+                as.push_back(use_lower ? c : -c);
+                ys.push_back(use_lower ? val - b : b - val);
+                bs.push_back(b);
+            }
+            if (is_int(v) && (kinds.back() == 'f' || ys.back().is_pos()) && deltas.size() < 8) {
+                numeral d = abs(c);
+                if (std::find(deltas.begin(), deltas.end(), d) == deltas.end())
+                    deltas.push_back(d);
+            }
+        }
+
+        vector<numeral> gs, best_gs;
+        numeral best_rhs;
+        double best_efficacy = 0;
+        for (unsigned i = 0; i < deltas.size(); ++i) {
+            numeral const & d = deltas[i];
+            numeral f = Ext::fractional_part(beta / d);
+            if (f.is_zero())
+                continue;
+            numeral one_minus_f = numeral(1) - f;
+            numeral rhs = floor(beta / d);
+            numeral lhs(0), norm(0);
+            bool ok = true;
+            gs.reset();
+            for (unsigned j = 0; ok && j < vars.size(); ++j) {
+                numeral alpha = as[j] / d;
+                numeral g;
+                if (kinds[j] == 'f') {
+                    ok = alpha.is_int();
+                    g = alpha;
+                }
+                else if (is_int(vars[j])) {
+                    numeral f_j = Ext::fractional_part(alpha);
+                    g = floor(alpha);
+                    if (f_j > f)
+                        g += (f_j - f) / one_minus_f;
+                }
+                else if (alpha.is_neg()) {
+                    g = alpha / one_minus_f;
+                }
+                lhs  += g * ys[j];
+                norm += abs(g);
+                gs.push_back(g);
+            }
+            if (!ok || lhs <= rhs || norm.is_zero())
+                continue;
+            double efficacy = (lhs - rhs).to_rational().get_double() / norm.to_rational().get_double();
+            if (efficacy > best_efficacy) {
+                best_efficacy = efficacy;
+                best_gs = gs;
+                best_rhs = rhs;
+            }
+        }
+        if (best_gs.empty())
+            return false;
+
+        // sum g_j y_j <= rhs  becomes  sum -g_j x_j >= -rhs - sum_{lower} g_j l_j + sum_{upper} g_j u_j
+        antecedents ante(*this);
+        buffer<row_entry> pol;
+        numeral k = -best_rhs;
+        for (unsigned j = 0; j < vars.size(); ++j) {
+            theory_var v = vars[j];
+            numeral const & g = best_gs[j];
+            switch (kinds[j]) {
+            case 'l':
+                k -= g * bs[j];
+                lower(v)->push_justification(ante, g, coeffs_enabled());
+                if (!g.is_zero())
+                    pol.push_back(row_entry(-g, v));
+                break;
+            case 'u':
+                k += g * bs[j];
+                upper(v)->push_justification(ante, g, coeffs_enabled());
+                if (!g.is_zero())
+                    pol.push_back(row_entry(g, v));
+                break;
+            default:
+                if (!g.is_zero())
+                    pol.push_back(row_entry(-g, v));
+                break;
+            }
+        }
+        TRACE("mir_cut", display_row_info(tout, r); tout << "negate: " << negate << " efficacy: " << best_efficacy << "\n";);
+        add_cut_to_pool(MIR_CUT, pol, k, ante);
+        return true;
+    }
+
+    /**
+       \brief Create a lifted cover cut for a row  sum c_j x_j + sum d_k z_k = 0
+       where the x_j are 0-1 variables and the z_k are bounded.
+
+       Replacing each z_k by its lower or upper bound gives the knapsack 
+       sum w_j x_j <= b, with w_j = c_j or w_j = -c_j, and the 
+       variables with negative weights are complemented. A minimal cover C, 
+       sum_C w_j > b, is selected greedily using the current values, and is
+       lifted by the variables with a weight at least max_C w_j. The cut is 
+       sum_{E(C)} x_j <= |C| - 1 over the extended cover E(C).
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::mk_cover_cut(row const & r) {
+        svector<theory_var> xs, zs;
+        vector<numeral>     cs, ds;
+        typename vector<row_entry>::const_iterator it  = r.begin_entries();
+        typename vector<row_entry>::const_iterator end = r.end_entries();
+        for (; it != end; ++it) {
+            if (it->is_dead())
+                continue;
+            theory_var v = it->m_var;
+            bool is_binary = 
+                is_int(v) && lower(v) != 0 && upper(v) != 0 &&
+                lower_bound(v).is_rational() && lower_bound(v).get_rational().is_zero() &&
+                upper_bound(v).is_rational() && upper_bound(v).get_rational().is_one();
+            if (is_binary) {
+                xs.push_back(v);
+                cs.push_back(it->m_coeff);
+            }
+            else if (lower(v) != 0 || upper(v) != 0) {
+                zs.push_back(v);
+                ds.push_back(it->m_coeff);
+            }
+            else {
+                return false;
+            }
+        }
+        if (xs.size() < 2)
+            return false;
+
+        bool result = false;
+        for (unsigned negate = 0; negate < 2; ++negate) {
+            // sum s c_j x_j = - sum s d_k z_k <= - sum_{s d_k > 0} s d_k l_k - sum_{s d_k < 0} s d_k u_k
+            // where s = -1 if negate and s = 1 otherwise.
+            ptr_buffer<bound> bs;
+            numeral b(0);
+            for (unsigned k = 0; k < zs.size(); ++k) {
+                numeral d = negate ? -ds[k] : ds[k];
+                bound * bz = d.is_pos() ? lower(zs[k]) : upper(zs[k]);
+                if (bz == 0 || !bz->get_value().is_rational())
+                    break;
+                b -= d * bz->get_value().get_rational();
+                bs.push_back(bz);
+            }
+            if (bs.size() < zs.size())
+                continue;
+            vector<numeral> ws, vals;
+            svector<bool>   complemented;
+            for (unsigned j = 0; j < xs.size(); ++j) {
+                numeral w = negate ? -cs[j] : cs[j];
+                numeral val = get_value(xs[j]).get_rational();
+                complemented.push_back(w.is_neg());
+                if (w.is_neg()) {
+                    // w x = w - w (1 - x)
+                    b -= w;
+                    w.neg();
+                    val = numeral(1) - val;
+                }
+                ws.push_back(w);
+                vals.push_back(val);
+            }
+            if (b.is_neg())
+                continue;
+            // prefer items with large weights whose complemented value is close to 1.
+            unsigned_vector items;
+            for (unsigned j = 0; j < xs.size(); ++j)
+                if (ws[j].is_pos())
+                    items.push_back(j);
+            std::sort(items.begin(), items.end(), [&](unsigned i, unsigned j) {
+                    return (numeral(1) - vals[i]) * ws[j] < (numeral(1) - vals[j]) * ws[i];
+                });
+            unsigned_vector cover;
+            numeral weight(0);
+            for (unsigned i = 0; i < items.size() && weight <= b; ++i) {
+                cover.push_back(items[i]);
+                weight += ws[items[i]];
+            }
+            if (weight <= b)
+                continue;
+            // make the cover minimal, removing the items with the smallest values first.
+            std::sort(cover.begin(), cover.end(), [&](unsigned i, unsigned j) { return vals[i] < vals[j]; });
+            unsigned_vector min_cover;
+            for (unsigned i = 0; i < cover.size(); ++i) {
+                if (weight - ws[cover[i]] > b)
+                    weight -= ws[cover[i]];
+                else
+                    min_cover.push_back(cover[i]);
+            }
+            numeral max_w(0);
+            svector<bool> in_cut(xs.size(), false);
+            for (unsigned i = 0; i < min_cover.size(); ++i) {
+                in_cut[min_cover[i]] = true;
+                if (ws[min_cover[i]] > max_w)
+                    max_w = ws[min_cover[i]];
+            }
+            for (unsigned j = 0; j < xs.size(); ++j)
+                if (ws[j] >= max_w)
+                    in_cut[j] = true;
+            numeral lhs(0);
+            for (unsigned j = 0; j < xs.size(); ++j)
+                if (in_cut[j])
+                    lhs += vals[j];
+            numeral rhs(static_cast<int>(min_cover.size()) - 1);
+            if (lhs <= rhs)
+                continue;
+
+            // sum_{E(C)} x'_j <= |C| - 1  becomes  sum_{E(C)} -x'_j >= 1 - |C|  where x'_j = 1 - x_j if complemented.
+            antecedents ante(*this);
+            for (unsigned k = 0; k < bs.size(); ++k)
+                bs[k]->push_justification(ante, abs(ds[k]), coeffs_enabled());
+            buffer<row_entry> pol;
+            numeral k = -rhs;
+            for (unsigned j = 0; j < xs.size(); ++j) {
+                theory_var v = xs[j];
+                lower(v)->push_justification(ante, ws[j], coeffs_enabled());
+                upper(v)->push_justification(ante, ws[j], coeffs_enabled());
+                if (!in_cut[j])
+                    continue;
+                if (complemented[j]) {
+                    // 1 - x_j
+                    pol.push_back(row_entry(numeral(1), v));
+                    k += numeral(1);
+                }
+                else {
+                    pol.push_back(row_entry(numeral(-1), v));
+                }
+            }
+            TRACE("cover_cut", display_row_info(tout, r); tout << "cover size: " << min_cover.size() << "\n";);
+            add_cut_to_pool(COVER_CUT, pol, k, ante);
+            result = true;
+        }
+        return result;
+    }
+
+    /**
+       \brief Return  pol - k  for the current assignment of the cut  pol >= k.
+       The cut is violated if the result is negative, and tight if it is zero.
+    */
+    template<typename Ext>
+    typename theory_arith<Ext>::numeral theory_arith<Ext>::cut_slack(int_cut const & c) const {
+        numeral r = -c.m_k;
+        for (unsigned i = 0; i < c.m_pol.size(); ++i)
+            r += c.m_pol[i].m_coeff * get_value(c.m_pol[i].m_var).get_rational();
+        return r;
+    }
+
+    /**
+       \brief Normalize the cut pol >= k and add it to the cut pool. If the pool
+       has a cut with the same left hand side, only the stronger one is kept.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::add_cut_to_pool(cut_kind kind, buffer<row_entry> & pol, numeral const & k, antecedents & ante) {
+        if (pol.empty()) {
+            if (k.is_pos())
+                set_conflict(ante, ante, kind == MIR_CUT ? "mir-cut" : "cover-cut");
+            return;
+        }
+        std::sort(pol.begin(), pol.end(), [](row_entry const & e1, row_entry const & e2) { return e1.m_var < e2.m_var; });
+        numeral n = abs(pol[0].m_coeff);
+        int_cut c;
+        c.m_kind = kind;
+        for (unsigned i = 0; i < pol.size(); ++i)
+            c.m_pol.push_back(row_entry(pol[i].m_coeff / n, pol[i].m_var));
+        c.m_k = k / n;
+        c.m_lits.append(ante.lits());
+        c.m_eqs.append(ante.eqs());
+        if (coeffs_enabled()) {
+            c.m_lit_coeffs.append(ante.lits().size(), ante.lit_coeffs());
+            c.m_eq_coeffs.append(ante.eqs().size(), ante.eq_coeffs());
+        }
+        c.m_scope_lvl = m_scopes.size();
+        c.m_efficacy  = 0;
+
+        for (unsigned i = 0; i < m_cut_pool.size(); ++i) {
+            int_cut & d = m_cut_pool[i];
+            if (d.m_pol.size() != c.m_pol.size())
+                continue;
+            bool same = true;
+            for (unsigned j = 0; same && j < c.m_pol.size(); ++j)
+                same = d.m_pol[j].m_var == c.m_pol[j].m_var && d.m_pol[j].m_coeff == c.m_pol[j].m_coeff;
+            if (!same)
+                continue;
+            m_stats.m_cut_pool_duplicates++;
+            if (c.m_k > d.m_k)
+                d = c;
+            return;
+        }
+        m_cut_pool.push_back(c);
+    }
+
+    /**
+       \brief Generate MIR cuts for the rows of integer variables with a 
+       fractional value, and cover cuts for the knapsack rows.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::generate_int_cuts() {
+        context & ctx = get_context();
+        for (unsigned r_id = 0; r_id < m_rows.size() && !ctx.inconsistent() && !ctx.get_cancel_flag(); ++r_id) {
+            row const & r = m_rows[r_id];
+            theory_var b = r.get_base_var();
+            if (b == null_theory_var)
+                continue;
+            if (m_params.m_arith_mir_cuts && is_int(b) && !get_value(b).is_int()) {
+                mk_mir_cut(r, false);
+                mk_mir_cut(r, true);
+            }
+            if (m_params.m_arith_cover_cuts)
+                mk_cover_cut(r);
+        }
+    }
+
+    /**
+       \brief Remove the cuts that are not tight at the current assignment from 
+       the pool, and assert the most efficacious violated cuts.
+       Return true if a cut was asserted.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::assert_cuts_from_pool() {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_cut_pool.size(); ++i) {
+            int_cut & c = m_cut_pool[i];
+            numeral slack = cut_slack(c);
+            if (slack.is_pos())
+                continue;
+            numeral norm(0);
+            for (unsigned l = 0; l < c.m_pol.size(); ++l)
+                norm += abs(c.m_pol[l].m_coeff);
+            c.m_efficacy = -slack.to_rational().get_double() / norm.to_rational().get_double();
+            if (i != j)
+                m_cut_pool[j] = c;
+            ++j;
+        }
+        m_cut_pool.shrink(j);
+        unsigned_vector idx;
+        for (unsigned i = 0; i < m_cut_pool.size(); ++i)
+            idx.push_back(i);
+        std::sort(idx.begin(), idx.end(), [&](unsigned i1, unsigned i2) { return m_cut_pool[i1].m_efficacy > m_cut_pool[i2].m_efficacy; });
+        unsigned num_asserted = 0;
+        svector<bool> asserted(m_cut_pool.size(), false);
+        for (unsigned i = 0; i < idx.size() && num_asserted < m_params.m_arith_max_cuts_per_round; ++i) {
+            int_cut const & c = m_cut_pool[idx[i]];
+            if (c.m_efficacy <= 0 || get_context().inconsistent())
+                break;
+            assert_int_cut(c);
+            asserted[idx[i]] = true;
+            ++num_asserted;
+        }
+        // keep the tight cuts that were not asserted, the most efficacious first.
+        vector<int_cut> pool;
+        for (unsigned i = 0; i < idx.size() && pool.size() < m_params.m_arith_cut_pool_size; ++i)
+            if (!asserted[idx[i]])
+                pool.push_back(m_cut_pool[idx[i]]);
+        m_cut_pool.swap(pool);
+        TRACE("int_cut", tout << "asserted: " << num_asserted << " pool: " << m_cut_pool.size() << "\n";);
+        return num_asserted > 0;
+    }
+
+    template<typename Ext>
+    void theory_arith<Ext>::assert_int_cut(int_cut const & c) {
+        context & ctx = get_context();
+        char const * proof_rule = c.m_kind == MIR_CUT ? "mir-cut" : "cover-cut";
+        if (c.m_kind == MIR_CUT)
+            m_stats.m_mir_cuts++;
+        else
+            m_stats.m_cover_cuts++;
+        antecedents ante(*this);
+        for (unsigned i = 0; i < c.m_lits.size(); ++i)
+            ante.push_lit(c.m_lits[i], i < c.m_lit_coeffs.size() ? c.m_lit_coeffs[i] : numeral(1), coeffs_enabled());
+        for (unsigned i = 0; i < c.m_eqs.size(); ++i)
+            ante.push_eq(c.m_eqs[i], i < c.m_eq_coeffs.size() ? c.m_eq_coeffs[i] : numeral(1), coeffs_enabled());
+
+        buffer<row_entry> pol;
+        numeral k = c.m_k;
+        bool all_int = true;
+        numeral lcm_den(1);
+        for (unsigned i = 0; i < c.m_pol.size(); ++i) {
+            pol.push_back(c.m_pol[i]);
+            all_int = all_int && is_int(c.m_pol[i].m_var);
+            lcm_den = lcm(lcm_den, denominator(c.m_pol[i].m_coeff));
+        }
+        if (all_int) {
+            // normalize to integer coefficients and round up the bound.
+            for (unsigned i = 0; i < pol.size(); ++i)
+                pol[i].m_coeff *= lcm_den;
+            k = ceil(k * lcm_den);
+        }
+        expr_ref bound(get_manager());
+        if (pol.size() == 1) {
+            theory_var v = pol[0].m_var;
+            k /= pol[0].m_coeff;
+            bool is_lower = pol[0].m_coeff.is_pos();
+            if (is_int(v) && !k.is_int())
+                k = is_lower ? ceil(k) : floor(k);
+            rational _k = k.to_rational();
+            if (is_lower)
+                bound = m_util.mk_ge(get_enode(v)->get_owner(), m_util.mk_numeral(_k, is_int(v)));
+            else
+                bound = m_util.mk_le(get_enode(v)->get_owner(), m_util.mk_numeral(_k, is_int(v)));
+        }
+        else {
+            mk_polynomial_ge(pol.size(), pol.c_ptr(), k.to_rational(), bound);
+        }
+        TRACE("int_cut", tout << proof_rule << ":\n" << bound << "\n"; ante.display(tout););
+        ctx.internalize(bound, true);
+        literal l = ctx.get_literal(bound);
+        ctx.mark_as_relevant(l);
+        dump_lemmas(l, ante);
+        ctx.assign(l, ctx.mk_justification(
+                       cut_justification(
+                           get_id(), ctx.get_region(), 
+                           ante.lits().size(), ante.lits().c_ptr(), 
+                           ante.eqs().size(), ante.eqs().c_ptr(), ante, l, proof_rule)));
+    }
+
+    /**
+       \brief Remove the cuts derived above the scope level scope_lvl, 
+       their justifications are not valid anymore.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::restore_cut_pool(unsigned scope_lvl) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_cut_pool.size(); ++i) {
+            if (m_cut_pool[i].m_scope_lvl > scope_lvl)
+                continue;
+            if (i != j)
+                m_cut_pool[j] = m_cut_pool[i];
+            ++j;
+        }
+        m_cut_pool.shrink(j);
+    }
     
     /**
        \brief Return false if the row failed the GCD test, that is, a conflict was detected.
@@ -1401,6 +1907,11 @@ namespace smt {
                 if (!mk_gomory_cut(r)) {
                     // silent failure
                 }
+                if (!get_context().inconsistent() && (m_params.m_arith_mir_cuts || m_params.m_arith_cover_cuts)) {
+                    generate_int_cuts();
+                    if (!get_context().inconsistent())
+                        assert_cuts_from_pool();
+                }
                 return FC_CONTINUE;
             }
         }
@@ -2262,7 +2262,7 @@ namespace smt {
             m_stats.m_gb_compute_basis++;
             if (!r && !warn) {
                 IF_VERBOSE(3, verbose_stream() << "Grobner basis computation interrupted. Increase threshold using NL_ARITH_GB_THRESHOLD=<limit>\n";);
-                get_context().push_trail(value_trail<context, bool>(m_nl_gb_exhausted));
+                get_context().push_value_trail(m_nl_gb_exhausted);
                 m_nl_gb_exhausted = true;
                 warn              = true;
             }
@@ -2381,7 +2381,7 @@ namespace smt {
             return FC_GIVEUP;
         }
 
-        get_context().push_trail(value_trail<context, unsigned>(m_nl_rounds));
+        get_context().push_value_trail(m_nl_rounds);
         m_nl_rounds++;
 
         elim_quasi_base_rows();
@@ -2405,7 +2405,7 @@ namespace smt {
 
         bool progress;
         unsigned old_idx = m_nl_strategy_idx;
-        get_context().push_trail(value_trail<context, unsigned>(m_nl_strategy_idx));
+        get_context().push_value_trail(m_nl_strategy_idx);
 
         do {
             progress = false;
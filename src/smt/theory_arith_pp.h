@@ -33,11 +33,17 @@ namespace smt {
         st.update("arith assert upper", m_stats.m_assert_upper);
         st.update("arith assert diseq", m_stats.m_assert_diseq);
         st.update("arith bound prop", m_stats.m_bound_props);
+        st.update("arith bound prop useful", m_stats.m_bound_props_useful);
+        st.update("arith bound prop rows", m_stats.m_bound_prop_rows);
+        st.update("arith bound prop rows skipped", m_stats.m_bound_prop_rows_skipped);
         st.update("arith fixed eqs", m_stats.m_fixed_eqs);
         st.update("arith offset eqs", m_stats.m_offset_eqs);
         st.update("arith gcd tests", m_stats.m_gcd_tests);
         st.update("arith ineq splits", m_stats.m_branches);
         st.update("arith gomory cuts", m_stats.m_gomory_cuts);
+        st.update("arith mir cuts", m_stats.m_mir_cuts);
+        st.update("arith cover cuts", m_stats.m_cover_cuts);
+        st.update("arith cut pool duplicates", m_stats.m_cut_pool_duplicates);
         st.update("arith max-min", m_stats.m_max_min);
         st.update("arith grobner", m_stats.m_gb_compute_basis);
         st.update("arith pseudo nonlinear", m_stats.m_nl_linear);
@@ -1085,7 +1085,7 @@ namespace smt {
             if (m_util.is_bv_sort(s) && m_util.get_bv_size(arg) > m_params.m_bv_blast_max_size) {                
                 if (!m_approximates_large_bvs) {
                     TRACE("bv", tout << "found large size bit-vector:\n" << mk_pp(n, get_manager()) << "\n";);
-                    get_context().push_trail(value_trail<context, bool>(m_approximates_large_bvs));
+                    get_context().push_value_trail(m_approximates_large_bvs);
                     m_approximates_large_bvs = true;
                 }
                 return true;
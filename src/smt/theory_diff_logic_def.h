@@ -159,7 +159,7 @@ void theory_diff_logic<Ext>::found_non_diff_logic_expr(expr * n) {
     if (!m_non_diff_logic_exprs) {
         TRACE("non_diff_logic", tout << "found non diff logic expression:\n" << mk_pp(n, get_manager()) << "\n";);
         IF_VERBOSE(0, verbose_stream() << "(smt.diff_logic: non-diff logic expression " << mk_pp(n, get_manager()) << ")\n";); 
-        get_context().push_trail(value_trail<context, bool>(m_non_diff_logic_exprs));
+        get_context().push_value_trail(m_non_diff_logic_exprs);
         m_non_diff_logic_exprs = true;
     }
 }
@@ -24,6 +24,7 @@ Revision History:
 #include "util/lp/lp_dual_simplex.h"
 #include "util/lp/indexed_value.h"
 #include "util/lp/lar_solver.h"
+#include "util/lp/int_solver.h"
 #include "util/nat_set.h"
 #include "util/optional.h"
 #include "util/lp/lp_params.hpp"
@@ -97,6 +98,13 @@ namespace lp {
         unsigned m_make_feasible;
         unsigned m_max_cols;
         unsigned m_max_rows;
+        unsigned m_gcd_conflicts;
+        unsigned m_tighten_conflicts;
+        unsigned m_patches;
+        unsigned m_gomory_cuts;
+        unsigned m_branch;
+        unsigned m_double_presolves;
+        unsigned m_double_presolve_repairs;
         stats() { reset(); }
         void reset() {
             memset(this, 0, sizeof(*this));
@@ -266,6 +274,7 @@ namespace smt {
         lp::stats              m_stats;
         arith_factory*         m_factory;
         scoped_ptr<lean::lar_solver> m_solver;
+        scoped_ptr<lean::int_solver> m_lia;
         resource_limit         m_resource_limit;
         lp_bounds              m_new_bounds;
 
@@ -288,6 +297,13 @@ namespace smt {
             reset_variable_values();
             m_solver->settings().bound_propagation() = BP_NONE != propagation_mode();
             m_solver->set_propagate_bounds_on_pivoted_rows_mode(lp.bprop_on_pivoted_rows());
+            m_solver->settings().presolve_with_double_solver_for_lar = lp.presolve_with_doubles();
+            m_solver->settings().presolve_with_doubles_min_infeasible = lp.presolve_with_doubles_min_infeasible();
+            m_solver->settings().lu_max_updates = lp.lu_max_updates();
+            m_solver->settings().lu_eta_growth_factor = lp.lu_eta_growth_factor();
+            m_solver->settings().m_int_branch_cut_ratio = m_arith_params.m_arith_branch_cut_ratio;
+            m_solver->settings().m_int_run_gcd_test = m_arith_params.m_arith_gcd_test;
+            m_lia = alloc(lean::int_solver, *m_solver.get());
             //m_solver->settings().set_ostream(0);
         }
 
@@ -391,9 +407,6 @@ namespace smt {
                     if (is_app(n)) {
                         internalize_args(to_app(n));
                     }
-                    if (a.is_int(n)) {
-                        found_not_handled(n);
-                    }
                     theory_var v = mk_var(n);
                     coeffs[vars.size()] = coeffs[index];
                     vars.push_back(v);
@@ -490,7 +503,7 @@ namespace smt {
                 result = m_theory_var2var_index[v];
             }
             if (result == UINT_MAX) {
-                result = m_solver->add_var(v); // TBD: is_int(v);
+                result = m_solver->add_var(v, is_int(v));
                 m_theory_var2var_index.setx(v, result, UINT_MAX);
                 m_var_index2theory_var.setx(result, v, UINT_MAX);
                 m_var_trail.push_back(v);
@@ -1124,7 +1137,7 @@ namespace smt {
             if (m_assume_eq_head == m_assume_eq_candidates.size())
                 return false;
 
-            ctx().push_trail(value_trail<context, unsigned>(m_assume_eq_head));
+            ctx().push_value_trail(m_assume_eq_head);
             while (m_assume_eq_head < m_assume_eq_candidates.size()) {
                 std::pair<theory_var, theory_var> const & p = m_assume_eq_candidates[m_assume_eq_head];
                 theory_var v1 = p.first;
@@ -1146,6 +1159,113 @@ namespace smt {
             return !(m_asserted_atoms.empty() && m_delayed_terms.empty() && m_delayed_equalities.empty());
         }
 
+        theory_var lp_var2theory_var(lean::var_index vi) const {
+            if (m_solver->is_term(vi)) {
+                return m_term_index2theory_var.get(m_solver->adjust_term_index(vi), null_theory_var);
+            }
+            return m_var_index2theory_var.get(vi, null_theory_var);
+        }
+
+        /**
+           \brief Create the atom term >= k (lower_bound) or term <= k over the
+           variables and terms of the lp solver.
+        */
+        app_ref mk_bound(lean::lar_term const& term, rational const& k, bool lower_bound) {
+            bool all_int = true;
+            for (auto const& p : term.m_coeffs) {
+                theory_var v = lp_var2theory_var(p.first);
+                SASSERT(v != null_theory_var);
+                all_int &= is_int(v) && p.second.is_int();
+            }
+            expr_ref_vector args(m);
+            for (auto const& p : term.m_coeffs) {
+                expr* x = get_owner(lp_var2theory_var(p.first));
+                if (a.is_int(x) && !all_int) {
+                    x = a.mk_to_real(x);
+                }
+                if (p.second.is_one()) {
+                    args.push_back(x);
+                }
+                else {
+                    args.push_back(a.mk_mul(a.mk_numeral(p.second, a.is_int(x)), x));
+                }
+            }
+            expr_ref t(m);
+            t = args.size() == 1 ? args.get(0) : a.mk_add(args.size(), args.c_ptr());
+            rational bound = k;
+            if (all_int) {
+                bound = lower_bound ? ceil(k) : floor(k);
+            }
+            app_ref atom(m);
+            if (lower_bound) {
+                atom = a.mk_ge(t, a.mk_numeral(bound, all_int));
+            }
+            else {
+                atom = a.mk_le(t, a.mk_numeral(bound, all_int));
+            }
+            return atom;
+        }
+
+        /**
+           \brief Check that the integer variables have integral values.
+           l_true: they do, l_false: a branch, cut or conflict was created,
+           l_undef: the integer solver gave up.
+        */
+        lbool check_lia() {
+            if (m.canceled()) {
+                return l_undef;
+            }
+            lean::lar_term term;
+            rational k;
+            lean::explanation ex;
+            lean::lia_move r = m_lia->check(term, k, ex);
+            lean::stats const& st = m_solver->settings().st();
+            m_stats.m_gcd_conflicts = st.m_gcd_conflicts;
+            m_stats.m_tighten_conflicts = st.m_tighten_conflicts;
+            m_stats.m_patches       = st.m_int_patches;
+            m_stats.m_gomory_cuts   = st.m_gomory_cuts;
+            m_stats.m_branch        = st.m_int_branches;
+            switch (r) {
+            case lean::lia_move::ok:
+                return l_true;
+            case lean::lia_move::branch: {
+                // the case split term <= k or term >= k + 1 is left to the core.
+                app_ref b = mk_bound(term, k, false);
+                TRACE("arith", tout << "branch " << b << "\n";);
+                ctx().internalize(b, true);
+                ctx().mark_as_relevant(b.get());
+                return l_false;
+            }
+            case lean::lia_move::cut: {
+                app_ref b = mk_bound(term, k, true);
+                TRACE("arith", tout << "cut " << b << "\n";);
+                ctx().internalize(b, true);
+                literal lit = ctx().get_literal(b);
+                ctx().mark_as_relevant(b.get());
+                m_eqs.reset();
+                m_core.reset();
+                m_params.reset();
+                for (auto const& ev : ex.m_explanation) {
+                    if (!ev.first.is_zero()) {
+                        set_evidence(ev.second);
+                    }
+                }
+                assign(lit);
+                return l_false;
+            }
+            case lean::lia_move::conflict:
+                m_explanation.clear();
+                m_explanation.append(ex.m_explanation);
+                set_conflict_from_explanation();
+                return l_false;
+            case lean::lia_move::give_up:
+                return l_undef;
+            default:
+                UNREACHABLE();
+            }
+            return l_undef;
+        }
+
         final_check_status final_check_eh() {
             lbool is_sat = l_true;
             if (m_delay_constraints) {
@@ -1174,6 +1294,14 @@ namespace smt {
                 if (delayed_assume_eqs()) {
                     return FC_CONTINUE;
                 }
+                switch (check_lia()) {
+                case l_true:
+                    break;
+                case l_false:
+                    return FC_CONTINUE;
+                case l_undef:
+                    return FC_GIVEUP;
+                }
                 if (assume_eqs()) {
                     return FC_CONTINUE;
                 }
@@ -1965,12 +2093,23 @@ namespace smt {
             else {
                 ++m_stats.m_assert_upper;
             }
+            rational value = b.get_value();
+            if (is_int(b.get_var())) {
+                // integer bounds are non-strict and integral
+                switch (k) {
+                case lean::LT: k = lean::LE; value = ceil(value) - rational::one(); break;
+                case lean::LE: value = floor(value); break;
+                case lean::GT: k = lean::GE; value = floor(value) + rational::one(); break;
+                case lean::GE: value = ceil(value); break;
+                default: break;
+                }
+            }
             auto vi = get_var_index(b.get_var());
-            auto ci = m_solver->add_var_bound(vi, k, b.get_value());
+            auto ci = m_solver->add_var_bound(vi, k, value);
             TRACE("arith", tout << "v" << b.get_var() << "\n";);
             add_ineq_constraint(ci, literal(bv, !is_true));
 
-            propagate_eqs(vi, ci, k, b);
+            propagate_eqs(vi, ci, k, b, value);
         }
 
         //
@@ -1988,9 +2127,8 @@ namespace smt {
         typedef map<value_sort_pair, theory_var, value_sort_pair_hash, default_eq<value_sort_pair> > value2var;
         value2var               m_fixed_var_table;
 
-        void propagate_eqs(lean::var_index vi, lean::constraint_index ci, lean::lconstraint_kind k, lp::bound& b) {
+        void propagate_eqs(lean::var_index vi, lean::constraint_index ci, lean::lconstraint_kind k, lp::bound& b, rational const& value) {
             if (propagate_eqs()) {
-                rational const& value = b.get_value();
                 if (k == lean::GE) {
                     set_lower_bound(vi, ci, value);
                     if (has_upper_bound(vi, ci, value)) {
@@ -2149,6 +2287,8 @@ namespace smt {
             m_stats.m_num_iterations = m_solver->settings().st().m_total_iterations;
             m_stats.m_num_factorizations = m_solver->settings().st().m_num_factorizations;
             m_stats.m_need_to_solve_inf = m_solver->settings().st().m_need_to_solve_inf;
+            m_stats.m_double_presolves = m_solver->settings().st().m_double_presolves;
+            m_stats.m_double_presolve_repairs = m_solver->settings().st().m_double_presolve_repairs;
 
             switch (status) {
             case lean::lp_status::INFEASIBLE:
@@ -2202,9 +2342,6 @@ namespace smt {
         }
 
         void set_conflict() {
-            m_eqs.reset();
-            m_core.reset();
-            m_params.reset();
             m_explanation.clear();
             m_solver->get_infeasibility_explanation(m_explanation);
             // m_solver->shrink_explanation_to_minimum(m_explanation); // todo, enable when perf is fixed
@@ -2214,6 +2351,13 @@ namespace smt {
             num_l+=m_explanation.size();
             std::cout << num_l / (++cn) << "\n";
             */
+            set_conflict_from_explanation();
+        }
+
+        void set_conflict_from_explanation() {
+            m_eqs.reset();
+            m_core.reset();
+            m_params.reset();
             ++m_num_conflicts;
             ++m_stats.m_conflicts;
             TRACE("arith", tout << "scope: " << ctx().get_scope_level() << "\n"; display_evidence(tout, m_explanation); );
@@ -2238,6 +2382,7 @@ namespace smt {
 
         void reset_eh() {
             m_arith_eq_adapter.reset_eh();
+            m_lia = 0;
             m_solver = 0;
             m_not_handled = nullptr;
             del_bounds(0);
@@ -2512,6 +2657,13 @@ namespace smt {
             st.update("arith-make-feasible", m_stats.m_make_feasible);
             st.update("arith-max-columns", m_stats.m_max_cols);
             st.update("arith-max-rows", m_stats.m_max_rows);
+            st.update("arith-gcd-conflicts", m_stats.m_gcd_conflicts);
+            st.update("arith-tighten-conflicts", m_stats.m_tighten_conflicts);
+            st.update("arith-patches", m_stats.m_patches);
+            st.update("arith-gomory-cuts", m_stats.m_gomory_cuts);
+            st.update("arith-branch", m_stats.m_branch);
+            st.update("arith-double-presolves", m_stats.m_double_presolves);
+            st.update("arith-double-presolve-repairs", m_stats.m_double_presolve_repairs);
         }
     };
 
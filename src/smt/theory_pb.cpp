@@ -914,7 +914,7 @@ namespace smt {
         context& ctx = get_context();
         ctx.push_trail(value_trail<context, scoped_mpz>(c.m_max_sum));
         ctx.push_trail(value_trail<context, scoped_mpz>(c.m_min_sum));
-        ctx.push_trail(value_trail<context, unsigned>(c.m_nfixed));
+        ctx.push_value_trail(c.m_nfixed);
         ctx.push_trail(rewatch_vars(*this, c));
 
         clear_watch(c);
@@ -1030,7 +1030,7 @@ namespace smt {
             );
         SASSERT(c.min_sum() <= c.max_sum());
         SASSERT(!m_mpz_mgr.is_neg(c.min_sum()));
-        ctx.push_trail(value_trail<context, unsigned>(c.m_nfixed));
+        ctx.push_value_trail(c.m_nfixed);
         ++c.m_nfixed;
         SASSERT(c.nfixed() <= c.size());
         if (c.is_ge() && c.min_sum() >= c.mpz_k() && asgn != l_true) {
@@ -149,7 +149,7 @@ namespace smt {
     class theory_seq_empty : public theory {
         bool m_used;
         virtual final_check_status final_check_eh() { return m_used?FC_GIVEUP:FC_DONE; }
-        virtual bool internalize_atom(app*, bool) { if (!m_used) { get_context().push_trail(value_trail<context,bool>(m_used)); m_used = true; } return false; }
+        virtual bool internalize_atom(app*, bool) { if (!m_used) { get_context().push_value_trail(m_used); m_used = true; } return false; }
         virtual bool internalize_term(app*) { return internalize_atom(0,false);  }
         virtual void new_eq_eh(theory_var, theory_var) { }
         virtual void new_diseq_eh(theory_var, theory_var) {}
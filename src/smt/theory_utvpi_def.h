@@ -251,7 +251,7 @@ namespace smt {
             msg << "found non utvpi logic expression:\n" << mk_pp(n, get_manager()) << "\n";
             TRACE("utvpi", tout << msg.str(););
             warning_msg("%s", msg.str().c_str());
-            get_context().push_trail(value_trail<context, bool>(m_non_utvpi_exprs));
+            get_context().push_value_trail(m_non_utvpi_exprs);
             m_non_utvpi_exprs = true;
         }
     }
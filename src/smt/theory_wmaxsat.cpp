@@ -164,7 +164,7 @@ namespace smt {
             w = m_zweights[tv];
             ctx.push_trail(numeral_trail(m_zcost, m_old_values));
             ctx.push_trail(push_back_vector<context, svector<theory_var> >(m_costs));
-            ctx.push_trail(value_trail<context, bool>(m_assigned[tv]));
+            ctx.push_value_trail(m_assigned[tv]);
             m_zcost += w;
             TRACE("opt", tout << "Assign v" << tv << " weight: " << w << " cost: " << m_zcost << " " << mk_pp(m_vars[m_bool2var[v]].get(), get_manager()) << "\n";);
             m_costs.push_back(tv);
@@ -304,7 +304,7 @@ namespace smt {
         }
         // 
         if (max_unassigned > m_max_unassigned_index) {
-            ctx.push_trail(value_trail<context, unsigned>(m_max_unassigned_index));
+            ctx.push_value_trail(m_max_unassigned_index);
             m_max_unassigned_index = max_unassigned;
         }
         if (max_unassigned < m_sorted_vars.size() && 
@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    arith_cuts.cpp
+
+Abstract:
+
+    Test the MIR and lifted cover cuts of theory_arith.
+
+--*/
+
+#include "smt/smt_context.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "util/statistics.h"
+
+static unsigned get_stat(smt::context & ctx, char const * key) {
+    statistics st;
+    ctx.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+static void add_row(smt::context & ctx, app_ref_vector const & xs, int const * coeffs, bool is_eq, int k) {
+    ast_manager & m = ctx.get_manager();
+    arith_util a(m);
+    expr_ref_vector ts(m);
+    for (unsigned i = 0; i < xs.size(); ++i)
+        ts.push_back(a.mk_mul(a.mk_int(coeffs[i]), xs[i]));
+    expr_ref lhs(a.mk_add(ts.size(), ts.c_ptr()), m);
+    expr_ref rhs(a.mk_int(k), m);
+    ctx.assert_expr(is_eq ? m.mk_eq(lhs, rhs) : a.mk_le(lhs, rhs));
+}
+
+// an infeasible system over four 0-1 variables and two non-negative integers:
+// MIR cuts come from the rows with a fractional base variable, and cover cuts
+// from the rows that are knapsack constraints after relaxing x4 and x5.
+static void tst_cuts(bool cuts, unsigned pool_size) {
+    smt_params params;
+    params.m_arith_mode          = AS_ARITH;
+    params.m_arith_mir_cuts      = cuts;
+    params.m_arith_cover_cuts    = cuts;
+    params.m_arith_cut_pool_size = pool_size;
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    smt::context ctx(m, params);
+    app_ref_vector xs(m);
+    for (unsigned i = 0; i < 6; ++i) {
+        std::string name = "x" + std::to_string(i);
+        xs.push_back(m.mk_const(symbol(name.c_str()), a.mk_int()));
+        ctx.assert_expr(a.mk_ge(xs.get(i), a.mk_int(0)));
+        if (i < 4)
+            ctx.assert_expr(a.mk_le(xs.get(i), a.mk_int(1)));
+    }
+    int r1[6] = {  2, -1,  23, -1,  24,  19 };
+    int r2[6] = {  9, 14,  13, 19,  17,   0 };
+    int r3[6] = { 18,  2, -10, -3, -19,  25 };
+    int r4[6] = { -2, 30,  25, 17,   3, -15 };
+    add_row(ctx, xs, r1, false, 430);
+    add_row(ctx, xs, r2, true,  120);
+    add_row(ctx, xs, r3, false, 500);
+    add_row(ctx, xs, r4, false, 97);
+    ENSURE(ctx.check() == l_false);
+    unsigned mir   = get_stat(ctx, "arith mir cuts");
+    unsigned cover = get_stat(ctx, "arith cover cuts");
+    std::cout << "cuts: " << cuts << " pool: " << pool_size << " mir: " << mir << " cover: " << cover << "\n";
+    if (cuts) {
+        ENSURE(mir > 0);
+        ENSURE(cover > 0);
+    }
+    else {
+        ENSURE(mir == 0 && cover == 0);
+    }
+}
+
+void tst_arith_cuts() {
+    tst_cuts(false, 256);
+    tst_cuts(true, 256);
+    tst_cuts(true, 0);
+}
@@ -0,0 +1,97 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    cg_table.cpp
+
+Abstract:
+
+    Tests and micro-benchmark for the congruence table of smt::context.
+
+    Terms f(a_i), g(a_i, a_i+1) and h(a_i, a_i+1, f(a_i)) are
+    internalized, and the constants a_i are merged in each round, so
+    the time is dominated by add_eq and the reinsertion of parents
+    into the congruence table.
+
+    cg_table runs small instances. The benchmark is run with
+    test-z3 cg_table_bench [n] [rounds].
+
+Author:
+
+    agent (agent@local) 2026-10-16
+
+--*/
+
+#include "ast/reg_decl_plugins.h"
+#include "smt/params/smt_params.h"
+#include "smt/smt_context.h"
+#include "util/timeit.h"
+
+static void tst_cg_table(unsigned n, unsigned rounds, bool chain, bool timed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    smt_params params;
+    smt::context ctx(m, params);
+
+    sort_ref s(m.mk_uninterpreted_sort(symbol("S")), m);
+    sort * ss[3] = { s, s, s };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 1, ss, s), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), 2, ss, s), m);
+    func_decl_ref h(m.mk_func_decl(symbol("h"), 3, ss, s), m);
+    func_decl_ref p(m.mk_func_decl(symbol("p"), 1, ss, m.mk_bool_sort()), m);
+
+    app_ref_vector as(m);
+    for (unsigned i = 0; i < n; ++i)
+        as.push_back(m.mk_fresh_const("a", s));
+    for (unsigned i = 0; i + 1 < n; ++i) {
+        app_ref fa(m.mk_app(f, as.get(i)), m);
+        app_ref ga(m.mk_app(g, as.get(i), as.get(i + 1)), m);
+        expr * args[3] = { as.get(i), as.get(i + 1), fa };
+        app_ref ha(m.mk_app(h, 3, args), m);
+        ctx.assert_expr(m.mk_app(p, ga.get()));
+        ctx.assert_expr(m.mk_app(p, ha.get()));
+    }
+
+    // chain: merge all constants, so g(a_0, a_1) = g(a_n-2, a_n-1) follows.
+    // otherwise: merge the constants with even and odd index separately,
+    // and f(a_0) = f(a_1) does not follow.
+    // The equalities are assumed through propositional proxies, so they
+    // are not simplified away and are merged by the search in each round.
+    unsigned d = chain ? 1 : 2;
+    expr_ref_vector asms(m);
+    for (unsigned i = 0; i + d < n; ++i) {
+        unsigned j = (i * 7919) % (n - d);
+        app_ref e(m.mk_fresh_const("e", m.mk_bool_sort()), m);
+        ctx.assert_expr(m.mk_eq(e, m.mk_eq(as.get(j), as.get(j + d))));
+        asms.push_back(e);
+    }
+    app_ref q(m.mk_fresh_const("q", m.mk_bool_sort()), m);
+    if (chain)
+        ctx.assert_expr(m.mk_eq(q, m.mk_eq(m.mk_app(g, as.get(0), as.get(1)), m.mk_app(g, as.get(n - 2), as.get(n - 1)))));
+    else
+        ctx.assert_expr(m.mk_eq(q, m.mk_eq(m.mk_app(f, as.get(0)), m.mk_app(f, as.get(1)))));
+    asms.push_back(m.mk_not(q));
+    lbool expected = chain ? l_false : l_true;
+
+    timeit timer(timed, chain ? "cg_table chain" : "cg_table even/odd");
+    for (unsigned r = 0; r < rounds; ++r) {
+        VERIFY(ctx.check(asms.size(), asms.c_ptr()) == expected);
+    }
+}
+
+void tst_cg_table() {
+    tst_cg_table(200, 2, true, false);
+    tst_cg_table(200, 2, false, false);
+}
+
+void tst_cg_table_bench(char ** argv, int argc, int & i) {
+    unsigned n = 20000, rounds = 20;
+    if (i + 1 < argc && atoi(argv[i + 1]) > 2) {
+        n = atoi(argv[++i]);
+        if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+            rounds = atoi(argv[++i]);
+    }
+    tst_cg_table(n, rounds, true, true);
+    tst_cg_table(n, rounds, false, true);
+}
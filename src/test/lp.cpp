@@ -30,6 +30,7 @@ Author: Lev Nachmanson
 #include "util/lp/stacked_value.h"
 #include "util/lp/stacked_unordered_set.h"
 #include "util/lp/int_set.h"
+#include "util/lp/int_solver.h"
 #include "util/stopwatch.h"
 namespace lean {
 unsigned seed = 1;
@@ -1906,6 +1907,8 @@ void setup_args_parser(argument_parser & parser) {
     parser.add_option_with_help_string("--row_inf", "forces row infeasibility search");
     parser.add_option_with_help_string("-pd", "presolve with double solver");
     parser.add_option_with_help_string("--test_int_set", "test int_set");
+    parser.add_option_with_help_string("--test_int_solver", "test int_solver");
+    parser.add_option_with_help_string("--test_double_presolve", "test the floating point presolve in the tableau mode");
     parser.add_option_with_help_string("--test_mpq", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np_plus", "test rationals using plus instead of +=");
@@ -2948,6 +2951,201 @@ void test_bound_propagation() {
     
 }
 
+void test_double_presolve_in_tableau() {
+    for (unsigned k = 0; k < 2; k++) {
+        lar_solver ls;
+        ls.settings().presolve_with_double_solver_for_lar = k == 1;
+        unsigned x = ls.add_var(0);
+        unsigned y = ls.add_var(1);
+        unsigned z = ls.add_var(2);
+        vector<std::pair<mpq, var_index>> pairs;
+        pairs.push_back(std::make_pair(mpq(1), x));
+        pairs.push_back(std::make_pair(mpq(2), y));
+        pairs.push_back(std::make_pair(mpq(-1), z));
+        unsigned t1 = ls.add_term(pairs, zero_of_type<mpq>());
+        pairs.clear();
+        pairs.push_back(std::make_pair(mpq(1), x));
+        pairs.push_back(std::make_pair(mpq(-1, 3), y));
+        unsigned t2 = ls.add_term(pairs, zero_of_type<mpq>());
+        ls.add_var_bound(t1, GE, mpq(3));
+        ls.add_var_bound(t2, GT, mpq(1, 2));
+        ls.add_var_bound(x, LE, mpq(1));
+        ls.add_var_bound(y, LE, mpq(1));
+        ls.add_var_bound(z, GE, mpq(0));
+        ENSURE(ls.find_feasible_solution() == lp_status::OPTIMAL);
+        ENSURE(ls.all_constraints_hold());
+        ls.push();
+        ls.add_var_bound(z, GE, mpq(1));
+        // x + 2y - z <= 2 < 3
+        ENSURE(ls.find_feasible_solution() == lp_status::INFEASIBLE);
+        vector<std::pair<mpq, constraint_index>> evidence;
+        ls.get_infeasibility_explanation(evidence);
+        ENSURE(evidence.size() > 0);
+        ls.pop(1);
+        ENSURE(ls.find_feasible_solution() == lp_status::OPTIMAL);
+        ENSURE(ls.all_constraints_hold());
+    }
+}
+
+// random systems where the floating point presolve has to pivot: the
+// answers have to agree with the rational only solver, also when the
+// presolve is skipped for small infeasible sets
+void test_double_presolve_random() {
+    unsigned presolves[3] = { 0, 0, 0 };
+    for (unsigned seed = 0; seed < 200; seed++) {
+        lp_status status[3];
+        for (unsigned k = 0; k < 3; k++) {
+            random_gen rand(seed);
+            lar_solver ls;
+            ls.settings().presolve_with_double_solver_for_lar = k > 0;
+            ls.settings().presolve_with_doubles_min_infeasible = k == 2 ? 3 : 0;
+            unsigned n = 3 + rand() % 6;
+            for (unsigned j = 0; j < n; j++) {
+                ls.add_var(j);
+                if (rand() % 2 == 0)
+                    ls.add_var_bound(j, LE, mpq(static_cast<int>(rand() % 21) - 10));
+                if (rand() % 2 == 0)
+                    ls.add_var_bound(j, GE, mpq(static_cast<int>(rand() % 21) - 10));
+            }
+            unsigned num_terms = 2 + rand() % 8;
+            for (unsigned i = 0; i < num_terms; i++) {
+                vector<std::pair<mpq, var_index>> pairs;
+                for (unsigned j = 0; j < n; j++) {
+                    int c = static_cast<int>(rand() % 11) - 5;
+                    if (c != 0)
+                        pairs.push_back(std::make_pair(mpq(c), j));
+                }
+                if (pairs.empty())
+                    continue;
+                unsigned t = ls.add_term(pairs, zero_of_type<mpq>());
+                lconstraint_kind kinds[] = { LE, LT, GE, GT };
+                ls.add_var_bound(t, kinds[rand() % 4], mpq(static_cast<int>(rand() % 41) - 20));
+            }
+            status[k] = ls.find_feasible_solution();
+            if (status[k] == lp_status::OPTIMAL)
+                ENSURE(ls.all_constraints_hold());
+            presolves[k] += ls.settings().st().m_double_presolves;
+        }
+        ENSURE(status[0] == status[1] && status[0] == status[2]);
+    }
+    std::cout << "presolves " << presolves[1] << ", with at least 3 infeasible " << presolves[2] << std::endl;
+    ENSURE(presolves[0] == 0);
+    ENSURE(0 < presolves[2] && presolves[2] < presolves[1]);
+}
+
+// the floating point presolve runs on a tableau that the rational solver has
+// pivoted a lot: the round-off in it must not crash the double solver
+void test_double_presolve_incremental() {
+    for (unsigned seed = 0; seed < 100; seed++) {
+        vector<lp_status> statuses[2];
+        for (unsigned k = 0; k < 2; k++) {
+            random_gen rand(seed);
+            lar_solver ls;
+            ls.settings().presolve_with_double_solver_for_lar = k == 1;
+            unsigned n = 7;
+            for (unsigned j = 0; j < n; j++)
+                ls.add_var(j);
+            lconstraint_kind kinds[] = { LE, LT, GE, GT };
+            for (unsigned i = 0; i < 9; i++) {
+                vector<std::pair<mpq, var_index>> pairs;
+                for (unsigned j = 0; j < n; j++) {
+                    int c = static_cast<int>(rand() % 11) - 5;
+                    if (c != 0)
+                        pairs.push_back(std::make_pair(mpq(c), j));
+                }
+                if (pairs.empty())
+                    continue;
+                unsigned t = ls.add_term(pairs, zero_of_type<mpq>());
+                ls.add_var_bound(t, kinds[rand() % 4], mpq(static_cast<int>(rand() % 41) - 20));
+            }
+            statuses[k].push_back(ls.find_feasible_solution());
+            for (unsigned round = 0; round < 20; round++) {
+                ls.push();
+                for (unsigned j = 0; j < n; j++)
+                    ls.add_var_bound(j, rand() % 2 == 0 ? LE : GE, mpq(static_cast<int>(rand() % 21) - 10));
+                statuses[k].push_back(ls.find_feasible_solution());
+                if (statuses[k].back() == lp_status::OPTIMAL)
+                    ENSURE(ls.all_constraints_hold());
+                ls.pop(1);
+            }
+        }
+        ENSURE(statuses[0].size() == statuses[1].size());
+        for (unsigned i = 0; i < statuses[0].size(); i++)
+            ENSURE(statuses[0][i] == statuses[1][i]);
+    }
+}
+
+void test_int_solver() {
+    // 2x - 2y = 1 has no integer solutions: the gcd test finds it
+    {
+        lar_solver ls;
+        unsigned x = ls.add_var(0, true);
+        unsigned y = ls.add_var(1, true);
+        vector<std::pair<mpq, var_index>> pairs;
+        pairs.push_back(std::make_pair(mpq(2), x));
+        pairs.push_back(std::make_pair(mpq(-2), y));
+        unsigned t = ls.add_term(pairs, zero_of_type<mpq>());
+        ls.add_var_bound(t, LE, one_of_type<mpq>());
+        ls.add_var_bound(t, GE, one_of_type<mpq>());
+        ENSURE(ls.solve() == lp_status::OPTIMAL);
+        int_solver is(ls);
+        lar_term term;
+        mpq k;
+        explanation ex;
+        ENSURE(is.check(term, k, ex) == lia_move::conflict);
+        ENSURE(ex.m_explanation.size() == 2);
+        ENSURE(ls.settings().st().m_gcd_conflicts == 1);
+        // without the gcd test the solver branches
+        ls.settings().m_int_run_gcd_test = false;
+        ls.settings().m_int_branch_cut_ratio = 0;
+        ENSURE(is.check(term, k, ex) == lia_move::branch);
+        ENSURE(term.size() == 1);
+    }
+    // 3y = x + z with 1 <= x <= 2 and z = 0 passes the gcd test, but the row bounds y
+    // by 1/3 and 2/3: the bounds tightening test finds it
+    {
+        lar_solver ls;
+        unsigned x = ls.add_var(0, true);
+        unsigned y = ls.add_var(1, true);
+        unsigned z = ls.add_var(2, true);
+        vector<std::pair<mpq, var_index>> pairs;
+        pairs.push_back(std::make_pair(mpq(3), y));
+        pairs.push_back(std::make_pair(mpq(-1), x));
+        pairs.push_back(std::make_pair(mpq(-1), z));
+        unsigned t = ls.add_term(pairs, zero_of_type<mpq>());
+        ls.add_var_bound(t, LE, zero_of_type<mpq>());
+        ls.add_var_bound(t, GE, zero_of_type<mpq>());
+        ls.add_var_bound(x, GE, mpq(1));
+        ls.add_var_bound(x, LE, mpq(2));
+        ls.add_var_bound(z, GE, zero_of_type<mpq>());
+        ls.add_var_bound(z, LE, zero_of_type<mpq>());
+        ENSURE(ls.solve() == lp_status::OPTIMAL);
+        int_solver is(ls);
+        lar_term term;
+        mpq k;
+        explanation ex;
+        ENSURE(is.check(term, k, ex) == lia_move::conflict);
+        ENSURE(ls.settings().st().m_gcd_conflicts == 0);
+        ENSURE(ls.settings().st().m_tighten_conflicts == 1);
+        // the bounds of t, x and z
+        ENSURE(ex.m_explanation.size() == 6);
+    }
+    // a non-basic integer column at a fractional bound is patched
+    {
+        lar_solver ls;
+        unsigned x = ls.add_var(0, true);
+        ls.add_var_bound(x, GE, mpq(1, 2));
+        ls.add_var_bound(x, LE, mpq(3, 2));
+        ENSURE(ls.solve() == lp_status::OPTIMAL);
+        int_solver is(ls);
+        lar_term term;
+        mpq k;
+        explanation ex;
+        ENSURE(is.check(term, k, ex) == lia_move::ok);
+        ENSURE(ls.get_value(x) == numeric_pair<mpq>(1, 0));
+    }
+}
+
 void test_int_set() {
     int_set s(4);
     s.insert(2);
@@ -3060,6 +3258,125 @@ void test_rationals() {
     std::cout << T_to_string(r) << std::endl;
 }
 
+// the largest difference between B*x and b, and between y*B and c, after solving with l
+double lu_solve_error(lu<double, double> & l, static_matrix<double, double> const & A, vector<unsigned> const & basis) {
+    unsigned m = A.row_count();
+    vector<double> x(m), y(m), b(m, 0.0), c(m, 0.0);
+    for (unsigned k = 0; k < m; k++) {
+        x[k] = static_cast<double>(my_random() % 11) - 5;
+        y[k] = static_cast<double>(my_random() % 11) - 5;
+    }
+    for (unsigned i = 0; i < m; i++)
+        for (unsigned k = 0; k < m; k++) {
+            b[i] += A.get_elem(i, basis[k]) * x[k];
+            c[k] += y[i] * A.get_elem(i, basis[k]);
+        }
+    l.solve_By(b);
+    l.solve_yB_with_error_check(c, basis);
+    double error = 0;
+    for (unsigned k = 0; k < m; k++) {
+        error = std::max(error, std::abs(b[k] - x[k]));
+        error = std::max(error, std::abs(c[k] - y[k]));
+    }
+    return error;
+}
+
+void lu_update(lu<double, double> & l, unsigned entering, unsigned leaving, vector<unsigned> & basis, vector<unsigned> & non_basic_columns, vector<int> & heading) {
+    indexed_vector<double> w(l.m_dim);
+    l.prepare_entering(entering, w);
+    l.replace_column(0, w, heading[leaving]);
+    change_basis(entering, leaving, basis, non_basic_columns, heading);
+    ENSURE(l.get_status() == LU_status::OK);
+}
+
+// the basis starts as the identity, and the entering columns are dense,
+// so every update fills in U
+void test_lu_need_to_refactor() {
+    std::cout << "test_lu_need_to_refactor" << std::endl;
+    unsigned m = 10;
+    static_matrix<double, double> A(m, 2 * m);
+    for (unsigned i = 0; i < m; i++) {
+        A.set(i, i, 1);
+        for (unsigned j = m; j < 2 * m; j++)
+            A.set(i, j, static_cast<double>(1 + my_random() % 9));
+    }
+    for (unsigned k = 0; k < 2; k++) {
+        lp_settings settings;
+        bool by_growth = k == 1;
+        settings.lu_max_updates = by_growth ? 1000 : 4;
+        settings.lu_eta_growth_factor = by_growth ? 1.0 : 1000.0;
+        vector<unsigned> basis(m), non_basic_columns;
+        for (unsigned i = 0; i < m; i++)
+            basis[i] = i;
+        vector<int> heading = allocate_basis_heading(A.column_count());
+        init_basis_heading_and_non_basic_columns_vector(basis, heading, non_basic_columns);
+        lu<double, double> l(A, basis, settings);
+        ENSURE(l.get_status() == LU_status::OK);
+        ENSURE(!l.need_to_refactor());
+        if (!by_growth) {
+            ENSURE(l.need_to_refactor_after(4) && !l.need_to_refactor_after(3));
+        }
+        unsigned updates = 0;
+        while (!l.need_to_refactor()) {
+            lu_update(l, m + updates, updates, basis, non_basic_columns, heading);
+            updates++;
+            ENSURE(updates < m);
+        }
+        std::cout << (by_growth ? "growth" : "cap") << " triggered after " << updates << " updates" << std::endl;
+        if (by_growth) {
+            ENSURE(updates < 4);
+        }
+        else {
+            ENSURE(updates == 4);
+        }
+        ENSURE(lu_solve_error(l, A, basis) < 1e-6);
+    }
+}
+
+// rows are added to a factorization that ends with a dense submatrix
+void test_lu_add_rows_with_dense_submatrix() {
+    std::cout << "test_lu_add_rows_with_dense_submatrix" << std::endl;
+    unsigned m = 8, n = 12;
+    static_matrix<double, double> A(m, n);
+    for (unsigned i = 0; i < m; i++)
+        for (unsigned j = 0; j < n; j++)
+            if (my_random() % 4 != 0 || i == j)
+                A.set(i, j, static_cast<double>(1 + my_random() % 9));
+    lp_settings settings;
+    settings.density_threshold = 0.1;
+    vector<unsigned> basis(m), non_basic_columns;
+    for (unsigned i = 0; i < m; i++)
+        basis[i] = i;
+    vector<int> heading = allocate_basis_heading(A.column_count());
+    init_basis_heading_and_non_basic_columns_vector(basis, heading, non_basic_columns);
+    lu<double, double> l(A, basis, settings);
+    ENSURE(l.get_status() == LU_status::OK);
+    bool has_dense = false;
+    for (auto t : l.m_tail)
+        has_dense |= t->is_dense();
+    ENSURE(has_dense);
+    lu_update(l, m, 2, basis, non_basic_columns, heading);
+    ENSURE(lu_solve_error(l, A, basis) < 1e-6);
+
+    for (unsigned k = 0; k < 2; k++) {
+        A.add_row();
+        A.add_column();
+    }
+    for (unsigned i = m; i < m + 2; i++) {
+        for (unsigned j = 0; j < n; j += 3)
+            A.set(i, j, static_cast<double>(1 + my_random() % 9));
+        A.set(i, n + i - m, 1);
+        basis.push_back(n + i - m);
+        heading.push_back(i);
+    }
+    auto columns_to_replace = l.get_set_of_columns_to_replace_for_add_last_rows(heading);
+    l.add_last_rows_to_B(heading, columns_to_replace);
+    ENSURE(l.get_status() == LU_status::OK);
+    ENSURE(lu_solve_error(l, A, basis) < 1e-6);
+    lu_update(l, m + 1, 5, basis, non_basic_columns, heading);
+    ENSURE(lu_solve_error(l, A, basis) < 1e-6);
+}
+
 void test_lp_local(int argn, char**argv) {
         std::cout << "resize\n";
     vector<mpq> r;
@@ -3100,6 +3417,15 @@ void test_lp_local(int argn, char**argv) {
         test_int_set();
         return finalize(0);
     }
+    if (args_parser.option_is_used("--test_int_solver")) {
+        test_int_solver();
+        return finalize(0);
+    }
+    if (args_parser.option_is_used("--test_double_presolve")) {
+        test_double_presolve_in_tableau();
+        test_double_presolve_random();
+        return finalize(0);
+    }
     if (args_parser.option_is_used("--bp")) {
         test_bound_propagation();
         return finalize(0);
@@ -3238,3 +3564,17 @@ void test_lp_local(int argn, char**argv) {
 void tst_lp(char ** argv, int argc, int& i) {
     lean::test_lp_local(argc - 2, argv + 2);
 }
+void tst_lp_double_presolve() {
+    lean::test_double_presolve_in_tableau();
+    lean::test_double_presolve_random();
+    lean::test_double_presolve_incremental();
+}
+
+void tst_lp_int_solver() {
+    lean::test_int_solver();
+}
+
+void tst_lp_lu_refactor() {
+    lean::test_lu_need_to_refactor();
+    lean::test_lu_add_rows_with_dense_submatrix();
+}
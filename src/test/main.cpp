@@ -194,8 +194,11 @@ int main(int argc, char ** argv) {
     TST(nlarith_util);
     TST(api_bug);
     TST(arith_rewriter);
+    TST(arith_cuts);
     TST(check_assumptions);
     TST(smt_context);
+    TST(cg_table);
+    TST_ARGV(cg_table_bench);
     TST(theory_dl);
     TST(model_retrieval);
     TST(model_based_opt);
@@ -240,6 +243,9 @@ int main(int argc, char ** argv) {
     TST_ARGV(ddnf);
     TST(model_evaluator);
     TST_ARGV(lp);
+    TST(lp_double_presolve);
+    TST(lp_int_solver);
+    TST(lp_lu_refactor);
     TST(get_consequences);
     TST(pb2bv);
     TST_ARGV(cnf_backbones);
@@ -9,7 +9,7 @@ bool strategy_is_undecided() const {
     return m_settings.simplex_strategy() == simplex_strategy_enum::undecided;
 }
 
-var_index add_var(unsigned ext_j) {
+var_index add_var(unsigned ext_j, bool is_int = false) {
     var_index i;
     lean_assert (ext_j < m_terms_start_index); 
 
@@ -22,6 +22,7 @@ var_index add_var(unsigned ext_j) {
     lean_assert(m_vars_to_ul_pairs.size() == A_r().column_count());
     i = A_r().column_count();
     m_vars_to_ul_pairs.push_back (ul_pair(static_cast<unsigned>(-1)));
+    m_columns_are_int.push_back(is_int);
     add_non_basic_var_to_core_fields(ext_j);
     lean_assert(sizes_are_correct());
     return i;
@@ -122,6 +123,7 @@ void add_row_for_term(const lar_term * term, unsigned term_ext_index) {
 
 void add_row_from_term_no_constraint(const lar_term * term, unsigned term_ext_index) {
     register_new_ext_var_index(term_ext_index);
+    m_columns_are_int.push_back(term_is_int(term));
     // j will be a new variable
 	unsigned j = A_r().column_count();
     ul_pair ul(j);
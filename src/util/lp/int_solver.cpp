@@ -0,0 +1,431 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#include "util/lp/int_solver.h"
+#include "util/lp/lar_solver.h"
+namespace lean {
+
+int_solver::int_solver(lar_solver & lar) :
+    m_lar_solver(lar),
+    m_branch_cut_counter(0) {}
+
+lp_settings & int_solver::settings() { return m_lar_solver.settings(); }
+
+const lar_core_solver & int_solver::core() const { return m_lar_solver.m_mpq_lar_core_solver; }
+
+const impq & int_solver::get_value(unsigned j) const { return core().m_r_x[j]; }
+
+const impq & int_solver::low_bound(unsigned j) const { return core().m_r_low_bounds()[j]; }
+
+const impq & int_solver::upper_bound(unsigned j) const { return core().m_r_upper_bounds()[j]; }
+
+column_type int_solver::get_column_type(unsigned j) const { return core().m_column_types()[j]; }
+
+bool int_solver::is_int(unsigned j) const { return m_lar_solver.column_is_int(j); }
+
+bool int_solver::value_is_int(unsigned j) const { return m_lar_solver.column_value_is_int(j); }
+
+bool int_solver::is_base(unsigned j) const { return core().m_r_heading[j] >= 0; }
+
+bool int_solver::is_fixed(unsigned j) const { return get_column_type(j) == column_type::fixed; }
+
+bool int_solver::is_free(unsigned j) const { return get_column_type(j) == column_type::free_column; }
+
+bool int_solver::has_low(unsigned j) const {
+    switch (get_column_type(j)) {
+    case column_type::fixed:
+    case column_type::boxed:
+    case column_type::low_bound:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool int_solver::has_upper(unsigned j) const {
+    switch (get_column_type(j)) {
+    case column_type::fixed:
+    case column_type::boxed:
+    case column_type::upper_bound:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool int_solver::at_low(unsigned j) const { return has_low(j) && get_value(j) == low_bound(j); }
+
+bool int_solver::at_upper(unsigned j) const { return has_upper(j) && get_value(j) == upper_bound(j); }
+
+// the largest integer k such that k <= v, where v may contain an infinitesimal
+mpq int_solver::floor_of(const impq & v) {
+    mpq r = floor(v.x);
+    if (v.x.is_int() && v.y.is_neg())
+        r -= one_of_type<mpq>();
+    return r;
+}
+
+mpq int_solver::fractional_part(const mpq & v) { return v - floor(v); }
+
+bool int_solver::has_inf_int() const {
+    unsigned n = m_lar_solver.A_r().column_count();
+    for (unsigned j = 0; j < n; j++)
+        if (is_int(j) && !value_is_int(j))
+            return true;
+    return false;
+}
+
+lia_move int_solver::check(lar_term & t, mpq & k, explanation & ex) {
+    t.m_coeffs.clear();
+    t.m_v = zero_of_type<mpq>();
+    ex.clear();
+    if (!has_inf_int())
+        return lia_move::ok;
+
+    if (settings().m_int_run_gcd_test && !gcd_test(ex))
+        return lia_move::conflict;
+
+    patch_int_infeasible_non_basic_columns();
+    if (!has_inf_int())
+        return lia_move::ok;
+
+    unsigned ratio = settings().m_int_branch_cut_ratio;
+    if (m_lar_solver.use_tableau() && ratio > 0 && (++m_branch_cut_counter) % ratio == 0) {
+        int j = find_inf_int_base_column();
+        if (j != -1) {
+            lia_move r = mk_gomory_cut(j, t, k, ex);
+            if (r == lia_move::cut) {
+                settings().st().m_gomory_cuts++;
+                columns_to_external(t, k);
+                return r;
+            }
+            if (r == lia_move::conflict)
+                return r;
+            t.m_coeffs.clear();
+            ex.clear();
+        }
+    }
+
+    int j = find_inf_int_column();
+    if (j == -1)
+        return lia_move::give_up;
+    settings().st().m_int_branches++;
+    return create_branch_on_column(j, t, k);
+}
+
+/**
+   \brief A row of A_r is the equation sum a_j * x_j = 0. When all its columns are integral
+   the gcd of the coefficients of the non-fixed columns has to divide the sum contributed
+   by the fixed columns. Rows that pass are checked by the bounds tightening test.
+   Returns false and fills ex when one of the tests fails for some row.
+*/
+bool int_solver::gcd_test(explanation & ex) {
+    for (unsigned i = 0; i < m_lar_solver.A_r().row_count(); i++) {
+        if (!gcd_test_for_row(i, ex)) {
+            settings().st().m_gcd_conflicts++;
+            return false;
+        }
+        if (!tighten_bounds_test_for_row(i, ex)) {
+            settings().st().m_tighten_conflicts++;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool int_solver::gcd_test_for_row(unsigned i, explanation & ex) {
+    auto const & row = m_lar_solver.A_r().m_rows[i];
+    mpq lcm_den = one_of_type<mpq>();
+    for (auto const & c : row) {
+        if (!is_int(c.m_j))
+            return true;
+        if (is_fixed(c.m_j) && !low_bound(c.m_j).x.is_int())
+            return true;
+        lcm_den = lcm(lcm_den, denominator(c.get_val()));
+    }
+    mpq consts = zero_of_type<mpq>();
+    mpq gcds = zero_of_type<mpq>();
+    for (auto const & c : row) {
+        mpq a = lcm_den * c.get_val();
+        lean_assert(a.is_int());
+        if (is_fixed(c.m_j))
+            consts += a * low_bound(c.m_j).x;
+        else if (gcds.is_zero())
+            gcds = abs(a);
+        else
+            gcds = gcd(gcds, a);
+    }
+    if (gcds.is_zero() ? consts.is_zero() : (consts / gcds).is_int())
+        return true;
+    for (auto const & c : row)
+        if (is_fixed(c.m_j))
+            add_to_explanation_from_fixed_or_boxed_column(c.m_j, ex);
+    return false;
+}
+
+/**
+   \brief Bounds tightening test. When all columns of a row are integral and all of them but
+   x_j have a lower and an upper bound, the row implies the bounds l <= x_j <= u. Returns false
+   and fills ex when no integer lies in [l, u], that is, when the bounds of x_j rounded to
+   integers cross, although the rational bounds may not.
+*/
+bool int_solver::tighten_bounds_test_for_row(unsigned i, explanation & ex) {
+    auto const & row = m_lar_solver.A_r().m_rows[i];
+    // the sums of the smallest and the largest values of a_k * x_k over the bounded columns.
+    mpq min_sum = zero_of_type<mpq>();
+    mpq max_sum = zero_of_type<mpq>();
+    int unbounded = -1;
+    for (auto const & c : row) {
+        unsigned j = c.m_j;
+        if (!is_int(j))
+            return true;
+        if (!has_low(j) || !has_upper(j)) {
+            if (unbounded != -1)
+                return true;
+            unbounded = j;
+            continue;
+        }
+        if (!low_bound(j).y.is_zero() || !upper_bound(j).y.is_zero())
+            return true;
+        mpq const & a = c.get_val();
+        if (a.is_pos()) {
+            min_sum += a * low_bound(j).x;
+            max_sum += a * upper_bound(j).x;
+        }
+        else {
+            min_sum += a * upper_bound(j).x;
+            max_sum += a * low_bound(j).x;
+        }
+    }
+    for (auto const & c : row) {
+        unsigned j = c.m_j;
+        if (unbounded != -1 && static_cast<unsigned>(unbounded) != j)
+            continue;
+        // a_j * x_j = - sum_{k != j} a_k * x_k
+        mpq const & a = c.get_val();
+        mpq lo = -max_sum, hi = -min_sum;
+        if (unbounded == -1) {
+            if (a.is_pos()) {
+                lo += a * upper_bound(j).x;
+                hi += a * low_bound(j).x;
+            }
+            else {
+                lo += a * low_bound(j).x;
+                hi += a * upper_bound(j).x;
+            }
+        }
+        lo /= a;
+        hi /= a;
+        if (a.is_neg())
+            std::swap(lo, hi);
+        if (ceil(lo) <= floor(hi))
+            continue;
+        for (auto const & c2 : row)
+            if (c2.m_j != j)
+                add_to_explanation_from_fixed_or_boxed_column(c2.m_j, ex);
+        return false;
+    }
+    return true;
+}
+
+void int_solver::add_to_explanation_from_fixed_or_boxed_column(unsigned j, explanation & ex) {
+    ex.push_justification(m_lar_solver.get_column_low_bound_witness(j), one_of_type<mpq>());
+    ex.push_justification(m_lar_solver.get_column_upper_bound_witness(j), one_of_type<mpq>());
+}
+
+/**
+   \brief Move non-basic integer columns with non-integral values to an integer
+   that keeps all bounds satisfied. This only changes the current solution.
+*/
+void int_solver::patch_int_infeasible_non_basic_columns() {
+    if (!m_lar_solver.use_tableau())
+        return;
+    for (unsigned j : core().m_r_nbasis) {
+        if (is_int(j) && !value_is_int(j) && patch_non_basic_column(j))
+            settings().st().m_int_patches++;
+    }
+}
+
+bool int_solver::patch_non_basic_column(unsigned j) {
+    lean_assert(!is_base(j));
+    const impq & x = get_value(j);
+    mpq fl = floor_of(x);
+    impq candidates[2] = { impq(fl), impq(fl + one_of_type<mpq>()) };
+    for (impq const & v : candidates) {
+        if (has_low(j) && v < low_bound(j))
+            continue;
+        if (has_upper(j) && v > upper_bound(j))
+            continue;
+        impq delta = v - x;
+        if (!shift_keeps_rows_feasible(j, delta))
+            continue;
+        m_lar_solver.change_basic_x_by_delta_on_column(j, delta);
+        m_lar_solver.m_mpq_lar_core_solver.m_r_x[j] = v;
+        lean_assert(m_lar_solver.m_mpq_lar_core_solver.m_r_solver.current_x_is_feasible());
+        return true;
+    }
+    return false;
+}
+
+// Changing x_j by delta changes the basic column of row i by -a_ij * delta.
+bool int_solver::shift_keeps_rows_feasible(unsigned j, const impq & delta) {
+    auto const & A = m_lar_solver.A_r();
+    for (auto const & c : A.m_columns[j]) {
+        unsigned bj = core().m_r_basis[c.m_i];
+        impq v = get_value(bj) - A.get_val(c) * delta;
+        if (has_low(bj) && v < low_bound(bj))
+            return false;
+        if (has_upper(bj) && v > upper_bound(bj))
+            return false;
+        // do not break the integrality of a basic column that is already integral
+        if (is_int(bj) && value_is_int(bj) && !(v.x.is_int() && v.y.is_zero()))
+            return false;
+    }
+    return true;
+}
+
+int int_solver::find_inf_int_base_column() {
+    unsigned n = core().m_r_basis.size();
+    if (n == 0)
+        return -1;
+    unsigned start = m_branch_cut_counter % n;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned i = (start + k) % n;
+        unsigned j = core().m_r_basis[i];
+        if (is_int(j) && !value_is_int(j) && is_gomory_cut_target(i, j))
+            return j;
+    }
+    return -1;
+}
+
+// Prefer a boxed column with the smallest range, then any other column.
+int int_solver::find_inf_int_column() {
+    int result = -1;
+    mpq range;
+    unsigned n = m_lar_solver.A_r().column_count();
+    for (unsigned j = 0; j < n; j++) {
+        if (!is_int(j) || value_is_int(j))
+            continue;
+        if (get_column_type(j) == column_type::boxed) {
+            mpq r = upper_bound(j).x - low_bound(j).x;
+            if (result == -1 || get_column_type(result) != column_type::boxed || r < range) {
+                result = j;
+                range = r;
+            }
+        }
+        else if (result == -1) {
+            result = j;
+        }
+    }
+    return result;
+}
+
+// All non-basic columns of the row are at their bounds and have no infinitesimals.
+bool int_solver::is_gomory_cut_target(unsigned i, unsigned basic_j) {
+    if (!get_value(basic_j).y.is_zero())
+        return false;
+    for (auto const & c : m_lar_solver.A_r().m_rows[i]) {
+        unsigned j = c.m_j;
+        if (j == basic_j)
+            continue;
+        if (!get_value(j).y.is_zero() || !(at_low(j) || at_upper(j)))
+            return false;
+    }
+    return true;
+}
+
+/**
+   \brief Create the Gomory cut t >= k from the row of the basic column basic_j.
+   The row is basic_j + sum a_j * x_j = 0 and the coefficients of the cut are derived as in
+   "Integrating Simplex with DPLL(T)". An empty t means that the bounds of the row are
+   inconsistent over the integers.
+*/
+lia_move int_solver::mk_gomory_cut(unsigned basic_j, lar_term & t, mpq & k, explanation & ex) {
+    lean_assert(is_int(basic_j) && !value_is_int(basic_j));
+    unsigned i = core().m_r_heading[basic_j];
+    k = one_of_type<mpq>();
+    mpq f_0 = fractional_part(get_value(basic_j).x);
+    mpq one_minus_f_0 = one_of_type<mpq>() - f_0;
+    lean_assert(!f_0.is_zero() && !one_minus_f_0.is_zero());
+    mpq lcm_den = one_of_type<mpq>();
+    unsigned num_ints = 0;
+    for (auto const & c : m_lar_solver.A_r().m_rows[i]) {
+        unsigned j = c.m_j;
+        if (j == basic_j)
+            continue;
+        mpq a = -c.get_val();
+        mpq new_a;
+        if (!is_int(j)) {
+            if (at_low(j)) {
+                new_a = a.is_pos() ? a / one_minus_f_0 : -(a / f_0);
+                k += new_a * low_bound(j).x;
+                ex.push_justification(m_lar_solver.get_column_low_bound_witness(j), new_a);
+            }
+            else {
+                lean_assert(at_upper(j));
+                new_a = a.is_pos() ? -(a / f_0) : a / one_minus_f_0;
+                k += new_a * upper_bound(j).x;
+                ex.push_justification(m_lar_solver.get_column_upper_bound_witness(j), new_a);
+            }
+        }
+        else {
+            ++num_ints;
+            mpq f_j = fractional_part(a);
+            if (f_j.is_zero())
+                continue;
+            if (at_low(j)) {
+                new_a = f_j <= one_minus_f_0 ? f_j / one_minus_f_0 : (one_of_type<mpq>() - f_j) / f_0;
+                k += new_a * low_bound(j).x;
+                ex.push_justification(m_lar_solver.get_column_low_bound_witness(j), new_a);
+            }
+            else {
+                lean_assert(at_upper(j));
+                new_a = f_j <= f_0 ? f_j / f_0 : (one_of_type<mpq>() - f_j) / one_minus_f_0;
+                new_a = -new_a;
+                k += new_a * upper_bound(j).x;
+                ex.push_justification(m_lar_solver.get_column_upper_bound_witness(j), new_a);
+            }
+            lcm_den = lcm(lcm_den, denominator(new_a));
+        }
+        t.add_to_map(j, new_a);
+    }
+    if (t.m_coeffs.empty()) {
+        lean_assert(k.is_pos());
+        return lia_move::conflict;
+    }
+    if (num_ints > 0) {
+        lcm_den = lcm(lcm_den, denominator(k));
+        if (!lcm_den.is_one()) {
+            for (auto & p : t.m_coeffs)
+                p.second *= lcm_den;
+            k *= lcm_den;
+        }
+    }
+    return lia_move::cut;
+}
+
+// The branch is t <= k, where t is the column j, and its complement t >= k + 1.
+lia_move int_solver::create_branch_on_column(unsigned j, lar_term & t, mpq & k) {
+    lean_assert(is_int(j) && !value_is_int(j));
+    t.add_to_map(j, one_of_type<mpq>());
+    k = floor_of(get_value(j));
+    columns_to_external(t, k);
+    return lia_move::branch;
+}
+
+/**
+   \brief Replace the columns of t by the variables and terms of lar_solver.
+   A column of a term misses the constant of the term, so k absorbs it.
+*/
+void int_solver::columns_to_external(lar_term & t, mpq & k) const {
+    lar_term r;
+    for (auto const & p : t.m_coeffs) {
+        unsigned ext = m_lar_solver.column_to_var_or_term_index(p.first);
+        if (ext != p.first)
+            k += p.second * m_lar_solver.get_term(ext).m_v;
+        r.add_to_map(ext, p.second);
+    }
+    t.m_coeffs.swap(r.m_coeffs);
+}
+}
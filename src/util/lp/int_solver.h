@@ -0,0 +1,76 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#pragma once
+#include "util/lp/lp_settings.h"
+#include "util/lp/lar_term.h"
+#include "util/lp/numeric_pair.h"
+#include "util/lp/lar_core_solver.h"
+namespace lean {
+class lar_solver;
+
+enum class lia_move {
+    ok,        // all integer columns have integral values
+    branch,    // split on t <= k or t >= k + 1
+    cut,       // the cut t >= k is implied by the explanation
+    conflict,  // the explanation is infeasible over the integers
+    give_up
+};
+
+struct explanation {
+    vector<std::pair<mpq, constraint_index>> m_explanation;
+    void clear() { m_explanation.clear(); }
+    void push_justification(constraint_index ci, const mpq & v) {
+        if (ci != static_cast<constraint_index>(-1))
+            m_explanation.push_back(std::make_pair(v, ci));
+    }
+};
+
+// The integer layer of lar_solver: patching, GCD and bounds tightening tests, Gomory cuts and branching.
+// It keeps no state that depends on the bounds, so it works under push/pop of lar_solver.
+class int_solver {
+    lar_solver & m_lar_solver;
+    unsigned     m_branch_cut_counter;
+public:
+    int_solver(lar_solver & lar);
+    // Called when lar_solver has a feasible solution.
+    // The lar_term t is expressed in the external variable and term indices of lar_solver.
+    lia_move check(lar_term & t, mpq & k, explanation & ex);
+    bool has_inf_int() const;
+private:
+    lp_settings & settings();
+    const lar_core_solver & core() const;
+    const impq & get_value(unsigned j) const;
+    const impq & low_bound(unsigned j) const;
+    const impq & upper_bound(unsigned j) const;
+    column_type get_column_type(unsigned j) const;
+    bool is_int(unsigned j) const;
+    bool value_is_int(unsigned j) const;
+    bool is_base(unsigned j) const;
+    bool is_fixed(unsigned j) const;
+    bool is_free(unsigned j) const;
+    bool has_low(unsigned j) const;
+    bool has_upper(unsigned j) const;
+    bool at_low(unsigned j) const;
+    bool at_upper(unsigned j) const;
+    static mpq floor_of(const impq & v);
+    static mpq fractional_part(const mpq & v);
+
+    bool gcd_test(explanation & ex);
+    bool gcd_test_for_row(unsigned i, explanation & ex);
+    bool tighten_bounds_test_for_row(unsigned i, explanation & ex);
+    void add_to_explanation_from_fixed_or_boxed_column(unsigned j, explanation & ex);
+
+    void patch_int_infeasible_non_basic_columns();
+    bool patch_non_basic_column(unsigned j);
+    bool shift_keeps_rows_feasible(unsigned j, const impq & delta);
+
+    int find_inf_int_base_column();
+    int find_inf_int_column();
+    bool is_gomory_cut_target(unsigned i, unsigned basic_j);
+    lia_move mk_gomory_cut(unsigned basic_j, lar_term & t, mpq & k, explanation & ex);
+    lia_move create_branch_on_column(unsigned j, lar_term & t, mpq & k);
+    void columns_to_external(lar_term & t, mpq & k) const;
+};
+}
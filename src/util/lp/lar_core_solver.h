@@ -250,6 +250,14 @@ public:
         return settings().simplex_strategy() == simplex_strategy_enum::lu;
     }
 
+    // In the tableau mode the double solver runs on a copy of the current tableau,
+    // so it does not need to be kept in sync by push() and pop().
+    bool need_to_presolve_with_doubles_in_tableau() const {
+        return settings().use_tableau_rows() && settings().presolve_with_double_solver_for_lar;
+    }
+
+    void solve_with_double_tableau();
+
     template <typename L>
     bool is_zero_vector(const vector<L> & b) {
         for (const L & m: b)
@@ -404,7 +412,7 @@ public:
     // here we compact the trace as we go to avoid unnecessary column changes
     template <typename L, typename K> 
     void catch_up_in_lu(const vector<unsigned> & trace_of_basis_change, const vector<int> & basis_heading, lp_primal_core_solver<L,K> & cs) {
-        if (cs.m_factorization == nullptr || cs.m_factorization->m_refactor_counter + trace_of_basis_change.size()/2 >= 200) {
+        if (cs.m_factorization == nullptr || cs.m_factorization->need_to_refactor_after(trace_of_basis_change.size()/2)) {
             for (unsigned i = 0; i < trace_of_basis_change.size(); i+= 2) {
                 unsigned entering = trace_of_basis_change[i];
                 unsigned leaving = trace_of_basis_change[i+1];
@@ -649,7 +657,8 @@ public:
         }
     }
 
-    void get_bounds_for_double_solver() {
+    // returns the value used for the infinitesimal of the strict bounds
+    double get_bounds_for_double_solver() {
         unsigned n = m_n();
         m_d_low_bounds.resize(n);
         m_d_upper_bounds.resize(n);
@@ -667,6 +676,7 @@ public:
                 lean_assert(!low_bound_is_set(j) || (m_d_upper_bounds[j] >= m_d_low_bounds[j]));
             }
         }
+        return delta;
     }
 
     void scale_problem_for_doubles(
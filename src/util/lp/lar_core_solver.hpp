@@ -242,6 +242,62 @@ void lar_core_solver::fill_not_improvable_zero_sum() {
 }
 
 
+// Runs the feasibility search in doubles on a copy of the tableau, then moves the
+// rational tableau to the basis found and lets the rational solver finish from there.
+// The rational solver repairs the solution when the double basis is not feasible
+// or singular in exact arithmetic, so the status and the explanation of an
+// infeasibility come from the rational tableau only.
+void lar_core_solver::solve_with_double_tableau() {
+    lean_assert(settings().use_tableau_rows());
+    lean_assert(r_basis_is_OK());
+    unsigned m = m_r_A.row_count();
+    unsigned n = m_r_A.column_count();
+    static_matrix<double, double> A(m, n);
+    for (unsigned i = 0; i < m; i++) {
+        for (auto & c : m_r_A.m_rows[i]) {
+            double v = c.get_val().get_double();
+            if (v != 0)
+                A.set(i, c.m_j, v);
+        }
+    }
+    double delta = get_bounds_for_double_solver();
+    m_d_x.resize(n);
+    for (unsigned j = 0; j < n; j++)
+        m_d_x[j] = m_r_x[j].x.get_double() + delta * m_r_x[j].y.get_double();
+    vector<unsigned> basis(m_r_basis);
+    vector<unsigned> nbasis;
+    vector<int> heading;
+    // the rows of the tableau are homogeneous and the costs are only used for
+    // infeasibility, but the solver indexes both of them
+    vector<double> right_sides(m, 0.0);
+    vector<double> costs(n, 0.0);
+    lp_primal_core_solver<double, double> d_solver(A, right_sides, m_d_x, basis, nbasis, heading,
+                                                   costs, m_column_types(), m_d_low_bounds, m_d_upper_bounds,
+                                                   settings(), m_r_solver.m_column_names);
+    for (unsigned j : basis)
+        d_solver.update_column_in_inf_set(j);
+    d_solver.start_tracing_basis_changes();
+    // find_feasible_solution() would run the lu based iterations for doubles,
+    // but A is already a tableau and there is no factorization
+    d_solver.m_look_for_feasible_solution_only = true;
+    d_solver.set_status(UNKNOWN);
+    d_solver.solve_with_tableau();
+    if (settings().get_cancel_flag()) {
+        m_r_solver.set_status(TIME_EXHAUSTED);
+        return;
+    }
+    d_solver.stop_tracing_basis_changes();
+    settings().st().m_double_presolves++;
+    if (d_solver.get_status() != FLOATING_POINT_ERROR) {
+        lar_solution_signature signature;
+        extract_signature_from_lp_core_solver(d_solver, signature);
+        if (!catch_up_in_lu_tableau(d_solver.m_trace_of_basis_change_vector, d_solver.m_basis_heading))
+            settings().st().m_double_presolve_repairs++;
+        prepare_solver_x_with_signature_tableau(signature);
+    }
+    m_r_solver.find_feasible_solution();
+}
+
 void lar_core_solver::solve() {
     lean_assert(m_r_solver.non_basic_columns_are_set_correctly());
     lean_assert(m_r_solver.inf_set_is_correct());
@@ -265,6 +321,12 @@ void lar_core_solver::solve() {
         else 
             solve_on_signature(solution_signature, changes_of_basis);
         lean_assert(!settings().use_tableau() || r_basis_is_OK());
+    } else if (need_to_presolve_with_doubles_in_tableau() && m_r_solver.m_look_for_feasible_solution_only &&
+               m_r_solver.m_inf_set.size() >= settings().presolve_with_doubles_min_infeasible) {
+        solve_with_double_tableau();
+        if (m_r_solver.get_status() == TIME_EXHAUSTED)
+            return;
+        lean_assert(r_basis_is_OK());
     } else {
         if (!settings().use_tableau()) {
             bool snapped = m_r_solver.snap_non_basic_x_to_bound();   
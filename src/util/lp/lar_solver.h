@@ -39,6 +39,7 @@ class lar_solver : public column_namer {
     stacked_value<simplex_strategy_enum>    m_simplex_strategy;
     std::unordered_map<unsigned, var_index> m_ext_vars_to_columns;
     vector<unsigned>                        m_columns_to_ext_vars_or_term_indices;
+    vector<bool>                            m_columns_are_int; // the values of these columns must be integral
     stacked_vector<ul_pair>                 m_vars_to_ul_pairs;
     vector<lar_base_constraint*>            m_constraints;
     stacked_value<unsigned>                 m_constraint_count;
@@ -102,6 +103,39 @@ public:
 
     numeric_pair<mpq> const& get_value(var_index vi) const { return m_mpq_lar_core_solver.m_r_x[vi]; }
 
+    bool column_is_int(unsigned j) const { return m_columns_are_int[j]; }
+
+    bool column_value_is_int(unsigned j) const {
+        numeric_pair<mpq> const & x = m_mpq_lar_core_solver.m_r_x[j];
+        return x.x.is_int() && x.y.is_zero();
+    }
+
+    bool has_int_var() const {
+        for (bool b : m_columns_are_int)
+            if (b) return true;
+        return false;
+    }
+
+    // a term is integral if its coefficients and its constant are integers and it only uses integral columns and terms
+    bool term_is_int(const lar_term * t) const {
+        if (!t->m_v.is_int())
+            return false;
+        for (auto const & p : t->m_coeffs) {
+            if (!p.second.is_int())
+                return false;
+            if (is_term(p.first)) {
+                if (!term_is_int(m_terms[adjust_term_index(p.first)]))
+                    return false;
+            }
+            else if (!column_is_int(p.first)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned column_to_var_or_term_index(unsigned j) const { return adjust_column_index_to_term_index(j); }
+
     bool is_term(var_index j) const {
         return j >= m_terms_start_index && j - m_terms_start_index < m_terms.size();
     }
@@ -490,6 +524,7 @@ public:
 		for (unsigned j = n_was; j-- > n;)
 			m_ext_vars_to_columns.erase(m_columns_to_ext_vars_or_term_indices[j]);
 		m_columns_to_ext_vars_or_term_indices.resize(n);
+        m_columns_are_int.resize(n);
 		if (m_settings.use_tableau()) {
             pop_tableau();
         }
@@ -886,7 +921,7 @@ public:
         auto & f = s.m_factorization;
         if (f != nullptr) {
             auto columns_to_replace = f->get_set_of_columns_to_replace_for_add_last_rows(s.m_basis_heading);
-            if (f->m_refactor_counter + columns_to_replace.size() >= 200 || f->has_dense_submatrix()) {
+            if (f->need_to_refactor_after(columns_to_replace.size())) {
                 delete f;
                 f = nullptr;
             } else {
@@ -1183,6 +1218,14 @@ public:
         return ret;
     }
 
+    constraint_index get_column_low_bound_witness(unsigned j) const {
+        return m_vars_to_ul_pairs()[j].low_bound_witness();
+    }
+
+    constraint_index get_column_upper_bound_witness(unsigned j) const {
+        return m_vars_to_ul_pairs()[j].upper_bound_witness();
+    }
+
     bool has_lower_bound(var_index var, constraint_index& ci, mpq& value, bool& is_strict) {
 
         if (var >= m_vars_to_ul_pairs.size()) {
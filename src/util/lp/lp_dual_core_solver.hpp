@@ -32,7 +32,7 @@ template <typename T, typename X> void lp_dual_core_solver<T, X>::restore_non_ba
 
 template <typename T, typename X> bool lp_dual_core_solver<T, X>::update_basis(int entering, int leaving) {
     // the second argument is the element of the entering column from the pivot row - its value should be equal to the low diagonal element of the bump after all pivoting is done
-    if (this->m_refactor_counter++ < 200) {
+    if (this->m_refactor_counter++ < this->m_settings.lu_max_updates && !this->m_factorization->need_to_refactor()) {
         this->m_factorization->replace_column(this->m_ed[this->m_factorization->basis_heading(leaving)], this->m_w);
         if (this->m_factorization->get_status() == LU_status::OK) {
             this->m_factorization->change_basis(entering, leaving);
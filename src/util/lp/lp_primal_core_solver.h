@@ -234,12 +234,17 @@ public:
     }
 
     
+    // in doubles a pivot on a numerical zero blows up the tableau
+    bool pivot_is_too_small(const T & a) const {
+        return lp_settings::is_eps_small_general<T>(a, this->m_settings.pivot_epsilon);
+    }
+
     int find_beneficial_column_in_row_tableau_rows_bland_mode(int i, T & a_ent) {
         int j = -1;
         unsigned bj = this->m_basis[i];
         bool bj_needs_to_grow = needs_to_grow(bj);
         for (const row_cell<T>& rc : this->m_A.m_rows[i]) {
-            if (rc.m_j == bj)
+            if (rc.m_j == bj || pivot_is_too_small(rc.get_val()))
                 continue;
             if (bj_needs_to_grow) {
                 if (!monoid_can_decrease(rc))
@@ -271,7 +276,7 @@ public:
         bool bj_needs_to_grow = needs_to_grow(bj);
         for (const row_cell<T>& rc : this->m_A.m_rows[i]) {
             unsigned j = rc.m_j;
-            if (j == bj)
+            if (j == bj || pivot_is_too_small(rc.get_val()))
                 continue;
             if (bj_needs_to_grow) {
                 if (!monoid_can_decrease(rc))
@@ -490,6 +495,11 @@ public:
         }
         X theta = (this->m_x[leaving] - new_val_for_leaving) / a_ent;
         advance_on_entering_and_leaving_tableau_rows(entering, leaving, theta );
+        if (!numeric_traits<T>::precise()) {
+            // the round-off must not keep the leaving column, now non-basic, in m_inf_set
+            this->m_x[leaving] = new_val_for_leaving;
+            this->update_column_in_inf_set(leaving);
+        }
         lean_assert(this->m_x[leaving] == new_val_for_leaving);
         if (this->current_x_is_feasible())
             this->set_status(OPTIMAL);
@@ -80,6 +80,13 @@ struct stats {
     unsigned m_num_factorizations;
     unsigned m_num_of_implied_bounds;
     unsigned m_need_to_solve_inf;
+    unsigned m_int_patches;
+    unsigned m_gcd_conflicts;
+    unsigned m_tighten_conflicts;
+    unsigned m_gomory_cuts;
+    unsigned m_int_branches;
+    unsigned m_double_presolves;
+    unsigned m_double_presolve_repairs;
     stats() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
 };
@@ -145,7 +152,10 @@ public:
     double relative_primal_feasibility_tolerance; // page 71 of the PhD thesis of Achim Koberstein
 
     bool m_bound_propagation;
-    
+    // integer section
+    unsigned m_int_branch_cut_ratio; // every m_int_branch_cut_ratio-th branch is replaced by a Gomory cut
+    bool m_int_run_gcd_test; // the gcd test is followed by the bounds tightening test
+
     bool bound_progation() const {
         return m_bound_propagation;
     }
@@ -188,13 +198,18 @@ public:
                     primal_feasibility_tolerance ( 1e-7), // page 71 of the PhD thesis of Achim Koberstein
                     relative_primal_feasibility_tolerance ( 1e-9), // page 71 of the PhD thesis of Achim Koberstein
                     m_bound_propagation ( true),
-                    presolve_with_double_solver_for_lar(true),
+                    m_int_branch_cut_ratio(2),
+                    m_int_run_gcd_test(true),
+                    presolve_with_double_solver_for_lar(false),
+                    presolve_with_doubles_min_infeasible(0),
                     m_simplex_strategy(simplex_strategy_enum::tableau_rows),
                     report_frequency(1000),
                     print_statistics(false),
                     column_norms_update_frequency(12000),
                     scale_with_ratio(true),
                     density_threshold(0.7),
+                    lu_max_updates(1000),
+                    lu_eta_growth_factor(2.0),
                     use_breakpoints_in_feasibility_search(false),
                     max_row_length_for_bound_propagation(300),
                     backup_costs(true),
@@ -269,6 +284,7 @@ public:
     }
     // the method of lar solver to use
     bool presolve_with_double_solver_for_lar;
+    unsigned presolve_with_doubles_min_infeasible; // the tableau presolve runs only when this many basic columns are infeasible
     simplex_strategy_enum m_simplex_strategy;
     simplex_strategy_enum simplex_strategy() const {
         return m_simplex_strategy;
@@ -296,6 +312,8 @@ public:
     unsigned column_norms_update_frequency;
     bool scale_with_ratio;
     double density_threshold; // need to tune it up, todo
+    unsigned lu_max_updates; // the maximal number of basis updates of lu before refactoring
+    double lu_eta_growth_factor; // refactor when the updates added more than this times the nonzeroes of U
 #ifdef LEAN_DEBUG
     static unsigned ddd; // used for debugging    
 #endif
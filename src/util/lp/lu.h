@@ -129,6 +129,8 @@ public:
     indexed_vector<T>           m_y_copy;
     indexed_vector<unsigned>    m_ii; //to optimize the work with the m_index fields
     unsigned                    m_refactor_counter;
+    unsigned                    m_nnz_at_factorization; // the number of nonzeroes of U right after the factorization
+    unsigned                    m_nnz_in_updates; // the nonzeroes that replace_column added to the row eta matrices and to U
     // constructor
     // if A is an m by n matrix then basis has length m and values in [0,n); the values are all different
     // they represent the set of m columns
@@ -288,7 +290,15 @@ public:
     void prepare_entering(unsigned entering, indexed_vector<T> & w) {
         init_vector_w(entering, w);
     }
-    bool need_to_refactor() { return m_refactor_counter >= 200; }
+    // The updates are cheap while the eta file and the fill-in of U stay small, so we refactor
+    // when they outgrow the factorization itself; lu_max_updates only bounds the error accumulated
+    // by a long sequence of sparse updates.
+    bool need_to_refactor() const { return need_to_refactor_after(0); }
+
+    bool need_to_refactor_after(unsigned number_of_updates) const {
+        return m_nnz_in_updates > m_settings.lu_eta_growth_factor * (m_nnz_at_factorization + m_dim) ||
+            m_refactor_counter + number_of_updates >= m_settings.lu_max_updates;
+    }
     
     void adjust_dimension_with_matrix_A() {
         lean_assert(m_A.row_count() >= m_dim);
@@ -339,13 +349,6 @@ public:
         init_vector_w(j, m_w_for_extension);
         replace_column(zero_of_type<T>(), m_w_for_extension, column_to_change_in_U);
     }
-
-    bool has_dense_submatrix() const {
-        for (auto m : m_tail)
-            if (m->is_dense())
-                return true;
-        return false;
-    }
     
 }; // end of lu
 
@@ -121,13 +121,16 @@ lu<T, X>::lu(static_matrix<T, X> const & A,
     m_settings(settings),
     m_failure(false),
     m_row_eta_work_vector(A.row_count()),
-    m_refactor_counter(0) {
+    m_refactor_counter(0),
+    m_nnz_at_factorization(0),
+    m_nnz_in_updates(0) {
     lean_assert(!(numeric_traits<T>::precise() && settings.use_tableau()));
 #ifdef LEAN_DEBUG
     debug_test_of_basis(A, basis);
 #endif
     ++m_settings.st().m_num_factorizations;
     create_initial_factorization();
+    m_nnz_at_factorization = m_U.get_number_of_nonzeroes();
 #ifdef LEAN_DEBUG
     // lean_assert(check_correctness());
 #endif
@@ -566,7 +569,11 @@ template <typename T, typename X>
 unsigned lu<T, X>::transform_U_to_V_by_replacing_column(indexed_vector<T> & w,
                                                         unsigned leaving_column) {
     unsigned column_to_replace = m_R.apply_reverse(leaving_column);
+    unsigned nnz_before = m_U.number_of_non_zeroes_in_column(m_U.adjust_column(column_to_replace));
     m_U.replace_column(column_to_replace, w, m_settings);
+    unsigned nnz_after = m_U.number_of_non_zeroes_in_column(m_U.adjust_column(column_to_replace));
+    if (nnz_after > nnz_before)
+        m_nnz_in_updates += nnz_after - nnz_before;
     return column_to_replace;
 }
 
@@ -882,6 +889,7 @@ void lu<T, X>::replace_column(T pivot_elem_for_checking, indexed_vector<T> & w,
     m_R.multiply_by_permutation_reverse_from_left(m_r_wave);
     if (row_eta != nullptr) {
         row_eta->conjugate_by_permutation(m_Q);
+        m_nnz_in_updates += row_eta->number_of_nonzeroes();
         push_matrix_to_tail(row_eta);
     }
     calculate_Lwave_Pwave_for_bump(replaced_column, lowest_row_of_the_bump);
@@ -59,6 +59,8 @@ public:
         m_row_vector.push_back(row_index, val);
     }
 
+    unsigned number_of_nonzeroes() const { return m_row_vector.size(); }
+
     void apply_from_right(vector<T> & w);
     void apply_from_right(indexed_vector<T> & w);
 
@@ -23,7 +23,9 @@
 namespace lean {
 template <typename T, typename X>
 class square_dense_submatrix : public tail_matrix<T, X> {
-    // the submatrix uses the permutations of the parent matrix to access the elements
+    // the submatrix uses the permutations of the parent matrix to access the elements;
+    // the rows and columns that the parent gets after the factorization, see lu::add_last_rows_to_B,
+    // are outside of the permutations and of [m_index_start, m_index_start + m_dim), and are the unit ones
     struct ref {
         unsigned m_i_offset;
         square_dense_submatrix & m_s;
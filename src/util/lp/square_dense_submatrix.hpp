@@ -233,9 +233,13 @@ void square_dense_submatrix<T, X>::apply_from_left_local(indexed_vector<L> & w,
     for (unsigned i = 0; i < m_index_start; i++) {
         t[adjust_row_inverse(i)] = w[adjust_column_inverse(i)];
     }
-    for (unsigned i = m_index_start; i < m_parent->dimension(); i++){
+    unsigned end = m_index_start + m_dim;
+    for (unsigned i = m_index_start; i < end; i++){
         t[adjust_row_inverse(i)] = row_by_indexed_vector_product(i, w);
     }
+    for (unsigned i = end; i < m_parent->dimension(); i++) {
+        t[i] = w[i];
+    }
     for (unsigned i = 0; i < m_parent->dimension(); i++) {
         w.set_value(t[i], i);
     }
@@ -271,9 +275,13 @@ void square_dense_submatrix<T, X>::apply_from_left_to_vector(vector<L> & w) {
     for (unsigned i = 0; i < m_index_start; i++) {
         t[adjust_row_inverse(i)] = w[adjust_column_inverse(i)];
     }
-    for (unsigned i = m_index_start; i < m_parent->dimension(); i++){
+    unsigned end = m_index_start + m_dim;
+    for (unsigned i = m_index_start; i < end; i++){
         t[adjust_row_inverse(i)] = row_by_vector_product(i, w);
     }
+    for (unsigned i = end; i < m_parent->dimension(); i++) { // the rows added to the parent after the factorization
+        t[i] = w[i];
+    }
     for (unsigned i = 0; i < m_parent->dimension(); i++) {
         w[i] = t[i];
     }
@@ -287,7 +295,7 @@ void square_dense_submatrix<T, X>::apply_from_left_to_vector(vector<L> & w) {
 template <typename T, typename X>    bool square_dense_submatrix<T, X>::is_L_matrix() const {
 #ifdef LEAN_DEBUG
     lean_assert(m_row_permutation.is_identity());
-    for (unsigned i = 0; i < m_parent->dimension(); i++) {
+    for (unsigned i = 0; i < m_index_start + m_dim; i++) {
         if (i < m_index_start) {
             lean_assert(m_column_permutation[i] == i);
             continue;